@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    NoteFieldsBenchmark.cpp
+    Times the typed Note field getters against reading the same properties
+    from the note's ValueTree, the way every getter worked before the
+    fields were cached.
+
+    Build with -DMODALITY_BENCHMARKS=ON and run NoteFieldsBenchmark.
+
+  ==============================================================================
+*/
+
+#include "Data/Note.h"
+#include <JuceHeader.h>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace
+{
+constexpr int numNotes = 10000;
+constexpr int numPasses = 200;
+
+// Nanoseconds per note for one pass of fn over every note, best of numPasses
+template <typename Function>
+double timePerNote (Function&& fn, double& checksum)
+{
+    double best = std::numeric_limits<double>::max();
+
+    for (int pass = 0; pass < numPasses; ++pass)
+    {
+        auto start = juce::Time::getHighResolutionTicks();
+        checksum += fn();
+        auto ticks = juce::Time::getHighResolutionTicks() - start;
+
+        best = juce::jmin (best, juce::Time::highResolutionTicksToSeconds (ticks));
+    }
+
+    return best * 1.0e9 / numNotes;
+}
+} // namespace
+
+int main()
+{
+    juce::ScopedJuceInitialiser_GUI juceInitialiser;
+
+    juce::ValueTree notesState ("Notes");
+    std::vector<std::unique_ptr<Note>> notes;
+    juce::Random random (1);
+
+    for (int i = 0; i < numNotes; ++i)
+    {
+        auto note = std::make_unique<Note> (random.nextInt (24), random.nextInt (64) * 0.25, 0.25);
+        notesState.addChild (note->getState(), -1, nullptr);
+        notes.push_back (std::move (note));
+    }
+
+    // Keeps the reads from being optimised away
+    double checksum = 0.0;
+
+    auto valueTreeReads = timePerNote ([&notes]
+                                       {
+                                           double sum = 0.0;
+                                           for (auto& n : notes)
+                                           {
+                                               const auto& state = n->getState();
+                                               sum += static_cast<double> (state.getProperty (NoteIDs::Degree))
+                                                      + static_cast<double> (state.getProperty (NoteIDs::StartTime))
+                                                      + static_cast<double> (state.getProperty (NoteIDs::Duration))
+                                                      + static_cast<int> (state.getProperty (NoteIDs::Velocity));
+                                           }
+                                           return sum;
+                                       },
+                                       checksum);
+
+    auto fieldReads = timePerNote ([&notes]
+                                   {
+                                       double sum = 0.0;
+                                       for (const auto& n : notes)
+                                           sum += n->getDegree() + n->getStartTime() + n->getDuration() + n->getVelocity();
+                                       return sum;
+                                   },
+                                   checksum);
+
+    auto valueTreeRange = timePerNote ([&notes]
+                                       {
+                                           double count = 0.0;
+                                           for (auto& n : notes)
+                                               count += Note::isWithinRange (n->getState(), 4.0, 8.0, 0.0, 12.0) ? 1.0 : 0.0;
+                                           return count;
+                                       },
+                                       checksum);
+
+    auto fieldRange = timePerNote ([&notes]
+                                   {
+                                       double count = 0.0;
+                                       for (const auto& n : notes)
+                                           count += n->isWithinRange (4.0, 8.0, 0.0, 12.0) ? 1.0 : 0.0;
+                                       return count;
+                                   },
+                                   checksum);
+
+    std::cout << "Notes: " << numNotes << ", best of " << numPasses << " passes\n"
+              << "Read degree/start/duration/velocity\n"
+              << "  ValueTree properties: " << valueTreeReads << " ns/note\n"
+              << "  Typed fields:         " << fieldReads << " ns/note (" << valueTreeReads / fieldReads << "x)\n"
+              << "Range test\n"
+              << "  ValueTree properties: " << valueTreeRange << " ns/note\n"
+              << "  Typed fields:         " << fieldRange << " ns/note (" << valueTreeRange / fieldRange << "x)\n"
+              << "(checksum " << checksum << ")\n";
+
+    return 0;
+}
@@ -10,6 +10,7 @@ static const juce::Colour visualBlockMode = juce::Colours::lightblue.withLightne
 static const juce::Colour visualBlockModeCursor = juce::Colours::darkcyan.withLightness (0.3f);
 static const juce::Colour visualLineMode = juce::Colours::orange.withLightness (0.7f);
 static const juce::Colour visualLineModeCursor = juce::Colours::orange;
+static const juce::Colour background = juce::Colour (255, 253, 240);
 static const juce::Colour playhead = juce::Colour (47, 128, 107);
 static const juce::Colour yankFlashFill = juce::Colour (255, 240, 80);
 static const juce::Colour yankFlashOutline = juce::Colour (255, 240, 80).darker (0.4f);
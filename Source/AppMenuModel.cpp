@@ -1,4 +1,6 @@
 #include "AppMenuModel.h"
+#include "Data/AppSettings.h"
+#include "Data/ScaleRegistry.h"
 
 AppMenuModel::AppMenuModel (Composition& c, juce::ApplicationCommandManager& cm)
     : composition (c), commandManager (cm)
@@ -21,6 +23,8 @@ juce::PopupMenu AppMenuModel::getMenuForIndex ([[maybe_unused]] int menuIndex,
     menu.addSeparator();
     menu.addCommandItem (&commandManager, FileSave);
     menu.addCommandItem (&commandManager, FileSaveAs);
+    menu.addSeparator();
+    menu.addCommandItem (&commandManager, FileImportScale);
     return menu;
 }
 
@@ -37,7 +41,7 @@ juce::ApplicationCommandTarget* AppMenuModel::getNextCommandTarget()
 
 void AppMenuModel::getAllCommands (juce::Array<juce::CommandID>& commands)
 {
-    commands.addArray ({ FileNew, FileOpen, FileSave, FileSaveAs });
+    commands.addArray ({ FileNew, FileOpen, FileSave, FileSaveAs, FileImportScale });
 }
 
 void AppMenuModel::getCommandInfo (juce::CommandID commandID, juce::ApplicationCommandInfo& result)
@@ -65,6 +69,10 @@ void AppMenuModel::getCommandInfo (juce::CommandID commandID, juce::ApplicationC
             result.addDefaultKeypress ('s', juce::ModifierKeys::commandModifier | juce::ModifierKeys::shiftModifier);
             break;
 
+        case FileImportScale:
+            result.setInfo ("Import Scale...", "Import a Scala (.scl) tuning as a scale", "File", 0);
+            break;
+
         default:
             break;
     }
@@ -86,6 +94,9 @@ bool AppMenuModel::perform (const juce::ApplicationCommandTarget::InvocationInfo
         case FileSaveAs:
             doSaveAs();
             return true;
+        case FileImportScale:
+            doImportScale();
+            return true;
         default:
             return false;
     }
@@ -178,3 +189,36 @@ void AppMenuModel::doSaveAs()
             }
         });
 }
+
+void AppMenuModel::doImportScale()
+{
+    fileChooser = std::make_unique<juce::FileChooser> (
+        "Import Scala Scale",
+        juce::File::getSpecialLocation (juce::File::userDocumentsDirectory),
+        "*.scl");
+
+    fileChooser->launchAsync (
+        juce::FileBrowserComponent::openMode | juce::FileBrowserComponent::canSelectFiles,
+        [] (const juce::FileChooser& fc)
+        {
+            auto file = fc.getResult();
+            if (file == juce::File {})
+                return;
+
+            if (! ScaleRegistry::getInstance().loadScalaFile (file))
+            {
+                juce::AlertWindow::showMessageBoxAsync (
+                    juce::MessageBoxIconType::WarningIcon,
+                    "Scale Not Imported: " + file.getFileName(),
+                    "The file is not a supported Scala scale.",
+                    "OK",
+                    nullptr);
+                return;
+            }
+
+            // Keep a copy so the scale is available next launch
+            auto scalesDirectory = AppSettings::getInstance().getUserScalesDirectory();
+            if (scalesDirectory.createDirectory().wasOk())
+                file.copyFileTo (scalesDirectory.getChildFile (file.getFileName()));
+        });
+}
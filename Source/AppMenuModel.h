@@ -12,7 +12,8 @@ public:
         FileNew = 1,
         FileOpen = 2,
         FileSave = 3,
-        FileSaveAs = 4
+        FileSaveAs = 4,
+        FileImportScale = 5
     };
 
     AppMenuModel (Composition& composition, juce::ApplicationCommandManager& commandManager);
@@ -43,6 +44,7 @@ private:
     void doOpen();
     void doSave();
     void doSaveAs();
+    void doImportScale();
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (AppMenuModel)
 };
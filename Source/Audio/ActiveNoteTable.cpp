@@ -0,0 +1,181 @@
+/*
+  ==============================================================================
+
+    ActiveNoteTable.cpp
+    Per-output, per-channel sounding note bookkeeping.
+
+  ==============================================================================
+*/
+
+#include "ActiveNoteTable.h"
+#include <bit>
+
+bool ActiveNoteTable::noteOn (juce::MidiOutput* output, int channel, int noteNumber)
+{
+    auto* notes = findOrAdd (output);
+
+    // Untracked (invalid, or more outputs than slots): pass through
+    if (notes == nullptr || ! isValid (channel, noteNumber))
+        return false;
+
+    auto ch = static_cast<size_t> (channel - 1);
+    auto key = static_cast<size_t> (noteNumber);
+    auto& word = notes->bits[ch][key >> 6];
+    auto mask = juce::uint64 { 1 } << (key & 63);
+
+    bool wasActive = (word & mask) != 0;
+
+    if (! wasActive)
+    {
+        word |= mask;
+        ++notes->numActive;
+    }
+
+    auto& depth = notes->depth[ch][key];
+    if (depth < 255)
+        ++depth;
+
+    return wasActive;
+}
+
+bool ActiveNoteTable::noteOff (juce::MidiOutput* output, int channel, int noteNumber)
+{
+    if (! isValid (channel, noteNumber))
+        return true;
+
+    auto* notes = find (output);
+
+    // Nothing was recorded for this output: drop the off, unless the table is
+    // full and the output is untracked
+    if (notes == nullptr)
+        return output != nullptr && ! hasFreeSlot();
+
+    auto ch = static_cast<size_t> (channel - 1);
+    auto key = static_cast<size_t> (noteNumber);
+    auto& word = notes->bits[ch][key >> 6];
+    auto mask = juce::uint64 { 1 } << (key & 63);
+
+    if ((word & mask) == 0)
+        return false;
+
+    auto& depth = notes->depth[ch][key];
+    if (depth > 1)
+    {
+        --depth;
+        return false;
+    }
+
+    depth = 0;
+    word &= ~mask;
+    --notes->numActive;
+    return true;
+}
+
+bool ActiveNoteTable::isActive (juce::MidiOutput* output, int channel, int noteNumber) const
+{
+    auto* notes = find (output);
+
+    if (notes == nullptr || ! isValid (channel, noteNumber))
+        return false;
+
+    auto key = static_cast<size_t> (noteNumber);
+    return (notes->bits[static_cast<size_t> (channel - 1)][key >> 6] & (juce::uint64 { 1 } << (key & 63))) != 0;
+}
+
+void ActiveNoteTable::releaseAll (MidiOutputBatcher& batcher)
+{
+    for (auto& notes : outputs)
+    {
+        if (notes.numActive == 0)
+            continue;
+
+        for (size_t ch = 0; ch < notes.bits.size(); ++ch)
+            release (notes, ch, batcher);
+    }
+}
+
+void ActiveNoteTable::releaseChannel (juce::MidiOutput* output, int channel, MidiOutputBatcher& batcher)
+{
+    auto* notes = find (output);
+
+    if (notes != nullptr && channel >= 1 && channel <= 16)
+        release (*notes, static_cast<size_t> (channel - 1), batcher);
+}
+
+int ActiveNoteTable::getNumActiveNotes() const
+{
+    int total = 0;
+
+    for (const auto& notes : outputs)
+        total += notes.numActive;
+
+    return total;
+}
+
+void ActiveNoteTable::release (OutputNotes& notes, size_t channelIndex, MidiOutputBatcher& batcher)
+{
+    for (size_t w = 0; w < 2; ++w)
+    {
+        auto& word = notes.bits[channelIndex][w];
+
+        while (word != 0)
+        {
+            auto key = w * 64 + static_cast<size_t> (std::countr_zero (word));
+            word &= word - 1;
+
+            notes.depth[channelIndex][key] = 0;
+            --notes.numActive;
+            batcher.add (notes.output, juce::MidiMessage::noteOff (static_cast<int> (channelIndex) + 1, static_cast<int> (key)));
+        }
+    }
+}
+
+ActiveNoteTable::OutputNotes* ActiveNoteTable::find (juce::MidiOutput* output)
+{
+    for (auto& notes : outputs)
+        if (notes.output == output)
+            return &notes;
+
+    return nullptr;
+}
+
+const ActiveNoteTable::OutputNotes* ActiveNoteTable::find (juce::MidiOutput* output) const
+{
+    for (const auto& notes : outputs)
+        if (notes.output == output)
+            return &notes;
+
+    return nullptr;
+}
+
+ActiveNoteTable::OutputNotes* ActiveNoteTable::findOrAdd (juce::MidiOutput* output)
+{
+    if (output == nullptr)
+        return nullptr;
+
+    if (auto* notes = find (output))
+        return notes;
+
+    // Reuse a slot with nothing sounding; bitmaps and depths are already clear
+    for (auto& notes : outputs)
+    {
+        if (notes.numActive == 0)
+        {
+            notes.output = output;
+            return &notes;
+        }
+    }
+
+    return nullptr;
+}
+
+bool ActiveNoteTable::hasFreeSlot() const
+{
+    return std::any_of (outputs.begin(), outputs.end(), [] (const OutputNotes& notes)
+                        { return notes.numActive == 0; });
+}
+
+bool ActiveNoteTable::isValid (int channel, int noteNumber)
+{
+    return channel >= 1 && channel <= 16 && noteNumber >= 0 && noteNumber < 128;
+}
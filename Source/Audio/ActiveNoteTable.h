@@ -0,0 +1,102 @@
+/*
+  ==============================================================================
+
+    ActiveNoteTable.h
+    Which notes are sounding on each output and channel, kept on the audio
+    thread so every note-on can be matched by a precise note-off.
+
+    Design:
+    - A 128-bit bitmap per output and channel marks sounding keys; releasing
+      scans only set bits
+    - A per-key depth counts overlapping notes of the same pitch: a retrigger
+      ends the sounding note before restarting it, and only the last
+      overlapping note-off is sent, so an earlier note's off can't cut the
+      newer one short
+    - Note-offs for keys that aren't sounding are dropped, so offs left in
+      the schedule after a release don't reach the synth
+    - Fixed storage, no allocation or locking
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Audio/MidiOutputBatcher.h"
+#include <JuceHeader.h>
+#include <array>
+#include <bit>
+
+class ActiveNoteTable
+{
+public:
+    static constexpr size_t maxOutputs = MidiOutputBatcher::maxOutputs;
+
+    /**
+     * Record a note-on.
+     *
+     * @return true if the key was already sounding (a retrigger)
+     */
+    bool noteOn (juce::MidiOutput* output, int channel, int noteNumber);
+
+    /**
+     * Record a note-off.
+     *
+     * @return true if the off should be sent: the key was sounding and this
+     *         ends its last overlapping note
+     */
+    bool noteOff (juce::MidiOutput* output, int channel, int noteNumber);
+
+    bool isActive (juce::MidiOutput* output, int channel, int noteNumber) const;
+
+    /**
+     * Call fn (noteNumber) for each key sounding on one output and channel.
+     */
+    template <typename Function>
+    void forEachActive (juce::MidiOutput* output, int channel, Function&& fn) const
+    {
+        auto* notes = find (output);
+
+        if (notes == nullptr || channel < 1 || channel > 16)
+            return;
+
+        for (size_t w = 0; w < 2; ++w)
+        {
+            for (auto word = notes->bits[static_cast<size_t> (channel - 1)][w]; word != 0; word &= word - 1)
+                fn (static_cast<int> (w * 64 + static_cast<size_t> (std::countr_zero (word))));
+        }
+    }
+
+    /**
+     * Queue note-offs for every sounding note and forget them.
+     */
+    void releaseAll (MidiOutputBatcher& batcher);
+
+    /**
+     * Queue note-offs for the sounding notes on one output and channel.
+     */
+    void releaseChannel (juce::MidiOutput* output, int channel, MidiOutputBatcher& batcher);
+
+    int getNumActiveNotes() const;
+
+private:
+    struct OutputNotes
+    {
+        juce::MidiOutput* output = nullptr;
+        int numActive = 0;
+        std::array<std::array<juce::uint64, 2>, 16> bits {};
+        std::array<std::array<juce::uint8, 128>, 16> depth {};
+    };
+
+    OutputNotes* find (juce::MidiOutput* output);
+    const OutputNotes* find (juce::MidiOutput* output) const;
+    OutputNotes* findOrAdd (juce::MidiOutput* output);
+
+    // Whether findOrAdd could give a new output a slot
+    bool hasFreeSlot() const;
+
+    void release (OutputNotes& notes, size_t channelIndex, MidiOutputBatcher& batcher);
+
+    static bool isValid (int channel, int noteNumber);
+
+    std::array<OutputNotes, maxOutputs> outputs;
+};
@@ -0,0 +1,90 @@
+/*
+  ==============================================================================
+
+    AutomationPlan.h
+    A track's automation lanes, compiled for the audio thread.
+
+    Design:
+    - Built on the UI thread whenever a lane or the track's routing changes,
+      then handed to the engine as an immutable object, one per track
+    - Points are flat arrays the audio thread reads without locking; the
+      engine samples them once per block, at most at the control rate, and
+      sends only values that changed
+    - The owner keeps a plan alive until the engine has let go of it (see
+      AutomationPlanQueue), as with PlaybackPlan
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Data/AutomationLane.h"
+#include <JuceHeader.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+struct AutomationPlan
+{
+    static constexpr size_t maxLanes = static_cast<size_t> (AutomationLane::maxLanesPerSequence);
+
+    struct Lane
+    {
+        Automation::Target target = Automation::Target::controller;
+        Automation::Mode mode = Automation::Mode::linear;
+        int controller = 1;
+        std::vector<Automation::Point> points;
+    };
+
+    juce::MidiOutput* output = nullptr;
+    int midiChannel = 1;
+    bool mpe = false;             // Channel-wide lanes go to the MPE master channel
+    double loopLengthBeats = 4.0; // Lanes repeat with the sequence's loop
+    std::vector<Lane> lanes;      // At most maxLanes; extra lanes are ignored
+};
+
+/**
+ * Owns the automation plans handed to the engine (UI thread only). A plan
+ * is freed only after it has gone unused for a few frames, so the audio
+ * thread can never be reading it.
+ */
+class AutomationPlanQueue
+{
+public:
+    static constexpr int framesBeforeFree = 4;
+
+    AutomationPlan* create (AutomationPlan plan)
+    {
+        plans.push_back ({ std::make_unique<AutomationPlan> (std::move (plan)), 0 });
+        return plans.back().plan.get();
+    }
+
+    /**
+     * Free plans that no track is using. Call once per frame.
+     *
+     * @param isInUse Called with each plan; true while the engine holds it
+     */
+    template <typename Predicate>
+    void collectGarbage (Predicate&& isInUse)
+    {
+        for (auto& entry : plans)
+        {
+            if (isInUse (entry.plan.get()))
+                entry.idleFrames = 0;
+            else
+                ++entry.idleFrames;
+        }
+
+        std::erase_if (plans, [] (const Entry& entry)
+                       { return entry.idleFrames > framesBeforeFree; });
+    }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<AutomationPlan> plan;
+        int idleFrames = 0;
+    };
+
+    std::deque<Entry> plans;
+};
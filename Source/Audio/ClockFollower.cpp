@@ -0,0 +1,147 @@
+/*
+  ==============================================================================
+
+    ClockFollower.cpp
+    Follows an external MIDI clock with a phase-locked loop.
+
+  ==============================================================================
+*/
+
+#include "ClockFollower.h"
+#include "Audio/Transport.h"
+
+ClockFollower::ClockFollower()
+{
+    publish (0.0);
+}
+
+void ClockFollower::handleMessage (const juce::MidiMessage& message, double timeMs)
+{
+    if (message.isMidiClock())
+    {
+        handleTick (timeMs);
+    }
+    else if (message.isMidiStart())
+    {
+        // The first tick after Start is beat zero
+        tickIndex = 0;
+        running = true;
+        publish (getNextTickTime (timeMs));
+    }
+    else if (message.isMidiContinue())
+    {
+        running = true;
+        publish (getNextTickTime (timeMs));
+    }
+    else if (message.isMidiStop())
+    {
+        running = false;
+        publish (getNextTickTime (timeMs));
+    }
+    else if (message.isSongPositionPointer())
+    {
+        tickIndex = static_cast<juce::int64> (message.getSongPositionPointerMidiBeat()) * (ticksPerBeat / 4);
+        publish (getNextTickTime (timeMs));
+    }
+}
+
+void ClockFollower::handleTick (double timeMs)
+{
+    if (! hasTicked || std::abs (timeMs - predictedMs) > relockPeriods * periodMs)
+    {
+        // First tick, or the clock jumped: take this tick as the phase
+        hasTicked = true;
+        phaseMs = timeMs;
+        ticksSinceLock = 0;
+    }
+    else
+    {
+        double error = timeMs - predictedMs;
+
+        phaseMs = predictedMs + phaseGain * error;
+
+        // Keep the period within the tempo range the transport accepts
+        double minPeriod = 60000.0 / (Transport::MAX_TEMPO * ticksPerBeat);
+        double maxPeriod = 60000.0 / (Transport::MIN_TEMPO * ticksPerBeat);
+        periodMs = juce::jlimit (minPeriod, maxPeriod, periodMs + periodGain * error);
+
+        meanError += statisticsWeight * (error - meanError);
+        meanSquaredError += statisticsWeight * (error * error - meanSquaredError);
+        ++ticksSinceLock;
+    }
+
+    predictedMs = phaseMs + periodMs;
+
+    if (running)
+    {
+        publish (phaseMs);
+        ++tickIndex;
+    }
+
+    lastTickMs.store (timeMs, std::memory_order_relaxed);
+    statTempo.store (60000.0 / (periodMs * ticksPerBeat), std::memory_order_relaxed);
+    statJitterMs.store (std::sqrt (juce::jmax (0.0, meanSquaredError - meanError * meanError)), std::memory_order_relaxed);
+    statDriftMs.store (meanError, std::memory_order_relaxed);
+    statTicks.fetch_add (1, std::memory_order_relaxed);
+    statLocked.store (ticksSinceLock >= ticksToLock, std::memory_order_relaxed);
+}
+
+double ClockFollower::getNextTickTime (double timeMs) const
+{
+    // The next tick lands on tickIndex; without a clock yet, assume it is now
+    return hasTicked ? juce::jmax (predictedMs, timeMs) : timeMs;
+}
+
+void ClockFollower::publish (double tickTimeMs)
+{
+    Timebase t;
+    t.tempo = 60000.0 / (periodMs * ticksPerBeat);
+    t.hostTimeMs = tickTimeMs;
+    t.positionSeconds = (static_cast<double> (tickIndex) / ticksPerBeat) * 60.0 / t.tempo;
+    t.playing = running;
+    timebase.publish (t);
+}
+
+const SeqLockedTimebase& ClockFollower::getTimebase() const
+{
+    return timebase;
+}
+
+bool ClockFollower::isReceivingClock (double nowMs) const
+{
+    auto last = lastTickMs.load (std::memory_order_relaxed);
+    return last > 0.0 && nowMs - last < dropoutPeriods * 60000.0 / (statTempo.load (std::memory_order_relaxed) * ticksPerBeat);
+}
+
+ClockFollower::Statistics ClockFollower::getStatistics() const
+{
+    Statistics s;
+    s.tempo = statTempo.load (std::memory_order_relaxed);
+    s.jitterMs = statJitterMs.load (std::memory_order_relaxed);
+    s.driftMs = statDriftMs.load (std::memory_order_relaxed);
+    s.ticksReceived = statTicks.load (std::memory_order_relaxed);
+    s.locked = statLocked.load (std::memory_order_relaxed);
+    return s;
+}
+
+void ClockFollower::reset()
+{
+    running = false;
+    hasTicked = false;
+    tickIndex = 0;
+    phaseMs = 0.0;
+    periodMs = 60000.0 / (initialTempo * ticksPerBeat);
+    predictedMs = 0.0;
+    meanError = 0.0;
+    meanSquaredError = 0.0;
+    ticksSinceLock = 0;
+
+    lastTickMs = 0.0;
+    statTempo = initialTempo;
+    statJitterMs = 0.0;
+    statDriftMs = 0.0;
+    statTicks = 0;
+    statLocked = false;
+
+    publish (0.0);
+}
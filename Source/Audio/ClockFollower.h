@@ -0,0 +1,117 @@
+/*
+  ==============================================================================
+
+    ClockFollower.h
+    Follows an external MIDI clock (24 PPQN) with Start/Stop/Continue and
+    Song Position Pointer.
+
+    Design:
+    - Incoming ticks drive a second order phase-locked loop: each tick's
+      arrival time is compared with the predicted one, and the error nudges
+      both the phase and the tick period (an alpha-beta filter, the steady
+      state form of a constant-velocity Kalman filter)
+    - The smoothed phase, tempo and beat position are published through a
+      SeqLockedTimebase, so the audio thread can follow them lock-free
+    - Jitter (spread of the tick error) and drift (its mean) are kept as
+      exponentially weighted statistics
+    - handleMessage() takes explicit timestamps, so a synthetic clock stream
+      can be fed in without a device
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Audio/Timebase.h"
+#include <JuceHeader.h>
+#include <atomic>
+
+class ClockFollower
+{
+public:
+    static constexpr int ticksPerBeat = 24;
+    static constexpr double initialTempo = 120.0;
+
+    // Loop gains applied per tick to the timing error
+    static constexpr double phaseGain = 0.2;
+    static constexpr double periodGain = 0.02;
+
+    // Weight of each tick in the jitter and drift statistics
+    static constexpr double statisticsWeight = 0.01;
+
+    // Ticks needed before the tempo estimate is trusted
+    static constexpr int ticksToLock = 48;
+
+    // Missing this many tick periods means the clock has gone away
+    static constexpr double dropoutPeriods = 8.0;
+
+    // A tick this many periods off the prediction restarts the loop
+    static constexpr double relockPeriods = 4.0;
+
+    struct Statistics
+    {
+        double tempo = initialTempo;
+        double jitterMs = 0.0;
+        double driftMs = 0.0;
+        juce::int64 ticksReceived = 0;
+        bool locked = false;
+    };
+
+    ClockFollower();
+
+    /**
+     * Process a clock, start, stop, continue or song position message.
+     * Call from a single thread (the MIDI input thread, or a test).
+     *
+     * @param timeMs Arrival time on the Time::getMillisecondCounterHiRes() clock
+     */
+    void handleMessage (const juce::MidiMessage& message, double timeMs);
+
+    /**
+     * The followed position and tempo. playing is true between Start (or
+     * Continue) and Stop.
+     */
+    const SeqLockedTimebase& getTimebase() const;
+
+    /**
+     * True if a tick arrived recently enough to trust the timebase.
+     */
+    bool isReceivingClock (double nowMs) const;
+
+    Statistics getStatistics() const;
+
+    /**
+     * Forget all state. Call only while no messages are being handled.
+     */
+    void reset();
+
+private:
+    void handleTick (double timeMs);
+    double getNextTickTime (double timeMs) const;
+
+    // Publish the position of tickIndex as reached at tickTimeMs
+    void publish (double tickTimeMs);
+
+    // Input thread state
+    bool running = false;
+    bool hasTicked = false;
+    juce::int64 tickIndex = 0;   // beat position in ticks of the next tick
+    double phaseMs = 0.0;        // smoothed time of the latest tick
+    double periodMs = 60000.0 / (initialTempo * ticksPerBeat);
+    double predictedMs = 0.0;
+    double meanError = 0.0;
+    double meanSquaredError = 0.0;
+    int ticksSinceLock = 0;
+
+    SeqLockedTimebase timebase;
+
+    // Statistics for other threads
+    std::atomic<double> lastTickMs { 0.0 };
+    std::atomic<double> statTempo { initialTempo };
+    std::atomic<double> statJitterMs { 0.0 };
+    std::atomic<double> statDriftMs { 0.0 };
+    std::atomic<juce::int64> statTicks { 0 };
+    std::atomic<bool> statLocked { false };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ClockFollower)
+};
@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    MidiClockGenerator.cpp
+    MIDI beat clock (24 PPQN), Start/Stop/Continue and Song Position Pointer.
+
+  ==============================================================================
+*/
+
+#include "MidiClockGenerator.h"
+
+MidiClockGenerator::MidiClockGenerator (const SeqLockedTimebase& tb)
+    : juce::Thread ("MIDI Clock"), timebase (tb)
+{
+}
+
+MidiClockGenerator::~MidiClockGenerator()
+{
+    stopThread (500);
+}
+
+void MidiClockGenerator::setOutputs (const juce::Array<juce::MidiOutput*>& outputs)
+{
+    if (outputs.isEmpty())
+        stopThread (500);
+
+    int version = 0;
+
+    {
+        const juce::SpinLock::ScopedLockType sl (outputLock);
+        pendingOutputs = outputs;
+        version = ++outputsVersion;
+    }
+
+    if (! isThreadRunning())
+    {
+        if (! outputs.isEmpty())
+            startThread (juce::Thread::Priority::highest);
+
+        return;
+    }
+
+    // The thread may still be sending to the old outputs until it takes the new list
+    notify();
+
+    while (isThreadRunning() && appliedOutputsVersion.load() < version)
+        outputsApplied.wait (static_cast<int> (maxSleepMs));
+}
+
+bool MidiClockGenerator::isRunning() const
+{
+    return isThreadRunning();
+}
+
+void MidiClockGenerator::updateOutputs()
+{
+    {
+        const juce::SpinLock::ScopedLockType sl (outputLock);
+
+        if (outputsVersion == clockOutputsVersion)
+            return;
+
+        clockOutputs = pendingOutputs;
+        clockOutputsVersion = outputsVersion;
+    }
+
+    appliedOutputsVersion.store (clockOutputsVersion);
+    outputsApplied.signal();
+}
+
+void MidiClockGenerator::send (const juce::MidiMessage& message)
+{
+    for (auto* output : clockOutputs)
+    {
+        if (output != nullptr)
+            output->sendMessageNow (message);
+    }
+}
+
+void MidiClockGenerator::sendSongPosition (double beat)
+{
+    // Song position is counted in sixteenths ("MIDI beats"), 14 bits
+    auto sixteenths = juce::jlimit (0, 16383, static_cast<int> (std::floor (beat * 4.0)));
+    send (juce::MidiMessage::songPositionPointer (sixteenths));
+}
+
+void MidiClockGenerator::run()
+{
+    bool wasPlaying = false;
+    Timebase anchor;
+    juce::int64 nextTick = 0;
+
+    // Clock from the first sixteenth still ahead of the transport: its first
+    // tick is sent when the transport reaches it, so followers never see a
+    // burst of clocks catching up with a boundary already passed
+    auto getNextSixteenth = [] (double beat)
+    { return static_cast<juce::int64> (std::ceil (beat * 4.0)); };
+
+    auto startAtSixteenth = [&] (const Timebase& current, juce::int64 sixteenth)
+    {
+        anchor = current;
+        anchor.positionSeconds = sixteenth * 0.25 * 60.0 / current.tempo;
+        anchor.hostTimeMs = current.getTimeOfBeat (sixteenth * 0.25);
+        nextTick = sixteenth * ticksPerSixteenth;
+    };
+
+    while (! threadShouldExit())
+    {
+        updateOutputs();
+
+        auto current = timebase.read();
+
+        if (! current.playing)
+        {
+            if (wasPlaying)
+            {
+                send (juce::MidiMessage::midiStop());
+                wasPlaying = false;
+            }
+
+            wait (static_cast<int> (maxSleepMs));
+            continue;
+        }
+
+        double beat = current.getBeat();
+
+        if (! wasPlaying)
+        {
+            auto sixteenth = getNextSixteenth (beat);
+            sendSongPosition (sixteenth * 0.25);
+            send (sixteenth == 0 ? juce::MidiMessage::midiStart() : juce::MidiMessage::midiContinue());
+
+            startAtSixteenth (current, sixteenth);
+            wasPlaying = true;
+        }
+        else
+        {
+            double predictedBeat = anchor.getBeatAt (current.hostTimeMs);
+            double errorBeats = beat - predictedBeat;
+
+            if (std::abs (errorBeats) > seekThresholdBeats)
+            {
+                // The transport jumped: followers only relocate while
+                // stopped, so stop them, move them and continue from there
+                auto sixteenth = getNextSixteenth (beat);
+                send (juce::MidiMessage::midiStop());
+                sendSongPosition (sixteenth * 0.25);
+                send (juce::MidiMessage::midiContinue());
+
+                startAtSixteenth (current, sixteenth);
+            }
+            else if (! juce::exactlyEqual (current.tempo, anchor.tempo)
+                     || std::abs (errorBeats) * 60000.0 / current.tempo > resyncThresholdMs)
+            {
+                anchor = current;
+            }
+        }
+
+        double tickTimeMs = anchor.getTimeOfBeat (static_cast<double> (nextTick) / ticksPerBeat);
+        double remainingMs = tickTimeMs - juce::Time::getMillisecondCounterHiRes();
+
+        if (remainingMs > spinWindowMs)
+        {
+            // Sleep most of the way, waking in time to see tempo or play state changes
+            wait (juce::jmax (1, static_cast<int> (juce::jmin (maxSleepMs, remainingMs - spinWindowMs))));
+            continue;
+        }
+
+        while (juce::Time::getMillisecondCounterHiRes() < tickTimeMs && ! threadShouldExit())
+            juce::Thread::yield();
+
+        send (juce::MidiMessage::midiClock());
+        ++nextTick;
+    }
+
+    if (wasPlaying)
+        send (juce::MidiMessage::midiStop());
+}
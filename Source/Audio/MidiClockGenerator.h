@@ -0,0 +1,83 @@
+/*
+  ==============================================================================
+
+    MidiClockGenerator.h
+    MIDI beat clock (24 PPQN), Start/Stop/Continue and Song Position Pointer.
+
+    Design:
+    - Runs on its own high priority thread, not the audio or UI thread
+    - Tick times are computed from the transport timebase (position, tempo
+      and the host time they were sampled at), so a tick goes out when the
+      transport reaches it rather than at the next audio block or UI frame
+    - The thread sleeps until shortly before each tick, then spins for the
+      last stretch to keep jitter below a millisecond
+    - The anchor used for extrapolation is only moved when the tempo changes
+      or the transport drifts from it, so audio callback jitter does not leak
+      into the tick spacing
+    - The clock thread sends to its own copy of the outputs, so no lock is
+      held while a message goes out; setOutputs waits until the thread has
+      taken the new list before the old pointers may go away
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Audio/Timebase.h"
+#include <JuceHeader.h>
+#include <atomic>
+
+class MidiClockGenerator : private juce::Thread
+{
+public:
+    static constexpr int ticksPerBeat = 24;
+    static constexpr int ticksPerSixteenth = ticksPerBeat / 4;
+
+    // Longest sleep between timebase checks, and the spin window before a tick
+    static constexpr double maxSleepMs = 5.0;
+    static constexpr double spinWindowMs = 1.5;
+
+    // Re-anchor when extrapolation and the transport disagree by more than this
+    static constexpr double resyncThresholdMs = 2.0;
+
+    // A position jump larger than this is a seek: re-send the song position
+    static constexpr double seekThresholdBeats = 0.25;
+
+    explicit MidiClockGenerator (const SeqLockedTimebase& timebase);
+    ~MidiClockGenerator() override;
+
+    /**
+     * Set the outputs clock is sent to. Starts the thread when there are
+     * any and stops it (after sending Stop) when there are none.
+     * Call from the message thread; the pointers must stay valid until
+     * replaced. Returns once the clock thread no longer uses the old ones.
+     */
+    void setOutputs (const juce::Array<juce::MidiOutput*>& outputs);
+
+    bool isRunning() const;
+
+private:
+    void run() override;
+
+    void send (const juce::MidiMessage& message);
+    void sendSongPosition (double beat);
+
+    // Take the list from the last setOutputs, if it changed (clock thread)
+    void updateOutputs();
+
+    const SeqLockedTimebase& timebase;
+
+    // Written by setOutputs, copied by the clock thread
+    juce::SpinLock outputLock;
+    juce::Array<juce::MidiOutput*> pendingOutputs;
+    int outputsVersion = 0;
+
+    // What the clock thread sends to; only it touches these while it runs
+    juce::Array<juce::MidiOutput*> clockOutputs;
+    int clockOutputsVersion = 0;
+
+    std::atomic<int> appliedOutputsVersion { 0 };
+    juce::WaitableEvent outputsApplied;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiClockGenerator)
+};
@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+    MidiInputManager.cpp
+    Captures incoming MIDI notes for live recording.
+
+  ==============================================================================
+*/
+
+#include "MidiInputManager.h"
+
+MidiInputManager::MidiInputManager()
+{
+    refreshDevices();
+}
+
+MidiInputManager::~MidiInputManager()
+{
+    closeDevice();
+}
+
+void MidiInputManager::refreshDevices()
+{
+    availableDevices = juce::MidiInput::getAvailableDevices();
+}
+
+juce::Array<juce::MidiDeviceInfo> MidiInputManager::getAvailableDevices() const
+{
+    return availableDevices;
+}
+
+bool MidiInputManager::openDevice (const juce::String& deviceId)
+{
+    closeDevice();
+    refreshDevices();
+
+    juce::String identifier = deviceId;
+
+    if (identifier.isEmpty())
+    {
+        if (availableDevices.isEmpty())
+            return false;
+
+        identifier = availableDevices.getFirst().identifier;
+    }
+
+    if (identifier == virtualDeviceId)
+        input = juce::MidiInput::createNewDevice (ProjectInfo::projectName, this);
+    else
+        input = juce::MidiInput::openDevice (identifier, this);
+
+    if (input == nullptr)
+    {
+        juce::Logger::writeToLog ("Failed to open MIDI input: " + identifier);
+        return false;
+    }
+
+    droppedEvents = 0;
+    input->start();
+    juce::Logger::writeToLog ("Opened MIDI input: " + input->getName());
+    return true;
+}
+
+void MidiInputManager::closeDevice()
+{
+    if (input != nullptr)
+    {
+        input->stop();
+        input.reset();
+    }
+
+    clearPendingEvents();
+}
+
+bool MidiInputManager::isOpen() const
+{
+    return input != nullptr;
+}
+
+juce::String MidiInputManager::getOpenDeviceId() const
+{
+    return input != nullptr ? input->getIdentifier() : juce::String();
+}
+
+void MidiInputManager::setClockFollower (ClockFollower* follower)
+{
+    clockFollower.store (follower);
+
+    // A callback that loaded the old follower may still be running
+    while (clockCallbacksActive.load() > 0)
+        juce::Thread::yield();
+}
+
+double MidiInputManager::getCurrentTimestamp()
+{
+    return juce::Time::getMillisecondCounterHiRes() * 0.001;
+}
+
+void MidiInputManager::handleIncomingMidiMessage ([[maybe_unused]] juce::MidiInput* source, const juce::MidiMessage& message)
+{
+    if (message.isMidiClock() || message.isMidiStart() || message.isMidiStop()
+        || message.isMidiContinue() || message.isSongPositionPointer())
+    {
+        ++clockCallbacksActive;
+
+        if (auto* follower = clockFollower.load())
+            follower->handleMessage (message, message.getTimeStamp() > 0.0 ? message.getTimeStamp() * 1000.0 : juce::Time::getMillisecondCounterHiRes());
+
+        --clockCallbacksActive;
+        return;
+    }
+
+    // MIDI thread: stamp and queue, nothing else
+    if (! message.isNoteOnOrOff())
+        return;
+
+    InputEvent event;
+    event.timestamp = message.getTimeStamp() > 0.0 ? message.getTimeStamp() : getCurrentTimestamp();
+    event.noteNumber = message.getNoteNumber();
+    event.velocity = message.getVelocity();
+    event.channel = message.getChannel();
+    event.isNoteOn = message.isNoteOn();
+
+    const auto scope = fifo.write (1);
+
+    if (scope.blockSize1 > 0)
+        events[(size_t) scope.startIndex1] = event;
+    else
+        droppedEvents.fetch_add (1, std::memory_order_relaxed);
+}
+
+int MidiInputManager::popEvents (std::vector<InputEvent>& dest)
+{
+    const auto scope = fifo.read (fifo.getNumReady());
+
+    for (int i = 0; i < scope.blockSize1; ++i)
+        dest.push_back (events[(size_t) (scope.startIndex1 + i)]);
+
+    for (int i = 0; i < scope.blockSize2; ++i)
+        dest.push_back (events[(size_t) (scope.startIndex2 + i)]);
+
+    return scope.blockSize1 + scope.blockSize2;
+}
+
+void MidiInputManager::clearPendingEvents()
+{
+    fifo.read (fifo.getNumReady());
+}
+
+int MidiInputManager::getNumDroppedEvents() const
+{
+    return droppedEvents.load (std::memory_order_relaxed);
+}
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    MidiInputManager.h
+    Captures incoming MIDI notes for live recording.
+
+    Design:
+    - The MIDI callback only timestamps note events and pushes them into a
+      lock-free single producer / single consumer FIFO: no locks and no
+      allocation on the MIDI thread
+    - The message thread drains the FIFO once per frame and turns the events
+      into notes, so recording never blocks the device callback
+    - Timestamps are the device's, in seconds on the
+      Time::getMillisecondCounterHiRes() clock, so an event is placed where it
+      was played rather than where it was drained
+    - Clock, Start/Stop/Continue and Song Position messages go straight to
+      the clock follower on the MIDI thread; it is lock-free and needs the
+      arrival time, not a frame-late drain
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Audio/ClockFollower.h"
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+
+class MidiInputManager : private juce::MidiInputCallback
+{
+public:
+    struct InputEvent
+    {
+        double timestamp = 0.0; // seconds, see getCurrentTimestamp()
+        int noteNumber = 0;
+        int velocity = 0;
+        int channel = 1;
+        bool isNoteOn = false;
+    };
+
+    static constexpr int fifoCapacity = 1024;
+
+    // Device id of the input port this app creates for other software
+    static inline const juce::String virtualDeviceId { "virtual" };
+
+    MidiInputManager();
+    ~MidiInputManager() override;
+
+    juce::Array<juce::MidiDeviceInfo> getAvailableDevices() const;
+
+    void refreshDevices();
+
+    /**
+     * Open an input device, closing any open one.
+     *
+     * @param deviceId Device identifier, virtualDeviceId for a new virtual
+     *                 port, or empty for the first available input
+     * @return true if a device was opened
+     */
+    bool openDevice (const juce::String& deviceId);
+
+    void closeDevice();
+
+    bool isOpen() const;
+
+    juce::String getOpenDeviceId() const;
+
+    /**
+     * Move every pending event into dest (message thread only).
+     * Reserve fifoCapacity in dest to keep this allocation free.
+     *
+     * @return The number of events appended
+     */
+    int popEvents (std::vector<InputEvent>& dest);
+
+    /**
+     * Discard pending events (message thread only).
+     */
+    void clearPendingEvents();
+
+    /**
+     * Events lost because the FIFO was full since the device was opened.
+     */
+    int getNumDroppedEvents() const;
+
+    /**
+     * The current time on the clock used for event timestamps.
+     */
+    static double getCurrentTimestamp();
+
+    /**
+     * Forward clock and song position messages to a follower, or stop
+     * forwarding with nullptr. Returns once the previous follower is no
+     * longer in a callback on the MIDI thread, so it can then be reset or
+     * destroyed.
+     */
+    void setClockFollower (ClockFollower* follower);
+
+private:
+    void handleIncomingMidiMessage (juce::MidiInput* source, const juce::MidiMessage& message) override;
+
+    std::unique_ptr<juce::MidiInput> input;
+
+    juce::Array<juce::MidiDeviceInfo> availableDevices;
+
+    juce::AbstractFifo fifo { fifoCapacity };
+    std::array<InputEvent, fifoCapacity> events;
+    std::atomic<int> droppedEvents { 0 };
+
+    std::atomic<ClockFollower*> clockFollower { nullptr };
+    std::atomic<int> clockCallbacksActive { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiInputManager)
+};
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+    MidiOutputBatcher.cpp
+    Per-output MIDI batching for the audio thread.
+
+  ==============================================================================
+*/
+
+#include "MidiOutputBatcher.h"
+
+MidiOutputBatcher::MidiOutputBatcher()
+{
+    for (auto& slot : slots)
+        slot.buffer.ensureSize (static_cast<size_t> (bufferBytes));
+}
+
+bool MidiOutputBatcher::add (juce::MidiOutput* output, const juce::MidiMessage& message)
+{
+    if (output == nullptr)
+        return false;
+
+    auto* slot = findSlot (output);
+
+    // More outputs in one block than slots: send this one directly
+    if (slot == nullptr)
+    {
+        output->sendMessageNow (message);
+        messagesSent.fetch_add (1, std::memory_order_relaxed);
+        sendCalls.fetch_add (1, std::memory_order_relaxed);
+        return true;
+    }
+
+    if (message.isController() && message.getControllerNumber() >= 120)
+    {
+        auto bit = static_cast<size_t> ((message.getChannel() - 1) * numModeControllers + message.getControllerNumber() - 120);
+
+        if (slot->modeMessagesSent.test (bit))
+            return false;
+
+        slot->modeMessagesSent.set (bit);
+    }
+
+    // Keep within the preallocated buffer
+    int size = message.getRawDataSize();
+    if (slot->numBytes + size + messageOverheadBytes > bufferBytes)
+        sendSlot (*slot);
+
+    slot->numBytes += size + messageOverheadBytes;
+    ++slot->numEvents;
+
+    // Every event shares sample position 0: the buffer keeps insertion order
+    if (message.isNoteOff (false) && useRunningStatus.load (std::memory_order_relaxed))
+        slot->buffer.addEvent (juce::MidiMessage::noteOn (message.getChannel(), message.getNoteNumber(), static_cast<juce::uint8> (0)), 0);
+    else
+        slot->buffer.addEvent (message, 0);
+
+    return true;
+}
+
+void MidiOutputBatcher::flush()
+{
+    for (size_t i = 0; i < numSlotsInUse; ++i)
+    {
+        sendSlot (slots[i]);
+        slots[i].modeMessagesSent.reset();
+        slots[i].output = nullptr;
+    }
+
+    numSlotsInUse = 0;
+}
+
+void MidiOutputBatcher::setUseRunningStatus (bool shouldUse)
+{
+    useRunningStatus.store (shouldUse);
+}
+
+juce::int64 MidiOutputBatcher::getNumMessagesSent() const
+{
+    return messagesSent.load (std::memory_order_relaxed);
+}
+
+juce::int64 MidiOutputBatcher::getNumSendCalls() const
+{
+    return sendCalls.load (std::memory_order_relaxed);
+}
+
+MidiOutputBatcher::Slot* MidiOutputBatcher::findSlot (juce::MidiOutput* output)
+{
+    for (size_t i = 0; i < numSlotsInUse; ++i)
+        if (slots[i].output == output)
+            return &slots[i];
+
+    if (numSlotsInUse == maxOutputs)
+        return nullptr;
+
+    auto& slot = slots[numSlotsInUse++];
+    slot.output = output;
+    return &slot;
+}
+
+void MidiOutputBatcher::sendSlot (Slot& slot)
+{
+    if (slot.numEvents > 0)
+    {
+        slot.output->sendBlockOfMessagesNow (slot.buffer);
+        messagesSent.fetch_add (slot.numEvents, std::memory_order_relaxed);
+        sendCalls.fetch_add (1, std::memory_order_relaxed);
+    }
+
+    // clear() keeps the allocation
+    slot.buffer.clear();
+    slot.numBytes = 0;
+    slot.numEvents = 0;
+}
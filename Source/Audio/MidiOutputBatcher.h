@@ -0,0 +1,84 @@
+/*
+  ==============================================================================
+
+    MidiOutputBatcher.h
+    Collects one audio block's MIDI per output and sends each output's
+    messages in a single call.
+
+    Design:
+    - One preallocated MidiBuffer per output seen in the block, so the audio
+      thread never allocates; slots are reused across blocks
+    - flush() sends every buffer with sendBlockOfMessagesNow(): one driver
+      call per output instead of one per message
+    - Channel mode messages (controllers 120-127) repeated for the same
+      output and channel within a block are sent once
+    - Optional running-status friendly output: note-offs are sent as
+      zero-velocity note-ons, so note traffic on a channel shares one status
+      byte and DIN interfaces can omit it
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <bitset>
+
+class MidiOutputBatcher
+{
+public:
+    static constexpr size_t maxOutputs = 16;
+    static constexpr int bufferBytes = 8192;
+
+    MidiOutputBatcher();
+
+    /**
+     * Queue a message for an output (audio thread).
+     *
+     * @return false if it was dropped as a duplicate channel mode message
+     */
+    bool add (juce::MidiOutput* output, const juce::MidiMessage& message);
+
+    /**
+     * Send everything queued since the last flush, one call per output.
+     */
+    void flush();
+
+    /**
+     * Send note-offs as zero-velocity note-ons (takes effect on the next add).
+     */
+    void setUseRunningStatus (bool shouldUse);
+
+    /**
+     * Messages sent and driver calls made since construction.
+     */
+    juce::int64 getNumMessagesSent() const;
+    juce::int64 getNumSendCalls() const;
+
+private:
+    static constexpr int numModeControllers = 8; // 120-127
+    static constexpr int messageOverheadBytes = 6; // MidiBuffer stores position and size per event
+
+    struct Slot
+    {
+        juce::MidiOutput* output = nullptr;
+        juce::MidiBuffer buffer;
+        int numBytes = 0;
+        int numEvents = 0;
+        std::bitset<16 * numModeControllers> modeMessagesSent;
+    };
+
+    Slot* findSlot (juce::MidiOutput* output);
+    void sendSlot (Slot& slot);
+
+    std::array<Slot, maxOutputs> slots;
+    size_t numSlotsInUse = 0;
+
+    std::atomic<bool> useRunningStatus { false };
+    std::atomic<juce::int64> messagesSent { 0 };
+    std::atomic<juce::int64> sendCalls { 0 };
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MidiOutputBatcher)
+};
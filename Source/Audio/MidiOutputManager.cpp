@@ -187,3 +187,34 @@ void MidiOutputManager::setDefaultDeviceId (const juce::String& deviceId)
     juce::ScopedLock sl (lock);
     defaultDeviceId = deviceId;
 }
+
+void MidiOutputManager::setClockEnabled (const juce::String& deviceId, bool shouldSendClock)
+{
+    juce::ScopedLock sl (lock);
+
+    if (shouldSendClock)
+        clockDeviceIds.insert (deviceId);
+    else
+        clockDeviceIds.erase (deviceId);
+}
+
+bool MidiOutputManager::isClockEnabled (const juce::String& deviceId) const
+{
+    juce::ScopedLock sl (lock);
+    return clockDeviceIds.count (deviceId) > 0;
+}
+
+juce::Array<juce::MidiOutput*> MidiOutputManager::getClockOutputs()
+{
+    juce::ScopedLock sl (lock);
+    juce::Array<juce::MidiOutput*> outputs;
+
+    for (const auto& deviceId : clockDeviceIds)
+    {
+        // Several ids (e.g. "" and the default's own id) can name one device
+        if (auto* output = getOutput (deviceId))
+            outputs.addIfNotAlreadyThere (output);
+    }
+
+    return outputs;
+}
@@ -16,6 +16,7 @@
 
 #include <JuceHeader.h>
 #include <map>
+#include <set>
 
 class MidiOutputManager
 {
@@ -43,11 +44,21 @@ public:
 
     void setDefaultDeviceId (const juce::String& deviceId);
 
+    // Per-output MIDI clock. An empty deviceId means the default output
+    void setClockEnabled (const juce::String& deviceId, bool shouldSendClock);
+
+    bool isClockEnabled (const juce::String& deviceId) const;
+
+    // Opens (if needed) and returns every output with clock enabled
+    juce::Array<juce::MidiOutput*> getClockOutputs();
+
 private:
     std::map<juce::String, std::unique_ptr<juce::MidiOutput>> openOutputs;
 
     juce::String defaultDeviceId;
 
+    std::set<juce::String> clockDeviceIds;
+
     juce::Array<juce::MidiDeviceInfo> availableDevices;
 
     juce::CriticalSection lock;
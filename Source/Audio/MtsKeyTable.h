@@ -0,0 +1,96 @@
+/*
+  ==============================================================================
+
+    MtsKeyTable.h
+    The MTS tuning each output's keys were last sent, kept on the audio
+    thread so a retune is only sent when the key's tuning changes.
+
+    Design:
+    - One slot per output, since MTS tuning belongs to the receiver rather
+      than to a track: tracks sharing an output share its keys
+    - Updated only when a retune is actually sent, so retunes that are
+      cancelled, skipped as stale or held back by a mute are sent again by
+      the next note that needs them
+    - Keys never sent since the last clear() count as unknown, so the first
+      note on each key after a stop always retunes it
+    - Fixed storage, no allocation or locking
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "Audio/MidiOutputBatcher.h"
+#include "Audio/TuningTable.h"
+#include <JuceHeader.h>
+#include <array>
+
+class MtsKeyTable
+{
+public:
+    static constexpr size_t maxOutputs = MidiOutputBatcher::maxOutputs;
+
+    /**
+     * Record that key is about to be retuned to detune on output.
+     *
+     * @return true if the retune should be sent: the key's tuning is unknown
+     *         or differs, or the output can't be tracked
+     */
+    bool retune (juce::MidiOutput* output, int key, float detune)
+    {
+        if (output == nullptr || key < 0 || key > 127)
+            return true;
+
+        auto* keys = findOrAdd (output);
+
+        if (keys == nullptr)
+            return true;
+
+        auto index = static_cast<size_t> (key);
+        auto& word = keys->known[index >> 6];
+        auto mask = juce::uint64 { 1 } << (index & 63);
+
+        if ((word & mask) != 0 && ! TuningTable::isDetuned (detune - keys->detune[index]))
+            return false;
+
+        word |= mask;
+        keys->detune[index] = detune;
+        return true;
+    }
+
+    /**
+     * Forget every output's tuning, so each key is retuned again.
+     */
+    void clear()
+    {
+        for (auto& keys : outputs)
+            keys = {};
+    }
+
+private:
+    struct OutputKeys
+    {
+        juce::MidiOutput* output = nullptr;
+        std::array<juce::uint64, 2> known {};
+        std::array<float, 128> detune {};
+    };
+
+    OutputKeys* findOrAdd (juce::MidiOutput* output)
+    {
+        for (auto& keys : outputs)
+        {
+            if (keys.output == output)
+                return &keys;
+
+            if (keys.output == nullptr)
+            {
+                keys.output = output;
+                return &keys;
+            }
+        }
+
+        return nullptr;
+    }
+
+    std::array<OutputKeys, maxOutputs> outputs;
+};
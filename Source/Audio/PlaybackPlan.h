@@ -0,0 +1,78 @@
+/*
+  ==============================================================================
+
+    PlaybackPlan.h
+    What the audio thread plays from a given moment: the compiled form of a
+    scene.
+
+    Design:
+    - Built on the UI thread when a scene is queued, then handed to the
+      engine as an immutable object
+    - The engine switches to a queued plan with one atomic pointer swap at
+      the first event at or after startTime, so a bar-line switch is exact
+      to the event
+    - The owner keeps a plan alive until the engine has let go of it (see
+      PlaybackPlanQueue)
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <deque>
+#include <memory>
+
+struct PlaybackPlan
+{
+    static constexpr juce::uint32 allTracks = 0xffffffff;
+
+    juce::uint32 trackMask = allTracks; // Bit i lets track i through
+    double startTime = 0.0;              // Transport seconds where the plan takes over
+    double startBeat = 0.0;
+    double lengthBeats = 0.0;            // Song mode: when the next scene follows (0 = hold)
+    int sceneIndex = -1;                 // -1 for "every track"
+};
+
+/**
+ * Owns the plans handed to the engine (UI thread only). A plan is freed only
+ * after it has gone unused for a few frames, so the audio thread can never
+ * be reading it.
+ */
+class PlaybackPlanQueue
+{
+public:
+    static constexpr int framesBeforeFree = 4;
+
+    PlaybackPlan* create (const PlaybackPlan& plan)
+    {
+        plans.push_back ({ std::make_unique<PlaybackPlan> (plan), 0 });
+        return plans.back().plan.get();
+    }
+
+    /**
+     * Free plans that are neither active nor pending. Call once per frame.
+     */
+    void collectGarbage (const PlaybackPlan* active, const PlaybackPlan* pending)
+    {
+        for (auto& entry : plans)
+        {
+            if (entry.plan.get() == active || entry.plan.get() == pending)
+                entry.idleFrames = 0;
+            else
+                ++entry.idleFrames;
+        }
+
+        std::erase_if (plans, [] (const Entry& entry)
+                       { return entry.idleFrames > framesBeforeFree; });
+    }
+
+private:
+    struct Entry
+    {
+        std::unique_ptr<PlaybackPlan> plan;
+        int idleFrames = 0;
+    };
+
+    std::deque<Entry> plans;
+};
@@ -0,0 +1,73 @@
+/*
+  ==============================================================================
+
+    RatchetTable.cpp
+    Repeats of ratcheted notes, generated on the audio thread.
+
+  ==============================================================================
+*/
+
+#include "RatchetTable.h"
+
+bool RatchetTable::start (const Ratchet& ratchet)
+{
+    if (ratchet.hits < 2 || ratchet.interval <= 0.0)
+        return false;
+
+    for (auto& slot : ratchets)
+    {
+        if (! slot.active)
+        {
+            slot = ratchet;
+            slot.nextEdge = 0;
+            slot.active = true;
+            ++numActive;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void RatchetTable::stopNote (juce::uint32 sourceId, juce::uint32 occurrence)
+{
+    if (numActive == 0)
+        return;
+
+    for (auto& ratchet : ratchets)
+    {
+        if (ratchet.active && ratchet.occurrence == occurrence && ratchet.sourceId == sourceId)
+            stop (ratchet);
+    }
+}
+
+void RatchetTable::stopTrack (int trackIndex)
+{
+    if (numActive == 0)
+        return;
+
+    for (auto& ratchet : ratchets)
+    {
+        if (ratchet.active && ratchet.trackIndex == trackIndex)
+            stop (ratchet);
+    }
+}
+
+void RatchetTable::clear()
+{
+    for (auto& ratchet : ratchets)
+        ratchet.active = false;
+
+    numActive = 0;
+}
+
+int RatchetTable::getNumActive() const
+{
+    return numActive;
+}
+
+void RatchetTable::stop (Ratchet& ratchet)
+{
+    ratchet.active = false;
+    --numActive;
+}
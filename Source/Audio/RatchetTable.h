@@ -0,0 +1,113 @@
+/*
+  ==============================================================================
+
+    RatchetTable.h
+    Repeats of ratcheted notes, generated on the audio thread.
+
+    Design:
+    - A ratcheted note is scheduled as one note-on and one note-off like
+      any other; its note-on carries the hit count, and the repeats in
+      between are produced here as it plays. A x8 ratchet costs two buffer
+      events, not sixteen, so dense ratchets can't fill the event buffer
+    - Each repeat is an off/on edge pair at fixed offsets from the first
+      hit, so no timing error accumulates
+    - The scheduled note-off ends the last hit; that note's own note-off
+      (matched by source and occurrence, not by key), a release or a track
+      going silent stops the repeats
+    - Fixed storage, no allocation or locking
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+class RatchetTable
+{
+public:
+    static constexpr size_t maxRatchets = 64;
+
+    struct Ratchet
+    {
+        juce::MidiOutput* output = nullptr;
+        int trackIndex = -1;
+        juce::uint32 sourceId = 0;   // The scheduled note it repeats
+        juce::uint32 occurrence = 0;
+        int channel = 1;
+        int noteNumber = 0;
+        juce::uint8 velocity = 0;
+        double startTime = 0.0; // Transport seconds of the first hit
+        double interval = 0.0;  // Seconds between hits
+        float gate = 0.5f;      // Fraction of the interval each hit sounds
+        int hits = 1;
+        int nextEdge = 0;
+        bool active = false;
+    };
+
+    /**
+     * Start repeating a note whose first hit was just sent.
+     *
+     * @return false if the table is full; the note then plays once
+     */
+    bool start (const Ratchet& ratchet);
+
+    /**
+     * Call send (output, message) for every repeat edge at or before time,
+     * each ratchet's edges in order.
+     */
+    template <typename SendFunction>
+    void advance (double time, SendFunction&& send)
+    {
+        if (numActive == 0)
+            return;
+
+        for (auto& ratchet : ratchets)
+        {
+            if (! ratchet.active)
+                continue;
+
+            while (ratchet.nextEdge < getNumEdges (ratchet) && getEdgeTime (ratchet, ratchet.nextEdge) <= time)
+            {
+                // Even edges end a hit, odd edges start the next one
+                if (ratchet.nextEdge % 2 == 0)
+                    send (ratchet.output, juce::MidiMessage::noteOff (ratchet.channel, ratchet.noteNumber));
+                else
+                    send (ratchet.output, juce::MidiMessage::noteOn (ratchet.channel, ratchet.noteNumber, ratchet.velocity));
+
+                ++ratchet.nextEdge;
+            }
+
+            if (ratchet.nextEdge >= getNumEdges (ratchet))
+                stop (ratchet);
+        }
+    }
+
+    // Stop the repeats of one scheduled note, when its note-off arrives
+    void stopNote (juce::uint32 sourceId, juce::uint32 occurrence);
+
+    // Stop a track's repeats, when it goes silent
+    void stopTrack (int trackIndex);
+
+    void clear();
+
+    int getNumActive() const;
+
+private:
+    std::array<Ratchet, maxRatchets> ratchets {};
+    int numActive = 0;
+
+    void stop (Ratchet& ratchet);
+
+    static int getNumEdges (const Ratchet& ratchet)
+    {
+        return 2 * (ratchet.hits - 1);
+    }
+
+    static double getEdgeTime (const Ratchet& ratchet, int edge)
+    {
+        auto hit = edge / 2;
+        return ratchet.startTime + ratchet.interval * (edge % 2 == 0 ? hit + ratchet.gate : hit + 1);
+    }
+};
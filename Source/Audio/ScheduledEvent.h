@@ -12,7 +12,12 @@
 
 #pragma once
 
+#include "Audio/TuningTable.h"
+#include "Data/Note.h"
 #include <JuceHeader.h>
+#include <array>
+#include <atomic>
+#include <vector>
 
 /**
  * A MIDI event with timestamp and output destination.
@@ -28,11 +33,71 @@ struct ScheduledEvent
     juce::MidiMessage message;
     juce::MidiOutput* output = nullptr; // Per-event output destination
 
+    // Which note this came from, and which of its scheduled occurrences:
+    // the note-on, note-off and tuning messages of one occurrence share it
+    juce::uint32 sourceId = 0;
+    juce::uint32 occurrence = 0;
+
+    // Track that scheduled it, for mute and solo on the audio thread (-1 for none)
+    int trackIndex = -1;
+
+    // MTS retunes: the key and detune the message sets, so the audio thread
+    // can skip it when the output's key already has that tuning (-1 = not a retune)
+    int tuningKey = -1;
+    float tuningDetune = 0.0f;
+
+    // Note-ons of ratcheted notes: the audio thread plays the repeats
+    int ratchetHits = 1;
+    float ratchetGate = 0.5f;
+    double ratchetInterval = 0.0;
+
+    // Set by the UI thread to retract an event the audio thread hasn't sent yet
+    std::atomic<bool> cancelled { false };
+
     ScheduledEvent() = default;
 
-    ScheduledEvent (double time, juce::MidiMessage msg, juce::MidiOutput* out = nullptr)
-        : timestamp (time), message (std::move (msg)), output (out)
+    ScheduledEvent (double time, juce::MidiMessage msg, juce::MidiOutput* out = nullptr, juce::uint32 source = 0, juce::uint32 occ = 0)
+        : timestamp (time), message (std::move (msg)), output (out), sourceId (source), occurrence (occ)
+    {
+    }
+
+    // The buffer is sorted and compacted by copying, so the flag travels with the event
+    ScheduledEvent (const ScheduledEvent& other)
+        : timestamp (other.timestamp),
+          message (other.message),
+          output (other.output),
+          sourceId (other.sourceId),
+          occurrence (other.occurrence),
+          trackIndex (other.trackIndex),
+          tuningKey (other.tuningKey),
+          tuningDetune (other.tuningDetune),
+          ratchetHits (other.ratchetHits),
+          ratchetGate (other.ratchetGate),
+          ratchetInterval (other.ratchetInterval),
+          cancelled (other.cancelled.load (std::memory_order_relaxed))
+    {
+    }
+
+    ScheduledEvent& operator= (const ScheduledEvent& other)
+    {
+        timestamp = other.timestamp;
+        message = other.message;
+        output = other.output;
+        sourceId = other.sourceId;
+        occurrence = other.occurrence;
+        trackIndex = other.trackIndex;
+        tuningKey = other.tuningKey;
+        tuningDetune = other.tuningDetune;
+        ratchetHits = other.ratchetHits;
+        ratchetGate = other.ratchetGate;
+        ratchetInterval = other.ratchetInterval;
+        cancelled.store (other.cancelled.load (std::memory_order_relaxed), std::memory_order_relaxed);
+        return *this;
+    }
+
+    bool isCancelled() const
     {
+        return cancelled.load (std::memory_order_acquire);
     }
 
     bool operator> (const ScheduledEvent& other) const
@@ -46,6 +111,35 @@ struct ScheduledEvent
     }
 };
 
+/**
+ * Where and how a track's notes are sent.
+ * Resolved on the UI thread from the sequence settings before scheduling.
+ */
+struct TrackRouting
+{
+    juce::MidiOutput* output = nullptr;
+    int midiChannel = 1;
+    Tuning::Output tuning = Tuning::Output::nearest;
+};
+
+/**
+ * One track's share of a scheduling pass: its notes in, its events out.
+ * Slices are built independently (possibly on worker threads) and then
+ * committed to the engine together.
+ */
+struct TrackSlice
+{
+    size_t trackIndex = 0;
+    std::vector<MidiNote> notes;
+    double loopStartTime = 0.0;
+    TrackRouting routing;
+
+    // Filled by TransportEngine::buildTrackEvents. Occurrences are numbered
+    // from 0 within the slice until the commit gives them their final values
+    std::vector<ScheduledEvent> events;
+    bool built = false;
+};
+
 /**
  * Runtime state for a single track's loop timing.
  * Used by TransportEngine to track independent loop positions per track.
@@ -57,6 +151,14 @@ struct PerTrackState
     // Cached for realtime access - set during scheduling, read during processing
     juce::MidiOutput* cachedOutput = nullptr;
     int cachedMidiChannel = 1;
+    bool cachedMpe = false; // Notes go out on the MPE member channels
+
+    // Set from the UI thread, applied by the audio thread at the next block
+    std::atomic<bool> muted { false };
+    std::atomic<bool> soloed { false };
+
+    // Audio thread only: whether the last block let this track through
+    bool wasAudible = true;
 
     PerTrackState() = default;
 
@@ -0,0 +1,65 @@
+/*
+  ==============================================================================
+
+    SchedulingPool.cpp
+    Per-track scheduling work spread over worker threads.
+
+  ==============================================================================
+*/
+
+#include "SchedulingPool.h"
+#include <atomic>
+
+SchedulingPool::SchedulingPool (int numWorkers)
+    : pool (numWorkers > 0 ? numWorkers : defaultNumWorkers())
+{
+}
+
+SchedulingPool::~SchedulingPool()
+{
+    pool.removeAllJobs (true, 1000);
+}
+
+int SchedulingPool::defaultNumWorkers()
+{
+    // Leave a core for the audio thread; the caller makes up the difference
+    return juce::jlimit (1, 15, juce::SystemStats::getNumCpus() - 2);
+}
+
+int SchedulingPool::getNumWorkers() const
+{
+    return pool.getNumThreads();
+}
+
+void SchedulingPool::run (size_t numTasks, const std::function<void (size_t)>& task)
+{
+    if (numTasks < minTasksForWorkers)
+    {
+        for (size_t i = 0; i < numTasks; ++i)
+            task (i);
+        return;
+    }
+
+    auto numHelpers = juce::jmin (numTasks - 1, static_cast<size_t> (pool.getNumThreads()));
+
+    std::atomic<size_t> nextTask { 0 };
+    std::atomic<size_t> participantsLeft { numHelpers + 1 };
+    juce::WaitableEvent finished;
+
+    // Everyone pulls from the same counter until the tasks run out. The last
+    // participant to leave signals, so nothing touches this frame after run() returns
+    auto drain = [&]
+    {
+        for (auto i = nextTask.fetch_add (1); i < numTasks; i = nextTask.fetch_add (1))
+            task (i);
+
+        if (participantsLeft.fetch_sub (1) == 1)
+            finished.signal();
+    };
+
+    for (size_t i = 0; i < numHelpers; ++i)
+        pool.addJob (drain);
+
+    drain();
+    finished.wait();
+}
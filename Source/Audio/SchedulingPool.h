@@ -0,0 +1,49 @@
+/*
+  ==============================================================================
+
+    SchedulingPool.h
+    Runs one scheduling pass's per-track work on several cores.
+
+    Design:
+    - A fixed set of worker threads, started once; nothing is spawned per pass
+    - Tasks are claimed from a shared counter by the workers and by the
+      calling thread alike, so a track that is slow to extract doesn't hold
+      up the rest and the caller never just sits waiting
+    - run() returns only when every task has finished, so tasks may use
+      the caller's stack and the caller sees all their results
+    - Small passes run inline: waking workers costs more than it saves
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <functional>
+
+class SchedulingPool
+{
+public:
+    static constexpr size_t minTasksForWorkers = 4;
+
+    /**
+     * @param numWorkers Worker threads besides the caller; 0 picks one per spare core
+     */
+    explicit SchedulingPool (int numWorkers = 0);
+    ~SchedulingPool();
+
+    /**
+     * Call task (i) for every i in [0, numTasks) and wait for all of them.
+     * Tasks run concurrently and in no particular order.
+     */
+    void run (size_t numTasks, const std::function<void (size_t)>& task);
+
+    int getNumWorkers() const;
+
+private:
+    juce::ThreadPool pool;
+
+    static int defaultNumWorkers();
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SchedulingPool)
+};
@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    Timebase.h
+    Lock-free snapshot of where the transport is in wall-clock time.
+
+    Design:
+    - The audio thread publishes one snapshot per block (single writer)
+    - Any other thread can read a consistent snapshot without locking
+    - Sequence lock: the writer makes the counter odd while writing and even
+      when done; readers retry if the counter was odd or changed under them
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <atomic>
+
+struct Timebase
+{
+    double hostTimeMs = 0.0;      // Time::getMillisecondCounterHiRes() at the block
+    double positionSeconds = 0.0; // Transport position at that time
+    double tempo = 120.0;
+    bool playing = false;
+
+    double getBeat() const { return positionSeconds * tempo / 60.0; }
+
+    // Beat position extrapolated to another host time
+    double getBeatAt (double timeMs) const { return getBeat() + (timeMs - hostTimeMs) * tempo / 60000.0; }
+
+    // Host time at which a beat position is reached
+    double getTimeOfBeat (double beat) const { return hostTimeMs + (beat - getBeat()) * 60000.0 / tempo; }
+};
+
+class SeqLockedTimebase
+{
+public:
+    /**
+     * Publish a new snapshot. Only one thread may write (the audio thread).
+     * Wait-free.
+     */
+    void publish (const Timebase& t) noexcept
+    {
+        auto seq = sequence.load (std::memory_order_relaxed);
+        sequence.store (seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_release);
+
+        hostTimeMs.store (t.hostTimeMs, std::memory_order_relaxed);
+        positionSeconds.store (t.positionSeconds, std::memory_order_relaxed);
+        tempo.store (t.tempo, std::memory_order_relaxed);
+        playing.store (t.playing, std::memory_order_relaxed);
+
+        sequence.store (seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * Read the latest complete snapshot. Lock-free; retries while a publish
+     * is in progress.
+     */
+    Timebase read() const noexcept
+    {
+        Timebase t;
+
+        for (;;)
+        {
+            auto before = sequence.load (std::memory_order_acquire);
+
+            t.hostTimeMs = hostTimeMs.load (std::memory_order_relaxed);
+            t.positionSeconds = positionSeconds.load (std::memory_order_relaxed);
+            t.tempo = tempo.load (std::memory_order_relaxed);
+            t.playing = playing.load (std::memory_order_relaxed);
+
+            std::atomic_thread_fence (std::memory_order_acquire);
+
+            if ((before & 1) == 0 && sequence.load (std::memory_order_relaxed) == before)
+                return t;
+        }
+    }
+
+private:
+    std::atomic<juce::uint32> sequence { 0 };
+    std::atomic<double> hostTimeMs { 0.0 };
+    std::atomic<double> positionSeconds { 0.0 };
+    std::atomic<double> tempo { 120.0 };
+    std::atomic<bool> playing { false };
+};
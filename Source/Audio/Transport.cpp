@@ -58,11 +58,39 @@ double Transport::applyPendingTempo()
         double newTempo = pendingTempo.load();
         tempo.store (newTempo);
         tempoPending.store (false);
+
+        // Notes timed at the old tempo would end in the wrong place
+        if (isPlaying())
+            engine.requestReleaseAll();
+
         return newTempo;
     }
     return tempo.load();
 }
 
+void Transport::setExternalTimebase (const SeqLockedTimebase* external)
+{
+    externalTimebase.store (external);
+}
+
+bool Transport::isFollowingExternalTimebase() const
+{
+    return externalTimebase.load() != nullptr;
+}
+
+bool Transport::takeFollowedTempoChange()
+{
+    return followedTempoChanged.exchange (false);
+}
+
+void Transport::rescheduleFrom (double beat)
+{
+    engine.clearScheduledEvents();
+
+    for (size_t i = 0; i < engine.getNumTracks(); ++i)
+        engine.markBeatsScheduled (i, beat);
+}
+
 // === Transport Control ===
 
 void Transport::start()
@@ -89,6 +117,9 @@ double Transport::getCurrentPosition() const
 void Transport::setPosition (double positionSeconds)
 {
     transportSource.setPosition (positionSeconds);
+
+    if (isPlaying())
+        engine.requestReleaseAll();
 }
 
 // === Track Scheduling (delegates to TransportEngine) ===
@@ -106,10 +137,19 @@ size_t Transport::getNumTracks() const
 void Transport::scheduleTrack (size_t trackIndex,
                                const std::vector<MidiNote>& notes,
                                double loopStartTime,
-                               juce::MidiOutput* output,
-                               int midiChannel)
+                               const TrackRouting& routing)
 {
-    engine.scheduleTrack (trackIndex, notes, loopStartTime, output, midiChannel);
+    engine.scheduleTrack (trackIndex, notes, loopStartTime, routing);
+}
+
+void Transport::buildTrackEvents (TrackSlice& slice)
+{
+    engine.buildTrackEvents (slice);
+}
+
+bool Transport::commitTrackEvents (std::vector<TrackSlice>& slices)
+{
+    return engine.commitTrackEvents (slices);
 }
 
 bool Transport::trackNeedsBeatScheduling (size_t trackIndex, double currentBeat) const
@@ -127,6 +167,66 @@ void Transport::clearScheduledEvents()
     engine.clearScheduledEvents();
 }
 
+int Transport::cancelNoteEvents (const std::vector<juce::uint32>& sourceIds, double fromTime)
+{
+    return engine.cancelNoteEvents (sourceIds, fromTime);
+}
+
+double Transport::getScheduledEndBeat (size_t trackIndex) const
+{
+    return engine.getScheduledEndBeat (trackIndex);
+}
+
+void Transport::setTrackMuted (size_t trackIndex, bool shouldBeMuted)
+{
+    engine.setTrackMuted (trackIndex, shouldBeMuted);
+}
+
+void Transport::setTrackSoloed (size_t trackIndex, bool shouldBeSoloed)
+{
+    engine.setTrackSoloed (trackIndex, shouldBeSoloed);
+}
+
+void Transport::setUseRunningStatus (bool shouldUse)
+{
+    engine.setUseRunningStatus (shouldUse);
+}
+
+void Transport::queuePlaybackPlan (const PlaybackPlan* plan)
+{
+    engine.queuePlan (plan);
+}
+
+const PlaybackPlan* Transport::getActivePlaybackPlan() const
+{
+    return engine.getActivePlan();
+}
+
+const PlaybackPlan* Transport::getPendingPlaybackPlan() const
+{
+    return engine.getPendingPlan();
+}
+
+void Transport::clearPlaybackPlans()
+{
+    engine.clearPlans();
+}
+
+void Transport::setAutomationPlan (size_t trackIndex, const AutomationPlan* plan)
+{
+    engine.setAutomationPlan (trackIndex, plan);
+}
+
+const AutomationPlan* Transport::getAutomationPlan (size_t trackIndex) const
+{
+    return engine.getAutomationPlan (trackIndex);
+}
+
+void Transport::setAutomationRate (double hz)
+{
+    engine.setAutomationRate (hz);
+}
+
 void Transport::reset()
 {
     setPosition (0.0);
@@ -134,6 +234,7 @@ void Transport::reset()
 
     // Clear any pending tempo change on reset
     tempoPending.store (false);
+    followedTempoChanged.store (false);
 }
 
 // === Audio Callback ===
@@ -153,6 +254,11 @@ void Transport::audioDeviceIOCallbackWithContext (
             std::fill_n (outputChannelData[channel], numSamples, 0.0f);
     }
 
+    followExternalTimebase();
+
+    // The block starts now at the current position
+    timebase.publish ({ juce::Time::getMillisecondCounterHiRes(), getCurrentPosition(), getTempo(), isPlaying() });
+
     // Update transport position
     juce::AudioBuffer<float> tempBuffer (outputChannelData, numOutputChannels, numSamples);
     transportSource.getNextAudioBlock (juce::AudioSourceChannelInfo (tempBuffer));
@@ -161,7 +267,50 @@ void Transport::audioDeviceIOCallbackWithContext (
     double bufferDuration = static_cast<double> (numSamples) / sampleRate;
 
     // Process MIDI events - realtime safe, no allocations
-    engine.processBlock (currentPosition, bufferDuration, isPlaying());
+    engine.processBlock (currentPosition, bufferDuration, isPlaying(), getTempo());
+}
+
+void Transport::followExternalTimebase()
+{
+    auto* external = externalTimebase.load();
+
+    if (external == nullptr || ! isPlaying())
+        return;
+
+    auto followed = external->read();
+
+    if (! followed.playing)
+        return;
+
+    // The estimate wobbles with every tick. Rescaling the position by it
+    // would move the transport further the later in the song it is, so the
+    // tempo is held until the estimate has really moved
+    double heldTempo = tempo.load();
+    double followedTempo = juce::jlimit (MIN_TEMPO, MAX_TEMPO, followed.tempo);
+
+    if (std::abs (followedTempo - heldTempo) > heldTempo * FOLLOW_TEMPO_HYSTERESIS)
+    {
+        // Keep the beat, at the new tempo; notes and events timed at the old
+        // one are released and rescheduled
+        double currentBeat = getCurrentPosition() * heldTempo / 60.0;
+        tempo.store (followedTempo);
+        pendingTempo.store (followedTempo);
+        transportSource.setPosition (currentBeat * 60.0 / followedTempo);
+        engine.requestReleaseAll();
+        followedTempoChanged.store (true);
+        heldTempo = followedTempo;
+    }
+
+    // Phase: how far this block is from the followed beat, at the held tempo
+    double followedBeat = juce::jmax (0.0, followed.getBeatAt (juce::Time::getMillisecondCounterHiRes()));
+    double errorSeconds = (followedBeat - getCurrentPosition() * heldTempo / 60.0) * 60.0 / heldTempo;
+
+    if (std::abs (errorSeconds) > FOLLOW_TOLERANCE_SECONDS)
+        transportSource.setPosition (getCurrentPosition() + errorSeconds);
+
+    // A relocation, not a drift correction
+    if (std::abs (errorSeconds) > FOLLOW_RELOCATE_SECONDS)
+        engine.requestReleaseAll();
 }
 
 void Transport::audioDeviceAboutToStart (juce::AudioIODevice* device)
@@ -195,3 +344,8 @@ double Transport::getCurrentBeat() const
 {
     return secondsToBeats (getCurrentPosition());
 }
+
+const SeqLockedTimebase& Transport::getTimebase() const
+{
+    return timebase;
+}
@@ -15,6 +15,7 @@
 
 #pragma once
 
+#include "Audio/Timebase.h"
 #include "Audio/TransportEngine.h"
 #include <JuceHeader.h>
 #include <atomic>
@@ -27,6 +28,16 @@ public:
     static constexpr double MAX_TEMPO = 300.0;
     static constexpr double DEFAULT_TEMPO = 120.0;
 
+    // Position error tolerated before following an external clock seeks
+    static constexpr double FOLLOW_TOLERANCE_SECONDS = 0.002;
+
+    // Position error treated as a relocation, which ends sounding notes
+    static constexpr double FOLLOW_RELOCATE_SECONDS = 0.05;
+
+    // Relative change in the followed tempo estimate before it is adopted;
+    // smaller wobbles are absorbed by phase correction at the held tempo
+    static constexpr double FOLLOW_TEMPO_HYSTERESIS = 0.005;
+
     Transport();
     ~Transport() override;
 
@@ -57,6 +68,34 @@ public:
      */
     double applyPendingTempo();
 
+    /**
+     * Follow an external timebase (e.g. incoming MIDI clock). While it is
+     * playing, each audio block nudges the position onto its beat at the
+     * held tempo. The tempo only moves when the followed estimate moves past
+     * FOLLOW_TEMPO_HYSTERESIS; that is a tempo change, which ends sounding
+     * notes and asks for a reschedule (see takeFollowedTempoChange()).
+     * Pass nullptr to run from the internal tempo again.
+     * The timebase must outlive the transport or be cleared first.
+     */
+    void setExternalTimebase (const SeqLockedTimebase* external);
+
+    /**
+     * True once after following adopted a new tempo: events scheduled at the
+     * old tempo are misplaced and should be rescheduled (UI thread).
+     */
+    bool takeFollowedTempoChange();
+
+    /**
+     * Drop every scheduled event and have each track schedule again from
+     * beat, e.g. after a tempo change (UI thread).
+     */
+    void rescheduleFrom (double beat);
+
+    /**
+     * True while an external timebase is set.
+     */
+    bool isFollowingExternalTimebase() const;
+
     // === Transport Control ===
 
     /**
@@ -80,7 +119,8 @@ public:
     double getCurrentPosition() const;
 
     /**
-     * Set the playback position.
+     * Set the playback position. During playback this ends the sounding
+     * notes at the next audio block.
      *
      * @param positionSeconds Position in seconds
      */
@@ -104,8 +144,17 @@ public:
     void scheduleTrack (size_t trackIndex,
                         const std::vector<MidiNote>& notes,
                         double loopStartTime,
-                        juce::MidiOutput* output,
-                        int midiChannel);
+                        const TrackRouting& routing);
+
+    /**
+     * Build a slice's events; safe to call for different tracks in parallel.
+     */
+    void buildTrackEvents (TrackSlice& slice);
+
+    /**
+     * Schedule a pass of built slices with a single buffer insert.
+     */
+    bool commitTrackEvents (std::vector<TrackSlice>& slices);
 
     /**
      * Check if a track needs beat scheduling.
@@ -129,6 +178,49 @@ public:
      */
     void clearScheduledEvents();
 
+    /**
+     * Retract pending occurrences of edited notes from fromTime on.
+     * See TransportEngine::cancelNoteEvents().
+     */
+    int cancelNoteEvents (const std::vector<juce::uint32>& sourceIds, double fromTime);
+
+    /**
+     * The beat a track has been scheduled up to.
+     */
+    double getScheduledEndBeat (size_t trackIndex) const;
+
+    /**
+     * Mute or solo a track; takes effect at the next audio block.
+     * See TransportEngine::setTrackMuted().
+     */
+    void setTrackMuted (size_t trackIndex, bool shouldBeMuted);
+    void setTrackSoloed (size_t trackIndex, bool shouldBeSoloed);
+
+    /**
+     * Send note-offs as zero-velocity note-ons so outputs can use running status.
+     */
+    void setUseRunningStatus (bool shouldUse);
+
+    // === Scenes (delegates to TransportEngine) ===
+
+    /**
+     * Queue a scene's plan to take over at plan->startTime.
+     * See TransportEngine::queuePlan().
+     */
+    void queuePlaybackPlan (const PlaybackPlan* plan);
+    const PlaybackPlan* getActivePlaybackPlan() const;
+    const PlaybackPlan* getPendingPlaybackPlan() const;
+    void clearPlaybackPlans();
+
+    // === Automation (delegates to TransportEngine) ===
+
+    /**
+     * Replace a track's automation. See TransportEngine::setAutomationPlan().
+     */
+    void setAutomationPlan (size_t trackIndex, const AutomationPlan* plan);
+    const AutomationPlan* getAutomationPlan (size_t trackIndex) const;
+    void setAutomationRate (double hz);
+
     /**
      * Reset all tracks to beginning (time 0).
      */
@@ -164,12 +256,27 @@ public:
      */
     double getCurrentBeat() const;
 
+    /**
+     * Position, tempo and play state with the host time they were sampled,
+     * published once per audio block. Safe to read from any thread.
+     */
+    const SeqLockedTimebase& getTimebase() const;
+
 private:
     // Tempo (atomic for thread-safe access)
     std::atomic<double> tempo { DEFAULT_TEMPO };
     std::atomic<double> pendingTempo { DEFAULT_TEMPO };
     std::atomic<bool> tempoPending { false };
 
+    // Published from the audio thread for clock generation
+    SeqLockedTimebase timebase;
+
+    // Followed on the audio thread when set
+    std::atomic<const SeqLockedTimebase*> externalTimebase { nullptr };
+    std::atomic<bool> followedTempoChanged { false };
+
+    void followExternalTimebase();
+
     // MIDI scheduling engine
     TransportEngine engine;
 
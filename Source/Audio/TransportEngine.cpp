@@ -8,10 +8,13 @@
 */
 
 #include "TransportEngine.h"
+#include "Data/Ticks.h"
 #include "juce_core/juce_core.h"
 #include "juce_core/system/juce_PlatformDefs.h"
 #include <algorithm>
+#include <cmath>
 #include <iterator>
+#include <utility>
 
 TransportEngine::TransportEngine()
 {
@@ -20,6 +23,8 @@ TransportEngine::TransportEngine()
     {
         trackStates[i].cachedMidiChannel = static_cast<int> (i + 1); // Channels 1-16
     }
+
+    resetAutomationOutputs();
 }
 
 // === Track Management ===
@@ -39,41 +44,156 @@ size_t TransportEngine::getNumTracks() const
 void TransportEngine::scheduleTrack (size_t trackIndex,
                                      const std::vector<MidiNote>& notes,
                                      double loopStartTime,
-                                     juce::MidiOutput* output,
-                                     int midiChannel)
+                                     const TrackRouting& routing)
+{
+    std::vector<TrackSlice> slices (1);
+    slices[0].trackIndex = trackIndex;
+    slices[0].notes = notes;
+    slices[0].loopStartTime = loopStartTime;
+    slices[0].routing = routing;
+
+    buildTrackEvents (slices[0]);
+    commitTrackEvents (slices);
+}
+
+void TransportEngine::buildTrackEvents (TrackSlice& slice)
 {
+    auto trackIndex = slice.trackIndex;
+    const auto& routing = slice.routing;
+    auto* output = routing.output;
+    auto midiChannel = routing.midiChannel;
+
+    slice.events.clear();
+    slice.built = false;
+
     if (trackIndex >= numActiveTracks.load())
         return;
 
     if (output == nullptr)
         return; // No output, skip this track
 
-    // Update cached state for this track
-    auto& state = trackStates[trackIndex];
-    state.cachedOutput = output;
-    state.cachedMidiChannel = midiChannel;
+    // Build the new events for this track (not the audio thread - allocation is safe here)
+    auto& newEvents = slice.events;
+    newEvents.reserve (slice.notes.size() * 3);
 
-    // Build the new events for this track (UI thread - allocation is safe here)
-    std::vector<ScheduledEvent> newEvents;
-    newEvents.reserve (notes.size() * 2);
+    const auto& tuningTable = TuningTable::getInstance();
+    juce::uint32 occurrence = 0;
 
-    for (const auto& note : notes)
+    for (const auto& note : slice.notes)
     {
-        double noteStartTime = loopStartTime + note.startTime;
+        double noteStartTime = slice.loopStartTime + note.startTime;
         double noteEndTime = noteStartTime + note.duration;
+        int noteChannel = midiChannel;
+
+        // Tuning messages share the note-on timestamp; the stable sort keeps them in front of it
+        if (routing.tuning == Tuning::Output::mpe)
+        {
+            // Placeholder: member channels are shared by every track on the
+            // output, so the commit assigns them
+            noteChannel = TuningTable::mpeFirstMemberChannel;
+
+            newEvents.push_back (ScheduledEvent {
+                noteStartTime,
+                juce::MidiMessage::pitchWheel (noteChannel, tuningTable.getPitchWheelValue (note.detune)),
+                output,
+                note.sourceId,
+                occurrence });
+        }
+        else if (routing.tuning == Tuning::Output::mts)
+        {
+            // Every note carries its retune; the audio thread sends only the
+            // ones that change what the output's key is tuned to
+            newEvents.push_back (ScheduledEvent {
+                noteStartTime,
+                tuningTable.createNoteTuningChange (note.noteNumber, note.detune),
+                output,
+                note.sourceId,
+                occurrence });
+            newEvents.back().tuningKey = juce::jlimit (0, 127, note.noteNumber);
+            newEvents.back().tuningDetune = note.detune;
+        }
 
         newEvents.push_back (ScheduledEvent {
             noteStartTime,
-            juce::MidiMessage::noteOn (midiChannel, note.noteNumber, static_cast<juce::uint8> (note.velocity)),
-            output });
+            juce::MidiMessage::noteOn (noteChannel, note.noteNumber, static_cast<juce::uint8> (note.velocity)),
+            output,
+            note.sourceId,
+            occurrence });
+
+        // The repeats aren't scheduled: the note-on tells the audio thread to play them
+        if (note.ratchets > 1)
+        {
+            newEvents.back().ratchetHits = note.ratchets;
+            newEvents.back().ratchetGate = note.ratchetGate;
+            newEvents.back().ratchetInterval = note.duration / note.ratchets;
+        }
 
         newEvents.push_back (ScheduledEvent {
             noteEndTime,
-            juce::MidiMessage::noteOff (midiChannel, note.noteNumber),
-            output });
+            juce::MidiMessage::noteOff (noteChannel, note.noteNumber),
+            output,
+            note.sourceId,
+            occurrence });
+
+        ++occurrence;
     }
 
-    insertEventsSorted (newEvents);
+    for (auto& event : newEvents)
+        event.trackIndex = static_cast<int> (trackIndex);
+
+    slice.built = true;
+}
+
+bool TransportEngine::commitTrackEvents (std::vector<TrackSlice>& slices)
+{
+    std::vector<ScheduledEvent> newEvents;
+    size_t total = 0;
+
+    for (const auto& slice : slices)
+        total += slice.events.size();
+
+    newEvents.reserve (total);
+
+    // Occurrences are numbered in slice order, so the result doesn't depend
+    // on which slice finished building first
+    for (auto& slice : slices)
+    {
+        if (! slice.built)
+            continue;
+
+        auto& state = trackStates[slice.trackIndex];
+        state.cachedOutput = slice.routing.output;
+        state.cachedMidiChannel = slice.routing.midiChannel;
+        state.cachedMpe = slice.routing.tuning == Tuning::Output::mpe;
+
+        if (state.cachedMpe)
+            assignMpeChannels (slice);
+
+        for (auto& event : slice.events)
+        {
+            event.occurrence += nextOccurrence;
+            newEvents.push_back (event);
+        }
+
+        nextOccurrence += static_cast<juce::uint32> (slice.notes.size());
+    }
+
+    return insertEventsSorted (newEvents);
+}
+
+void TransportEngine::assignMpeChannels (TrackSlice& slice)
+{
+    // Round-robin over the output's member channels in slice order, so MPE
+    // tracks sharing an output don't land overlapping notes on one channel
+    auto& next = nextMpeChannel[slice.routing.output];
+
+    for (auto& event : slice.events)
+    {
+        auto member = (static_cast<juce::uint32> (next) + event.occurrence) % TuningTable::mpeNumMemberChannels;
+        event.message.setChannel (TuningTable::mpeFirstMemberChannel + static_cast<int> (member));
+    }
+
+    next = static_cast<int> ((next + slice.notes.size()) % TuningTable::mpeNumMemberChannels);
 }
 
 bool TransportEngine::insertEventsSorted (const std::vector<ScheduledEvent>& newEvents)
@@ -130,6 +250,55 @@ void TransportEngine::clearScheduledEvents()
     // they re-read eventCount and readHead after acquiring the lock.
     eventCount.store (0, std::memory_order_release);
     readHead.store (0, std::memory_order_release);
+
+    // Retunes that were never sent mustn't count as the keys' tuning
+    tuningResetRequested.store (true, std::memory_order_release);
+}
+
+int TransportEngine::cancelNoteEvents (const std::vector<juce::uint32>& sourceIds, double fromTime)
+{
+    if (sourceIds.empty())
+        return 0;
+
+    std::lock_guard<std::mutex> lock (eventMutex);
+
+    int head = readHead.load (std::memory_order_acquire);
+    int count = eventCount.load (std::memory_order_acquire);
+
+    // Occurrences whose note-on hasn't been reached yet
+    std::vector<juce::uint32> occurrences;
+
+    for (int i = head; i < count; ++i)
+    {
+        const auto& event = eventBuffer[static_cast<size_t> (i)];
+
+        if (event.timestamp >= fromTime && event.message.isNoteOn() && ! event.isCancelled()
+            && std::find (sourceIds.begin(), sourceIds.end(), event.sourceId) != sourceIds.end())
+            occurrences.push_back (event.occurrence);
+    }
+
+    if (occurrences.empty())
+        return 0;
+
+    std::sort (occurrences.begin(), occurrences.end());
+
+    // A replacement may need the retune a cancelled occurrence would have sent
+    tuningResetRequested.store (true, std::memory_order_release);
+
+    int numCancelled = 0;
+
+    for (int i = head; i < count; ++i)
+    {
+        auto& event = eventBuffer[static_cast<size_t> (i)];
+
+        if (! event.isCancelled() && std::binary_search (occurrences.begin(), occurrences.end(), event.occurrence))
+        {
+            event.cancelled.store (true, std::memory_order_release);
+            ++numCancelled;
+        }
+    }
+
+    return numCancelled;
 }
 
 // === Per-Track Timing Queries ===
@@ -151,6 +320,14 @@ void TransportEngine::markBeatsScheduled (size_t trackIndex, double endBeat)
     trackStates[trackIndex].lastScheduledBeat.store (endBeat);
 }
 
+double TransportEngine::getScheduledEndBeat (size_t trackIndex) const
+{
+    if (trackIndex >= MAX_TRACKS)
+        return 0.0;
+
+    return trackStates[trackIndex].lastScheduledBeat.load();
+}
+
 void TransportEngine::setTrackOutput (size_t trackIndex, juce::MidiOutput* output, int midiChannel)
 {
     if (trackIndex >= MAX_TRACKS)
@@ -160,6 +337,84 @@ void TransportEngine::setTrackOutput (size_t trackIndex, juce::MidiOutput* outpu
     trackStates[trackIndex].cachedMidiChannel = midiChannel;
 }
 
+// === Note Release ===
+
+void TransportEngine::requestReleaseAll()
+{
+    releaseAllRequested.store (true, std::memory_order_release);
+}
+
+// === Mute and Solo ===
+
+void TransportEngine::setTrackMuted (size_t trackIndex, bool shouldBeMuted)
+{
+    if (trackIndex < MAX_TRACKS)
+        trackStates[trackIndex].muted.store (shouldBeMuted, std::memory_order_release);
+}
+
+void TransportEngine::setTrackSoloed (size_t trackIndex, bool shouldBeSoloed)
+{
+    if (trackIndex < MAX_TRACKS)
+        trackStates[trackIndex].soloed.store (shouldBeSoloed, std::memory_order_release);
+}
+
+// === Scenes ===
+
+void TransportEngine::queuePlan (const PlaybackPlan* plan)
+{
+    pendingPlan.store (plan, std::memory_order_release);
+}
+
+const PlaybackPlan* TransportEngine::getActivePlan() const
+{
+    return activePlan.load (std::memory_order_acquire);
+}
+
+const PlaybackPlan* TransportEngine::getPendingPlan() const
+{
+    return pendingPlan.load (std::memory_order_acquire);
+}
+
+void TransportEngine::clearPlans()
+{
+    pendingPlan.store (nullptr);
+    activePlan.store (nullptr);
+}
+
+// === Automation ===
+
+void TransportEngine::setAutomationPlan (size_t trackIndex, const AutomationPlan* plan)
+{
+    jassert (trackIndex < MAX_TRACKS);
+    if (trackIndex < MAX_TRACKS)
+        automationPlans[trackIndex].store (plan, std::memory_order_release);
+}
+
+const AutomationPlan* TransportEngine::getAutomationPlan (size_t trackIndex) const
+{
+    return trackIndex < MAX_TRACKS ? automationPlans[trackIndex].load (std::memory_order_acquire) : nullptr;
+}
+
+void TransportEngine::setAutomationRate (double hz)
+{
+    automationRate.store (juce::jlimit (1.0, 1000.0, hz));
+}
+
+bool TransportEngine::switchPlanIfDue (double time)
+{
+    auto* pending = pendingPlan.load (std::memory_order_acquire);
+
+    if (pending == nullptr || time < pending->startTime)
+        return false;
+
+    // The UI may have queued a different plan meanwhile; then that one waits
+    if (! pendingPlan.compare_exchange_strong (pending, nullptr, std::memory_order_acq_rel))
+        return false;
+
+    activePlan.store (pending, std::memory_order_release);
+    return true;
+}
+
 // === Transport Control ===
 
 void TransportEngine::prepareToPlay (double newSampleRate)
@@ -177,27 +432,39 @@ void TransportEngine::reset()
     {
         trackStates[i].reset();
     }
+
+    nextMpeChannel.clear();
 }
 
 // === Audio Thread Processing ===
 
-void TransportEngine::processBlock (double currentPosition, double bufferDuration, bool isPlaying)
+void TransportEngine::processBlock (double currentPosition, double bufferDuration, bool isPlaying, double tempo)
 {
     // check if transport has just stopped
     if (wasPlaying.load() && ! isPlaying)
     {
+        // Precise note-offs first: many synths ignore the channel mode messages
+        ratchets.clear();
+        activeNotes.releaseAll (outputBatcher);
+
         for (size_t i = 0; i < numActiveTracks.load(); ++i)
         {
             auto& trackState = trackStates[i];
             if (trackState.cachedOutput != nullptr)
             {
-                juce::Logger::writeToLog ("Sending All Notes Off on channel " + juce::String (trackState.cachedMidiChannel));
-                // send note off messages to active channels
-                trackState.cachedOutput->sendMessageNow (juce::MidiMessage::allNotesOff (trackState.cachedMidiChannel));
-                trackState.cachedOutput->sendMessageNow (juce::MidiMessage::allSoundOff (trackState.cachedMidiChannel));
+                // send note off messages to active channels, once per output and channel
+                if (outputBatcher.add (trackState.cachedOutput, juce::MidiMessage::allNotesOff (trackState.cachedMidiChannel)))
+                    juce::Logger::writeToLog ("Sending All Notes Off on channel " + juce::String (trackState.cachedMidiChannel));
+
+                outputBatcher.add (trackState.cachedOutput, juce::MidiMessage::allSoundOff (trackState.cachedMidiChannel));
             }
         }
+        outputBatcher.flush();
         clearScheduledEvents();
+        releaseAllRequested.store (false);
+        resetAutomationOutputs();
+        mtsKeys.clear();
+        tuningResetRequested.store (false);
     }
 
     wasPlaying.store (isPlaying);
@@ -205,6 +472,15 @@ void TransportEngine::processBlock (double currentPosition, double bufferDuratio
     if (! isPlaying)
         return;
 
+    if (tuningResetRequested.exchange (false, std::memory_order_acq_rel))
+        mtsKeys.clear();
+
+    processReleaseRequests (currentPosition);
+
+    // A plan whose bar line has already passed (queued late) starts now
+    switchPlanIfDue (currentPosition);
+    auto audibleTracks = updateAudibleTracks();
+
     double bufferEndTime = currentPosition + bufferDuration;
 
     // Walk the sorted event buffer from readHead, firing every event whose
@@ -214,13 +490,289 @@ void TransportEngine::processBlock (double currentPosition, double bufferDuratio
     int head = readHead.load (std::memory_order_acquire);
     int count = eventCount.load (std::memory_order_acquire);
 
+    auto sendRepeat = [this] (juce::MidiOutput* output, const juce::MidiMessage& message)
+    { sendTracked (output, message); };
+
     while (head < count && eventBuffer[static_cast<size_t> (head)].timestamp <= bufferEndTime)
     {
         const auto& event = eventBuffer[static_cast<size_t> (head)];
-        if (event.output != nullptr)
-            event.output->sendMessageNow (event.message);
+
+        // Repeats due before this event go first, so a note-off never lands ahead of its last hit
+        ratchets.advance (event.timestamp, sendRepeat);
+
+        // Switch scenes exactly at the bar line: events before it use the old plan
+        if (switchPlanIfDue (event.timestamp))
+            audibleTracks = updateAudibleTracks();
+
+        bool audible = event.trackIndex < 0 || (audibleTracks >> event.trackIndex) & 1;
+
+        // A silenced track's note-offs still go through: the note table drops
+        // them unless the note started before the track went quiet. Its
+        // retunes and pitch bends are held back unrecorded, so the next
+        // audible note on the key sends its tuning again
+        if (! event.isCancelled() && (audible || event.message.isNoteOff()))
+        {
+            // A retune counts as the key's tuning only once it is sent
+            if (event.tuningKey < 0)
+                sendTracked (event.output, event.message);
+            else if (mtsKeys.retune (event.output, event.tuningKey, event.tuningDetune))
+                outputBatcher.add (event.output, event.message);
+
+            if (event.message.isNoteOff())
+                ratchets.stopNote (event.sourceId, event.occurrence);
+            else if (event.message.isNoteOn())
+            {
+                if (event.ratchetHits > 1)
+                    startRatchet (event);
+
+                if (event.trackIndex >= 0)
+                    automationOutputs[static_cast<size_t> (event.trackIndex)].notesStarted = true;
+            }
+        }
         ++head;
     }
 
     readHead.store (head, std::memory_order_release);
+    ratchets.advance (bufferEndTime, sendRepeat);
+
+    // One automation sample per block at most, after the block's notes so
+    // poly aftertouch reaches the keys that just started. A jump back (seek,
+    // loop) resamples at once
+    double controlPeriod = 1.0 / automationRate.load (std::memory_order_relaxed);
+    bool jumpedBack = currentPosition < nextAutomationTime - controlPeriod;
+
+    if (currentPosition >= nextAutomationTime || jumpedBack)
+    {
+        renderAutomation (currentPosition, tempo, audibleTracks, jumpedBack);
+        nextAutomationTime = currentPosition + controlPeriod;
+    }
+
+    // One send per output for the whole block
+    outputBatcher.flush();
+}
+
+void TransportEngine::sendTracked (juce::MidiOutput* output, const juce::MidiMessage& message)
+{
+    if (output == nullptr)
+        return;
+
+    if (message.isNoteOn())
+    {
+        // Same key still sounding: end it so the retrigger starts a fresh note
+        if (activeNotes.noteOn (output, message.getChannel(), message.getNoteNumber()))
+            outputBatcher.add (output, juce::MidiMessage::noteOff (message.getChannel(), message.getNoteNumber()));
+    }
+    else if (message.isNoteOff())
+    {
+        if (! activeNotes.noteOff (output, message.getChannel(), message.getNoteNumber()))
+            return;
+    }
+
+    outputBatcher.add (output, message);
+}
+
+void TransportEngine::processReleaseRequests (double currentPosition)
+{
+    if (releaseAllRequested.exchange (false, std::memory_order_acq_rel))
+    {
+        ratchets.clear();
+        activeNotes.releaseAll (outputBatcher);
+
+        // Resend every lane from the new position
+        resetAutomationOutputs();
+        nextAutomationTime = currentPosition;
+
+        // The stale events skipped below may include retunes
+        mtsKeys.clear();
+
+        // After a seek, events before the new position are stale: their
+        // note-offs would be dropped anyway, and their note-ons would all
+        // fire at once
+        int head = readHead.load (std::memory_order_acquire);
+        int count = eventCount.load (std::memory_order_acquire);
+
+        while (head < count && eventBuffer[static_cast<size_t> (head)].timestamp < currentPosition)
+            ++head;
+
+        readHead.store (head, std::memory_order_release);
+    }
+}
+
+juce::uint32 TransportEngine::updateAudibleTracks()
+{
+    auto numTracks = std::min (numActiveTracks.load(), MAX_TRACKS);
+    bool anySoloed = false;
+
+    for (size_t i = 0; i < numTracks; ++i)
+        anySoloed = anySoloed || trackStates[i].soloed.load (std::memory_order_acquire);
+
+    auto* plan = activePlan.load (std::memory_order_acquire);
+    auto planMask = plan != nullptr ? plan->trackMask : PlaybackPlan::allTracks;
+
+    juce::uint32 audibleTracks = 0;
+
+    for (size_t i = 0; i < numTracks; ++i)
+    {
+        auto& state = trackStates[i];
+        bool audible = ((planMask >> i) & 1) != 0
+                       && ! state.muted.load (std::memory_order_acquire)
+                       && (! anySoloed || state.soloed.load (std::memory_order_acquire));
+
+        if (state.wasAudible && ! audible)
+            releaseTrack (i);
+
+        state.wasAudible = audible;
+
+        if (audible)
+            audibleTracks |= juce::uint32 { 1 } << i;
+    }
+
+    return audibleTracks;
+}
+
+void TransportEngine::startRatchet (const ScheduledEvent& noteOn)
+{
+    RatchetTable::Ratchet ratchet;
+    ratchet.output = noteOn.output;
+    ratchet.trackIndex = noteOn.trackIndex;
+    ratchet.sourceId = noteOn.sourceId;
+    ratchet.occurrence = noteOn.occurrence;
+    ratchet.channel = noteOn.message.getChannel();
+    ratchet.noteNumber = noteOn.message.getNoteNumber();
+    ratchet.velocity = noteOn.message.getVelocity();
+    ratchet.startTime = noteOn.timestamp;
+    ratchet.interval = noteOn.ratchetInterval;
+    ratchet.gate = noteOn.ratchetGate;
+    ratchet.hits = noteOn.ratchetHits;
+
+    // Full table: the note plays once, as if it had no ratchet
+    ratchets.start (ratchet);
+}
+
+void TransportEngine::releaseTrack (size_t trackIndex)
+{
+    ratchets.stopTrack (static_cast<int> (trackIndex));
+
+    // Unmuting resends the track's automation
+    automationOutputs[trackIndex].reset (automationOutputs[trackIndex].plan);
+
+    const auto& state = trackStates[trackIndex];
+
+    if (state.cachedOutput == nullptr)
+        return;
+
+    if (state.cachedMpe)
+    {
+        for (int ch = TuningTable::mpeFirstMemberChannel; ch < TuningTable::mpeFirstMemberChannel + TuningTable::mpeNumMemberChannels; ++ch)
+            activeNotes.releaseChannel (state.cachedOutput, ch, outputBatcher);
+    }
+    else
+    {
+        activeNotes.releaseChannel (state.cachedOutput, state.cachedMidiChannel, outputBatcher);
+    }
+}
+
+void TransportEngine::renderAutomation (double time, double tempo, juce::uint32 audibleTracks, bool force)
+{
+    auto numTracks = std::min (numActiveTracks.load(), MAX_TRACKS);
+    double beat = time * tempo / 60.0;
+
+    for (size_t i = 0; i < numTracks; ++i)
+    {
+        auto& out = automationOutputs[i];
+        auto* plan = automationPlans[i].load (std::memory_order_acquire);
+
+        if (plan != out.plan || force)
+            out.reset (plan);
+
+        bool notesStarted = std::exchange (out.notesStarted, false);
+
+        if (plan == nullptr || plan->output == nullptr || plan->loopLengthBeats <= 0.0 || ((audibleTracks >> i) & 1) == 0)
+            continue;
+
+        // Wrapped in whole ticks, as extraction wraps notes, so lanes stay in
+        // phase with them over long runs and loops of any length
+        auto loopTicks = Ticks::fromBeats (plan->loopLengthBeats);
+        if (loopTicks <= 0)
+            continue;
+
+        double loopBeat = Ticks::toBeats (Ticks::wrap (Ticks::fromBeats (beat), loopTicks));
+
+        // MPE member channels carry per-note bends; channel-wide lanes go to the master
+        int channel = plan->mpe ? TuningTable::mpeFirstMemberChannel - 1 : plan->midiChannel;
+
+        for (size_t l = 0; l < std::min (plan->lanes.size(), AutomationPlan::maxLanes); ++l)
+        {
+            const auto& lane = plan->lanes[l];
+
+            if (lane.points.empty())
+                continue;
+
+            float value = Automation::getValueAt (lane.points, lane.mode, loopBeat, plan->loopLengthBeats);
+            bool isPitchBend = lane.target == Automation::Target::pitchBend;
+            int scaled = juce::roundToInt (value * (isPitchBend ? 16383.0f : 127.0f));
+
+            bool newKeys = notesStarted && lane.target == Automation::Target::polyAftertouch;
+
+            if (scaled == out.lastSent[l] && ! newKeys)
+                continue;
+
+            out.lastSent[l] = scaled;
+
+            switch (lane.target)
+            {
+                case Automation::Target::controller:
+                    outputBatcher.add (plan->output, juce::MidiMessage::controllerEvent (channel, lane.controller, scaled));
+                    break;
+                case Automation::Target::pitchBend:
+                    outputBatcher.add (plan->output, juce::MidiMessage::pitchWheel (channel, scaled));
+                    break;
+                case Automation::Target::channelPressure:
+                    outputBatcher.add (plan->output, juce::MidiMessage::channelPressureChange (channel, scaled));
+                    break;
+                case Automation::Target::polyAftertouch:
+                {
+                    // Per note: with MPE that is each member channel's pressure
+                    if (plan->mpe)
+                    {
+                        for (int ch = TuningTable::mpeFirstMemberChannel; ch < TuningTable::mpeFirstMemberChannel + TuningTable::mpeNumMemberChannels; ++ch)
+                        {
+                            bool sounding = false;
+                            activeNotes.forEachActive (plan->output, ch, [&sounding] (int) { sounding = true; });
+
+                            if (sounding)
+                                outputBatcher.add (plan->output, juce::MidiMessage::channelPressureChange (ch, scaled));
+                        }
+                    }
+                    else
+                    {
+                        activeNotes.forEachActive (plan->output, channel, [&] (int noteNumber)
+                                                   { outputBatcher.add (plan->output, juce::MidiMessage::aftertouchChange (channel, noteNumber, scaled)); });
+                    }
+                    break;
+                }
+            }
+        }
+    }
+}
+
+void TransportEngine::resetAutomationOutputs()
+{
+    for (auto& out : automationOutputs)
+    {
+        out.reset (out.plan);
+        out.notesStarted = false;
+    }
+
+    nextAutomationTime = 0.0;
+}
+
+void TransportEngine::setUseRunningStatus (bool shouldUse)
+{
+    outputBatcher.setUseRunningStatus (shouldUse);
+}
+
+const MidiOutputBatcher& TransportEngine::getOutputBatcher() const
+{
+    return outputBatcher;
 }
@@ -9,18 +9,45 @@
     - Audio thread only reads from a lock-free FIFO
     - Each track has independent loop timing (polymetric support)
     - Each track can route to a different MIDI output device
+    - Each block's messages are batched per output and sent in one call
+    - Sounding notes are tracked per output and channel, so stop, seek,
+      tempo change and mute end exactly the notes that are on
+    - Microtonal tuning belongs to the output: MPE member channels are
+      handed out per output, and an MTS retune is skipped only if the
+      output's key was already sent that tuning
+    - Mute and solo are atomic per-track flags applied by the audio thread,
+      so a toggle lands within one block instead of after the lookahead
+    - A ratcheted note is scheduled as one note-on and note-off; the audio
+      thread plays the repeats in between, so ratchets cost no buffer space
+    - Scenes arrive as PlaybackPlans, swapped in atomically at the first
+      event on or after their bar line
+    - Tracks are independent, so their events can be built in parallel;
+      a pass is inserted into the buffer with one sort under one lock
+    - Events remember the note they came from, so an edit during playback
+      can retract just that note's pending events (tombstones the audio
+      thread skips) and schedule replacements
+    - Automation isn't scheduled as events: each track's lanes arrive as an
+      AutomationPlan the audio thread samples once per block, at most at
+      the control rate, sending only values that changed
 
   ==============================================================================
 */
 
 #pragma once
 
+#include "Audio/ActiveNoteTable.h"
+#include "Audio/AutomationPlan.h"
+#include "Audio/MidiOutputBatcher.h"
+#include "Audio/MtsKeyTable.h"
+#include "Audio/PlaybackPlan.h"
+#include "Audio/RatchetTable.h"
 #include "Audio/ScheduledEvent.h"
 #include "Data/Note.h"
 #include <JuceHeader.h>
 #include <array>
 #include <atomic>
 #include <mutex>
+#include <unordered_map>
 
 class TransportEngine
 {
@@ -53,21 +80,45 @@ public:
      * @param trackIndex The track index (0-based)
      * @param notes The MIDI notes to schedule (already converted from sequence)
      * @param loopStartTime The absolute time when this loop iteration starts
-     * @param loopLengthSeconds Duration of this track's loop in seconds
-     * @param output MIDI output device for this track (can be nullptr to skip)
-     * @param midiChannel MIDI channel for this track (1-16)
+     * @param routing Output device (can be nullptr to skip), channel and tuning output for this track
      */
     void scheduleTrack (size_t trackIndex,
                         const std::vector<MidiNote>& notes,
                         double loopStartTime,
-                        juce::MidiOutput* output,
-                        int midiChannel);
+                        const TrackRouting& routing);
+
+    /**
+     * Turn a slice's notes into events, without touching the event buffer.
+     * Slices for different tracks can be built at the same time on
+     * different threads; never build two slices of one track at once.
+     */
+    void buildTrackEvents (TrackSlice& slice);
+
+    /**
+     * Insert the events of built slices in one go (UI thread). Occurrences
+     * are numbered in slice order, so the same slices always give the same
+     * buffer, whatever order they were built in.
+     *
+     * @return false if the buffer would overflow (nothing is inserted)
+     */
+    bool commitTrackEvents (std::vector<TrackSlice>& slices);
 
     /**
      * Clear all scheduled events. Call when stopping playback.
      */
     void clearScheduledEvents();
 
+    /**
+     * Retract the pending occurrences of some notes that start at or after
+     * fromTime (UI thread). Their note-on, note-off and tuning messages are
+     * tombstoned together; occurrences already started keep their note-off.
+     *
+     * @param sourceIds Note::getId() of the notes to retract
+     * @param fromTime Transport time in seconds; leave room for the block in flight
+     * @return The number of events tombstoned
+     */
+    int cancelNoteEvents (const std::vector<juce::uint32>& sourceIds, double fromTime);
+
     // === Per-Track Timing Queries ===
 
     /**
@@ -87,12 +138,78 @@ public:
      */
     void markBeatsScheduled (size_t trackIndex, double endBeat);
 
+    /**
+     * The beat a track has been scheduled up to.
+     */
+    double getScheduledEndBeat (size_t trackIndex) const;
+
     /**
      * Update cached output pointer for a track.
      * Call this before scheduling if the output may have changed.
      */
     void setTrackOutput (size_t trackIndex, juce::MidiOutput* output, int midiChannel);
 
+    // === Note Release (any thread) ===
+
+    /**
+     * End every sounding note at the next block and skip events that are
+     * already late. Call after a seek or tempo change during playback.
+     */
+    void requestReleaseAll();
+
+    // === Mute and Solo (any thread) ===
+
+    /**
+     * Mute or solo a track. The audio thread applies it at the next block:
+     * a silenced track's sounding notes are ended and its pending events
+     * are held back (note-offs still pass), while scheduling carries on so
+     * unmuting is immediate too.
+     */
+    void setTrackMuted (size_t trackIndex, bool shouldBeMuted);
+    void setTrackSoloed (size_t trackIndex, bool shouldBeSoloed);
+
+    // === Scenes ===
+
+    /**
+     * Queue a plan to take over at plan->startTime, replacing any queued
+     * one. The plan must stay alive while it is active or pending (UI thread).
+     */
+    void queuePlan (const PlaybackPlan* plan);
+
+    /**
+     * The plan playing now, or nullptr for every track.
+     */
+    const PlaybackPlan* getActivePlan() const;
+
+    /**
+     * The plan waiting for its start time, or nullptr.
+     */
+    const PlaybackPlan* getPendingPlan() const;
+
+    /**
+     * Drop the active and pending plans: every track plays (UI thread, stopped).
+     */
+    void clearPlans();
+
+    // === Automation ===
+
+    /**
+     * Replace a track's automation, or pass nullptr for none. The plan must
+     * stay alive while the engine holds it (UI thread).
+     */
+    void setAutomationPlan (size_t trackIndex, const AutomationPlan* plan);
+
+    /**
+     * The automation a track is playing, or nullptr.
+     */
+    const AutomationPlan* getAutomationPlan (size_t trackIndex) const;
+
+    /**
+     * How often automation values are sampled, in Hz. Blocks longer than the
+     * period still send at most one value per lane.
+     */
+    void setAutomationRate (double hz);
+
     // === Transport Control ===
 
     /**
@@ -117,8 +234,19 @@ public:
      *
      * @param currentPosition Current transport position in seconds
      * @param bufferDuration Duration of the audio buffer in seconds
+     * @param tempo Beats per minute, to place automation in each track's loop
+     */
+    void processBlock (double currentPosition, double bufferDuration, bool isPlaying, double tempo);
+
+    /**
+     * Send note-offs as zero-velocity note-ons so outputs can use running status.
+     */
+    void setUseRunningStatus (bool shouldUse);
+
+    /**
+     * The batcher, for its message and send-call counters.
      */
-    void processBlock (double currentPosition, double bufferDuration, bool isPlaying);
+    const MidiOutputBatcher& getOutputBatcher() const;
 
 private:
     std::atomic<bool> wasPlaying { false };
@@ -136,6 +264,84 @@ private:
     std::array<PerTrackState, MAX_TRACKS> trackStates;
     std::atomic<size_t> numActiveTracks { 4 };
 
+    // Groups each block's messages per output (audio thread only)
+    MidiOutputBatcher outputBatcher;
+
+    // Sounding notes (audio thread only)
+    ActiveNoteTable activeNotes;
+
+    // MTS tuning each output's keys were sent (audio thread only); any
+    // thread can ask for it to be forgotten at the next block
+    MtsKeyTable mtsKeys;
+    std::atomic<bool> tuningResetRequested { false };
+
+    // Repeats of ratcheted notes that are playing (audio thread only)
+    RatchetTable ratchets;
+
+    // Begin the repeats of a ratcheted note-on that was just sent (audio thread)
+    void startRatchet (const ScheduledEvent& noteOn);
+
+    // Per-track automation; the audio thread picks up a new plan at its next sample
+    std::array<std::atomic<const AutomationPlan*>, MAX_TRACKS> automationPlans {};
+    std::atomic<double> automationRate { 100.0 };
+
+    // What each track's lanes last sent (audio thread only). -1 = nothing yet
+    struct AutomationOutput
+    {
+        const AutomationPlan* plan = nullptr;
+        std::array<int, AutomationPlan::maxLanes> lastSent {};
+        bool notesStarted = false; // Poly aftertouch goes to new keys too
+
+        void reset (const AutomationPlan* newPlan)
+        {
+            plan = newPlan;
+            lastSent.fill (-1);
+        }
+    };
+
+    std::array<AutomationOutput, MAX_TRACKS> automationOutputs;
+    double nextAutomationTime = 0.0;
+
+    // Sample every audible track's lanes at time and send what changed (audio thread)
+    void renderAutomation (double time, double tempo, juce::uint32 audibleTracks, bool force);
+
+    // Forget what automation sent, so the next sample sends everything (audio thread)
+    void resetAutomationOutputs();
+
+    // Scene plans; the audio thread moves pending to active at its start time
+    std::atomic<const PlaybackPlan*> activePlan { nullptr };
+    std::atomic<const PlaybackPlan*> pendingPlan { nullptr };
+
+    // Swap in the pending plan if time has reached it. Returns true if it did (audio thread)
+    bool switchPlanIfDue (double time);
+
+    // Release requests, consumed by the audio thread
+    std::atomic<bool> releaseAllRequested { false };
+
+    static_assert (MAX_TRACKS <= 32, "audible tracks are held as a bit mask");
+
+    // Send one event, keeping the active note table in step (audio thread)
+    void sendTracked (juce::MidiOutput* output, const juce::MidiMessage& message);
+
+    // Handle pending release requests (audio thread)
+    void processReleaseRequests (double currentPosition);
+
+    // Apply the active plan, mute and solo: releases tracks that just went
+    // silent and returns a bit mask of the audible ones (audio thread)
+    juce::uint32 updateAudibleTracks();
+
+    // End the sounding notes of one track (audio thread)
+    void releaseTrack (size_t trackIndex);
+
+    // Numbers each note occurrence as it is scheduled (UI thread only)
+    juce::uint32 nextOccurrence = 1;
+
+    // Next MPE member channel of each output (UI thread only)
+    std::unordered_map<juce::MidiOutput*, int> nextMpeChannel;
+
+    // Give an MPE slice's occurrences their member channels (UI thread)
+    void assignMpeChannels (TrackSlice& slice);
+
     // Timing
     double sampleRate { 44100.0 };
 
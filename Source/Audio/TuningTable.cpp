@@ -0,0 +1,97 @@
+/*
+  ==============================================================================
+
+    TuningTable.cpp
+    Precomputed pitch data for playing microtonal scales over MIDI.
+
+  ==============================================================================
+*/
+
+#include "TuningTable.h"
+
+namespace Tuning
+{
+Output outputFromString (const juce::String& id)
+{
+    if (id == "mpe")
+        return Output::mpe;
+
+    if (id == "mts")
+        return Output::mts;
+
+    return Output::nearest;
+}
+
+juce::String outputToString (Output output)
+{
+    switch (output)
+    {
+        case Output::mpe:
+            return "mpe";
+        case Output::mts:
+            return "mts";
+        case Output::nearest:
+        default:
+            return "nearest";
+    }
+}
+} // namespace Tuning
+
+const TuningTable& TuningTable::getInstance()
+{
+    static TuningTable instance;
+    return instance;
+}
+
+TuningTable::TuningTable()
+{
+    for (size_t i = 0; i <= stepsPerSemitone; ++i)
+    {
+        // Entries span -0.5..+0.5 semitones
+        double detune = static_cast<double> (i) / stepsPerSemitone - 0.5;
+
+        auto bend = 8192.0 + detune / mpePitchBendRange * 8192.0;
+        pitchWheelValues[i] = juce::jlimit (0, 16383, juce::roundToInt (bend));
+
+        // MTS expresses pitch as a semitone plus a 14-bit fraction above it
+        int semitoneOffset = detune < 0.0 ? -1 : 0;
+        auto fraction = juce::jlimit (0, 16383, juce::roundToInt ((detune - semitoneOffset) * 16384.0));
+        mtsFractions[i] = { semitoneOffset, static_cast<juce::uint8> (fraction >> 7), static_cast<juce::uint8> (fraction & 0x7f) };
+    }
+}
+
+size_t TuningTable::indexFor (float detune)
+{
+    auto index = juce::roundToInt ((juce::jlimit (-0.5f, 0.5f, detune) + 0.5f) * stepsPerSemitone);
+    return static_cast<size_t> (juce::jlimit (0, stepsPerSemitone, index));
+}
+
+bool TuningTable::isDetuned (float detune)
+{
+    return std::abs (detune) * stepsPerSemitone >= 0.5f;
+}
+
+int TuningTable::getPitchWheelValue (float detune) const
+{
+    return pitchWheelValues[indexFor (detune)];
+}
+
+juce::MidiMessage TuningTable::createNoteTuningChange (int key, float detune) const
+{
+    const auto& fraction = mtsFractions[indexFor (detune)];
+    auto semitone = juce::jlimit (0, 127, key + fraction.semitoneOffset);
+
+    // Universal real-time SysEx: all devices, MIDI tuning, single note change, program 0, one key
+    const juce::uint8 data[] = { 0x7f, 0x7f, 0x08, 0x02, 0x00, 0x01,
+                                 static_cast<juce::uint8> (juce::jlimit (0, 127, key)),
+                                 static_cast<juce::uint8> (semitone),
+                                 fraction.msb,
+                                 fraction.lsb };
+
+    return juce::MidiMessage::createSysExMessage (data, static_cast<int> (sizeof (data)));
+}
+
+juce::MidiBuffer TuningTable::createMpeZoneLayout()
+{
+    return juce::MPEMessages::setLowerZone (mpeNumMemberChannels, mpePitchBendRange);
+}
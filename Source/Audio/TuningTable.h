@@ -0,0 +1,79 @@
+/*
+  ==============================================================================
+
+    TuningTable.h
+    Precomputed pitch data for playing microtonal scales over MIDI.
+
+    Notes carry a detune offset from their nearest key. Depending on the
+    track's tuning output that offset is realised as an MPE per-note pitch
+    bend or as an MTS single note tuning change. Both encodings are looked
+    up from tables built once, so scheduling only pays for an index.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+namespace Tuning
+{
+enum class Output
+{
+    nearest, // Play the nearest equal-tempered key and ignore detune
+    mpe,     // Rotate notes over MPE member channels with per-note pitch bend
+    mts      // Retune keys with MIDI Tuning Standard real-time SysEx
+};
+
+Output outputFromString (const juce::String& id);
+juce::String outputToString (Output output);
+} // namespace Tuning
+
+class TuningTable
+{
+public:
+    static const TuningTable& getInstance();
+
+    // Per-note pitch bend range announced to MPE receivers (the MPE default)
+    static constexpr int mpePitchBendRange = 48;
+
+    // Lower zone: channel 1 is the manager, 2-16 carry notes
+    static constexpr int mpeFirstMemberChannel = 2;
+    static constexpr int mpeNumMemberChannels = 15;
+
+    // Detune is quantised to a tenth of a cent, well below audible difference
+    static constexpr int stepsPerSemitone = 1000;
+
+    /**
+     * Pitch wheel value (0-16383) that realises the given detune on an MPE member channel.
+     */
+    int getPitchWheelValue (float detune) const;
+
+    /**
+     * MTS single note tuning change retuning key to (key + detune).
+     */
+    juce::MidiMessage createNoteTuningChange (int key, float detune) const;
+
+    /**
+     * Messages that configure an MPE lower zone covering all member channels.
+     */
+    static juce::MidiBuffer createMpeZoneLayout();
+
+    static bool isDetuned (float detune);
+
+private:
+    TuningTable();
+
+    struct MtsFraction
+    {
+        int semitoneOffset; // -1 when the target pitch sits below the key
+        juce::uint8 msb;
+        juce::uint8 lsb;
+    };
+
+    std::array<int, stepsPerSemitone + 1> pitchWheelValues;
+    std::array<MtsFraction, stepsPerSemitone + 1> mtsFractions;
+
+    static size_t indexFor (float detune);
+};
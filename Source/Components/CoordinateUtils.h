@@ -135,7 +135,19 @@ public:
                                scale);
     }
 
-    static juce::Path getTriangleAtPoint (Note n,
+    // Bounding box of the note triangle: the left edge spans the full step
+    // height and the tip sits at the middle of the right edge
+    static juce::Rectangle<float> getTriangleBoundsAtPoint (const Note& n,
+                                                            float screenWidth,
+                                                            float screenHeight,
+                                                            const Timeline& timeline,
+                                                            const Scale& scale)
+    {
+        auto point = musicToScreen (n, screenWidth, screenHeight, timeline, scale);
+        return { point.x, point.y, getStepWidthAtSmallestSize (screenWidth, timeline), getStepHeight (screenHeight) };
+    }
+
+    static juce::Path getTriangleAtPoint (const Note& n,
                                           float screenWidth,
                                           float screenHeight,
                                           const Timeline& timeline,
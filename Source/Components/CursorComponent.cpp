@@ -71,10 +71,27 @@ void CursorComponent::paint (juce::Graphics& g)
     {
         g.setColour (yankBlend > 0.0f ? flashFill : AppColours::getSelectionColour (cursor.getMode()));
 
-        for (const auto& pos : cursor.getVisualSelectionPositions())
+        const auto& timeline = cursor.getCurrentTimeline();
+        const auto& scale = cursor.getCurrentScale();
+        float stepHeight = CoordinateUtils::getStepHeight (height);
+
+        // One strip per scale degree in each range, so rows between scale
+        // degrees stay unselected
+        for (const auto& range : cursor.getVisualSelectionRanges())
         {
-            auto selection = CoordinateUtils::getRectAtPosition (pos, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale());
-            g.fillRect (selection);
+            float left = CoordinateUtils::timeToScreenX (range.earliest.value, width, timeline);
+            float right = CoordinateUtils::timeToScreenX (range.getEndTime(), width, timeline);
+            Degree degree = range.lowest;
+
+            while (Division::isLessOrEqual (degree.value, range.highest.value))
+            {
+                g.fillRect (juce::Rectangle<float> (left, CoordinateUtils::degreeToScreenY (degree.value, height), right - left, stepHeight));
+
+                Degree next = scale.getHigher (degree, false);
+                if (next.value <= degree.value)
+                    break;
+                degree = next;
+            }
         }
 
         g.setColour (yankBlend > 0.0f ? flashOutline : AppColours::getCursorColour (cursor.getMode()));
@@ -82,9 +99,29 @@ void CursorComponent::paint (juce::Graphics& g)
     }
 }
 
+void CursorComponent::update()
+{
+    // The flash covers the whole selection, so repaint everything while it
+    // fades and once more afterwards to clear it
+    bool yankFlashActive = yankFlashStartMs >= 0.0;
+    if (yankFlashActive || yankFlashWasActive)
+    {
+        yankFlashWasActive = yankFlashActive;
+        repaint();
+        return;
+    }
+
+    if (cursor.isInsertMode())
+    {
+        auto rect = CoordinateUtils::getRectAtPoint (cursor, static_cast<float> (getWidth()), static_cast<float> (getHeight()), cursor.getCurrentTimeline(), cursor.getCurrentScale());
+        repaint (rect.expanded (2.0f).getSmallestIntegerContainer());
+    }
+}
+
 void CursorComponent::triggerYankFlash()
 {
     yankFlashStartMs = juce::Time::getMillisecondCounterHiRes();
+    repaint();
 }
 
 void CursorComponent::resized()
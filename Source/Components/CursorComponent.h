@@ -17,12 +17,15 @@ public:
 
     void paint (juce::Graphics&) override;
     void resized() override;
+    // Called once per frame: only the blinking insert cursor and an active
+    // yank flash are animated, everything else repaints on demand
     void update();
     void triggerYankFlash();
 
 private:
     const Cursor& cursor;
     double yankFlashStartMs = -1.0;
+    bool yankFlashWasActive = false;
     static constexpr double yankFlashDurationMs = 500.0;
 
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (CursorComponent)
@@ -0,0 +1,113 @@
+#include "Components/Generators/GeneratorMenuManager.h"
+#include "Components/Modifiers/ModifierComponentFactory.h"
+#include "Components/Settings/PaginatedSettingsComponent.h"
+#include "Data/GeneratorRegistry.h"
+#include "Data/MenuNode.h"
+#include <functional>
+#include <memory>
+
+GeneratorMenuManager::GeneratorMenuManager (Cursor& c,
+                                            std::function<void (const juce::String&, int i)> s)
+    : cursor (c), showMessage (s)
+{
+    buildMenu();
+}
+
+GeneratorMenuManager::~GeneratorMenuManager()
+{
+}
+
+MenuNode* GeneratorMenuManager::getMenuNodeRoot()
+{
+    return menuRoot.get();
+}
+
+std::function<void()> GeneratorMenuManager::createParametersCallback (const juce::Identifier& type, MenuNode* node)
+{
+    return [this, type, node]()
+    {
+        auto* def = GeneratorRegistry::getInstance().getDefinition (type);
+        if (def == nullptr)
+            return;
+
+        // A generator playing live on the sequence is edited in place, so changes are heard
+        auto live = cursor.getSelectedSequence().getGeneratorState();
+        auto state = live.hasType (type) ? live : generatorStates[type];
+
+        auto widgets = ModifierComponentFactory::createWidgets (def->params, state);
+        node->setComponent (std::make_unique<PaginatedSettingsComponent> (std::move (widgets), def->description));
+    };
+}
+
+std::function<void()> GeneratorMenuManager::createWriteCallback (const juce::Identifier& type)
+{
+    return [this, type]()
+    {
+        auto numNotes = cursor.writeGeneratedNotes (generatorStates[type]);
+        showMessage ("Generated " + juce::String (numNotes) + (numNotes == 1 ? " note" : " notes"), 2000);
+    };
+}
+
+std::function<void()> GeneratorMenuManager::createPlayLiveCallback (const juce::Identifier& type)
+{
+    return [this, type]()
+    {
+        auto& seq = cursor.getSelectedSequence();
+        auto live = seq.getGeneratorState();
+
+        // Carry over edits made while it was playing
+        if (live.hasType (type))
+            generatorStates[type] = live.createCopy();
+
+        seq.setGenerator (generatorStates[type], cursor.getUndoManager());
+        showMessage ("Generating live", 1500);
+    };
+}
+
+void GeneratorMenuManager::buildMenu()
+{
+    menuRoot = std::make_unique<MenuNode> ("Generators");
+
+    auto& registry = GeneratorRegistry::getInstance();
+
+    for (auto generatorType : registry.getRegisteredTypes())
+    {
+        auto def = registry.getDefinition (generatorType);
+        if (! def)
+            continue;
+
+        generatorStates[generatorType] = registry.createDefaultState (generatorType);
+
+        auto childNode = std::make_unique<MenuNode> (
+            def->displayName,
+            def->getNavShortcut());
+
+        childNode->tag = generatorType.toString();
+
+        auto parametersNode = std::make_unique<MenuNode> ("Parameters", juce::KeyPress ('p'));
+        parametersNode->onEnter = createParametersCallback (generatorType, parametersNode.get());
+        childNode->addChild (std::move (parametersNode));
+
+        auto writeNode = std::make_unique<MenuNode> ("Write Notes", juce::KeyPress ('w'));
+        writeNode->onAction = createWriteCallback (generatorType);
+        childNode->addChild (std::move (writeNode));
+
+        auto playLiveNode = std::make_unique<MenuNode> ("Play Live", juce::KeyPress ('l'));
+        playLiveNode->onAction = createPlayLiveCallback (generatorType);
+        childNode->addChild (std::move (playLiveNode));
+
+        menuRoot->addChild (std::move (childNode));
+    }
+
+    auto stopNode = std::make_unique<MenuNode> ("Stop Live Generator", juce::KeyPress ('x'));
+    stopNode->onAction = [this]()
+    {
+        auto& seq = cursor.getSelectedSequence();
+        if (! seq.isGenerative())
+            return;
+
+        seq.clearGenerator (cursor.getUndoManager());
+        showMessage ("Generator stopped", 1500);
+    };
+    menuRoot->addChild (std::move (stopNode));
+}
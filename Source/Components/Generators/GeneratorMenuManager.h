@@ -0,0 +1,31 @@
+#pragma once
+
+#include "Data/Cursor.h"
+#include "Data/MenuNode.h"
+#include <map>
+#include <memory>
+
+class GeneratorMenuManager
+{
+public:
+    GeneratorMenuManager (Cursor& cursor,
+                          std::function<void (const juce::String&, int i)> showMessage);
+    ~GeneratorMenuManager();
+
+    MenuNode* getMenuNodeRoot();
+
+private:
+    Cursor& cursor;
+    std::function<void (const juce::String&, int i)> showMessage;
+
+    std::unique_ptr<MenuNode> menuRoot;
+
+    // Each generator's parameters, kept between visits to the menu
+    std::map<juce::Identifier, juce::ValueTree> generatorStates;
+
+    std::function<void()> createParametersCallback (const juce::Identifier& type, MenuNode* node);
+    std::function<void()> createWriteCallback (const juce::Identifier& type);
+    std::function<void()> createPlayLiveCallback (const juce::Identifier& type);
+
+    void buildMenu();
+};
@@ -1,19 +1,26 @@
 #include "MainComponent.h"
+#include "AppColours.h"
+#include "Components/Generators/GeneratorMenuManager.h"
 #include "Components/MidlineComponent.h"
 #include "Components/Modifiers/ModifierMenuManager.h"
 #include "Components/Settings/MidiSettingsSelectionFactory.h"
 #include "Components/ShortcutInfoComponent.h"
 #include "Data/AppSettings.h"
 #include "Data/Cursor.h"
+#include "Data/GrooveRegistry.h"
 #include "Data/MenuNode.h"
+#include "Data/ModifierApplicator.h"
+#include "Data/ScaleRegistry.h"
 #include "Data/Selection.h"
 #include "juce_core/juce_core.h"
+#include <cmath>
 #include <memory>
+#include <random>
 #include <utility>
 
 //==============================================================================
 MainComponent::MainComponent() : cursor (composition),
-                                 sequenceComponent (cursor, transport),
+                                 sequenceComponent (cursor, transport, composition.getState()),
                                  cursorComponent (cursor),
                                  midlineComponent (cursor),
                                  beatLegendComponent (cursor),
@@ -23,19 +30,38 @@ MainComponent::MainComponent() : cursor (composition),
                                                       { contextualMenuComponent.showMessage (message, timeout); },
                                                       [this]()
                                                       { contextualMenuComponent.navigateBack(); }),
-                                 sequenceSettngsManager (cursor, midiOutputManager)
+                                 generatorMenuManager (cursor, [this] (juce::String message, int timeout)
+                                                       { contextualMenuComponent.showMessage (message, timeout); }),
+                                 sequenceSettngsManager (cursor, midiOutputManager),
+                                 vBlankAttachment (this, [this]()
+                                                   { update(); })
 
 {
     AppSettings::getInstance().initialise ("Modality");
 
+    cursor.getUndoHistory().setLimits (AppSettings::getInstance().getUndoMaxTransactions(),
+                                       AppSettings::getInstance().getUndoMaxKilobytes());
+
+    // User scales and grooves are registered before any menu lists them
+    ScaleRegistry::getInstance().loadScalaDirectory (AppSettings::getInstance().getUserScalesDirectory());
+    GrooveRegistry::getInstance().loadMidiDirectory (AppSettings::getInstance().getUserGroovesDirectory());
+
+    // The default sequences compiled their grooves before the templates existed
+    for (auto& seq : composition.getSequences())
+        seq->getGroove().compile (seq->getLengthBeats());
+
     // Make sure you set the size of the component after
     // you add any child components.
     setSize (AppSettings::getInstance().getLastWindowWidth(), AppSettings::getInstance().getLastWindowHeight());
 
     setupKeyboardShortcuts();
 
-    setFramesPerSecond (60); // This sets the frequency of the update calls.
+    setOpaque (true);
     setWantsKeyboardFocus (true);
+    pendingInputEvents.reserve (MidiInputManager::fifoCapacity);
+
+    composition.addChangeListener (this);
+    cursor.getUndoHistory().addChangeListener (this);
     addAndMakeVisible (midlineComponent);
     addAndMakeVisible (pitchLegendComponent);
     addAndMakeVisible (beatLegendComponent);
@@ -44,6 +70,19 @@ MainComponent::MainComponent() : cursor (composition),
     addAndMakeVisible (statusBarComponent);
     addAndMakeVisible (sequenceSelectionComponent);
 
+#if MODALITY_OPENGL
+    if (AppSettings::getInstance().getUseOpenGLRenderer())
+    {
+        gridRenderer.onAvailabilityChanged = [this]()
+        {
+            sequenceComponent.invalidateStaticLayer();
+            repaint();
+        };
+        sequenceComponent.setGridRenderer (&gridRenderer);
+        gridRenderer.attachTo (*this, AppColours::background);
+    }
+#endif
+
     // Initialise audio and register Transport as the audio callback
     deviceManager.initialise (0, 2, nullptr, true);
     deviceManager.addAudioCallback (&transport);
@@ -67,6 +106,13 @@ MainComponent::MainComponent() : cursor (composition),
         }
     }
 
+    updateMidiClockOutputs();
+    sequenceSettngsManager.onMuteSoloChanged = [this]()
+    { syncTrackMuteSolo(); };
+    transport.setUseRunningStatus (AppSettings::getInstance().getMidiRunningStatus());
+    transport.setAutomationRate (AppSettings::getInstance().getAutomationRate());
+    setFollowMidiClock (AppSettings::getInstance().getFollowMidiClock());
+
     // Make sure all children components have size set
     resized();
 
@@ -101,20 +147,59 @@ MainComponent::MainComponent() : cursor (composition),
         AppSettings::getInstance().setDefaultMidiChannel (s);
     };
 
-    auto midiSettingsNode = MidiSettingsSelectionFactory::createMenuNode (midiOutputManager, initialMidiOutDevice, initialMidiChannel, onChangeMidiOut, onChangeMidiChannel);
+    auto initialMidiClock = AppSettings::getInstance().getSendMidiClock() ? "1" : "0";
+    auto onChangeMidiClock = [this] (const String& s)
+    {
+        AppSettings::getInstance().setSendMidiClock (s == "1");
+        updateMidiClockOutputs();
+    };
+
+    auto midiSettingsNode = MidiSettingsSelectionFactory::createMenuNode (midiOutputManager, initialMidiOutDevice, initialMidiChannel, onChangeMidiOut, onChangeMidiChannel, initialMidiClock, onChangeMidiClock);
+
+    auto onChangeMidiIn = [this] (const String& s)
+    {
+        AppSettings::getInstance().setMidiInputDevice (s);
+
+        // Reopen on the new device if the input is in use
+        if (midiInputManager.isOpen())
+            midiInputManager.closeDevice();
+
+        updateMidiInput();
+    };
+    auto onChangeClockSource = [this] (const String& s)
+    {
+        AppSettings::getInstance().setFollowMidiClock (s == "1");
+        setFollowMidiClock (s == "1");
+    };
+
+    auto initialClockSource = AppSettings::getInstance().getFollowMidiClock() ? "1" : "0";
+    auto midiInputNode = MidiSettingsSelectionFactory::createInputMenuNode (midiInputManager, AppSettings::getInstance().getMidiInputDevice(), initialClockSource, onChangeMidiIn, onChangeClockSource);
 
     // Add children and receive the raw pointer to them (to further assign children to these) - the original unq ptr has moved!
     [[maybe_unused]] MenuNode* tempoNodePtr = globalSettingsMenuRoot->addChild (std::move (tempoNode));
     [[maybe_unused]] MenuNode* deviceNodePtr = globalSettingsMenuRoot->addChild (std::move (midiSettingsNode));
+    [[maybe_unused]] MenuNode* inputNodePtr = globalSettingsMenuRoot->addChild (std::move (midiInputNode));
 }
 
 MainComponent::~MainComponent()
 {
+#if MODALITY_OPENGL
+    // Stop the render thread before any component it paints goes away
+    gridRenderer.detach();
+#endif
+
+    composition.removeChangeListener (this);
+    cursor.getUndoHistory().removeChangeListener (this);
+
     // Remove audio callback before destroying transport
     deviceManager.removeAudioCallback (&transport);
+    transport.setExternalTimebase (nullptr);
 
     stop();
 
+    // The clock thread must be done with the outputs before they close
+    midiClockGenerator.setOutputs ({});
+
     // Close all MIDI outputs
     midiOutputManager.closeAll();
 
@@ -124,16 +209,61 @@ MainComponent::~MainComponent()
 //==============================================================================
 void MainComponent::update()
 {
-    // This function is called at the frequency specified by the setFramesPerSecond() call
-    // in the constructor. You can use it to update counters, animate values, etc.
+    if (! contextualMenuComponent.isVisible() && ! hasKeyboardFocus (false))
+    {
+        grabKeyboardFocus();
+    }
+
+    // Get the current position from transport (in seconds)
+    sequenceComponent.setCurrentPlayheadTime (transport.getCurrentPosition());
     sequenceComponent.update();
+    cursorComponent.update();
 
     // Check if any tracks need their next loop scheduled (UI thread responsibility)
     // Each track has independent timing, so we check each one separately
+    // Mute and solo also change through undo and file loads; checking every frame is cheap
+    syncTrackMuteSolo();
+    syncAutomation();
+
     if (transport.isPlaying())
     {
+        propagateLiveEdits();
+        advanceSong();
         checkAndScheduleTracks();
     }
+
+    auto* activePlan = transport.getActivePlaybackPlan();
+    auto* pendingPlan = transport.getPendingPlaybackPlan();
+    playbackPlans.collectGarbage (activePlan, pendingPlan);
+
+    automationPlans.collectGarbage ([this] (const AutomationPlan* plan)
+                                    {
+                                        for (size_t i = 0; i < TransportEngine::MAX_TRACKS; ++i)
+                                            if (transport.getAutomationPlan (i) == plan)
+                                                return true;
+                                        return false; });
+
+    auto planName = [this] (const PlaybackPlan* plan) -> juce::String
+    {
+        if (plan == nullptr || plan->sceneIndex < 0 || plan->sceneIndex >= composition.getNumScenes())
+            return "all";
+        return composition.getScene (plan->sceneIndex).getName();
+    };
+
+    juce::String sceneText;
+    if (activePlan != nullptr || pendingPlan != nullptr || songMode)
+    {
+        sceneText = (songMode ? "song: " : "") + planName (activePlan);
+        if (pendingPlan != nullptr)
+            sceneText << " > " << planName (pendingPlan);
+    }
+
+    if (trigContext.fill)
+        sceneText << (sceneText.isEmpty() ? "fill" : " fill");
+    statusBarComponent.setSceneText (sceneText);
+
+    followMidiClock();
+    recordMidiInput();
 }
 
 void MainComponent::checkAndScheduleTracks()
@@ -141,28 +271,212 @@ void MainComponent::checkAndScheduleTracks()
     size_t numTracks = composition.getSequences().size();
     double currentBeat = transport.getCurrentBeat();
 
+    std::vector<ScheduleRequest> requests;
+
     for (size_t i = 0; i < numTracks; ++i)
     {
         if (transport.trackNeedsBeatScheduling (i, currentBeat))
         {
-            scheduleTrackBeats (i, currentBeat);
+            // Carry on from where the last window ended, so windows stay back to back
+            double startBeat = transport.getScheduledEndBeat (i);
+            if (currentBeat - startBeat > maxCatchUpBeats)
+                startBeat = currentBeat;
+
+            requests.push_back ({ i, startBeat, startBeat + TransportEngine::LOOKAHEAD_BEATS, nullptr });
         }
     }
+
+    if (! requests.empty())
+        scheduleLookahead (requests);
 }
 
-//==============================================================================
-void MainComponent::paint (juce::Graphics& g)
+void MainComponent::syncTrackMuteSolo()
 {
-    if (! contextualMenuComponent.isVisible())
+    const auto& sequences = composition.getSequences();
+
+    for (size_t i = 0; i < sequences.size() && i < TransportEngine::MAX_TRACKS; ++i)
     {
-        grabKeyboardFocus();
+        if (! sequences[i])
+            continue;
+
+        transport.setTrackMuted (i, ! sequences[i]->isEnabled() || sequences[i]->isMuted());
+        transport.setTrackSoloed (i, sequences[i]->isSoloed());
+    }
+}
+
+void MainComponent::syncAutomation()
+{
+    const auto& sequences = composition.getSequences();
+
+    for (size_t i = 0; i < TransportEngine::MAX_TRACKS; ++i)
+    {
+        auto& synced = automationSync[i];
+        const Sequence* seq = i < sequences.size() ? sequences[i].get() : nullptr;
+
+        if (seq == nullptr)
+        {
+            if (synced.sequence != nullptr)
+                transport.setAutomationPlan (i, nullptr);
+
+            synced = {};
+            continue;
+        }
+
+        auto* output = midiOutputManager.getOutput (seq->getMidiOutputId());
+        if (output == nullptr)
+            output = midiOutputManager.getDefaultOutput();
+
+        // Length, channel and tuning output live in the settings revision
+        if (synced.sequence == seq && synced.output == output
+            && synced.automationRevision == seq->getAutomationRevision()
+            && synced.settingsRevision == seq->getSettingsRevision())
+            continue;
+
+        synced = { seq, output, seq->getAutomationRevision(), seq->getSettingsRevision() };
+
+        auto plan = compileAutomationPlan (*seq, output);
+        transport.setAutomationPlan (i, plan.lanes.empty() ? nullptr : automationPlans.create (std::move (plan)));
+    }
+}
+
+AutomationPlan MainComponent::compileAutomationPlan (const Sequence& seq, juce::MidiOutput* output) const
+{
+    AutomationPlan plan;
+    plan.output = output;
+    plan.midiChannel = seq.getMidiChannel();
+    plan.mpe = Tuning::outputFromString (seq.getTuningOutput()) == Tuning::Output::mpe;
+    plan.loopLengthBeats = seq.getLengthBeats();
+
+    for (int i = 0; i < seq.getNumAutomationLanes() && plan.lanes.size() < AutomationPlan::maxLanes; ++i)
+    {
+        auto lane = seq.getAutomationLane (i);
+        auto points = lane.getPoints();
+
+        // Lanes without points send nothing
+        if (points.empty())
+            continue;
+
+        plan.lanes.push_back ({ lane.getTarget(), lane.getMode(), lane.getController(), std::move (points) });
+    }
+
+    return plan;
+}
+
+PlaybackPlan MainComponent::compileScenePlan (int sceneIndex, double startBeat) const
+{
+    PlaybackPlan plan;
+    plan.startBeat = startBeat;
+    plan.startTime = transport.beatsToSeconds (startBeat);
+
+    if (sceneIndex >= 0 && sceneIndex < composition.getNumScenes())
+    {
+        auto scene = composition.getScene (sceneIndex);
+        plan.trackMask = scene.getTrackMask();
+        plan.lengthBeats = scene.getLengthBeats();
+        plan.sceneIndex = sceneIndex;
+    }
+
+    return plan;
+}
+
+void MainComponent::queueScene (int sceneIndex)
+{
+    double startBeat = 0.0;
+
+    if (transport.isPlaying())
+    {
+        // The next bar line still ahead of the events in flight
+        double beat = transport.secondsToBeats (transport.getCurrentPosition() + liveEditMarginSeconds);
+        startBeat = std::ceil (beat / Scene::beatsPerBar) * Scene::beatsPerBar;
     }
+
+    transport.queuePlaybackPlan (playbackPlans.create (compileScenePlan (sceneIndex, startBeat)));
+}
+
+void MainComponent::advanceSong()
+{
+    int numScenes = composition.getNumScenes();
+
+    if (! songMode || numScenes == 0 || transport.getPendingPlaybackPlan() != nullptr)
+        return;
+
+    auto* active = transport.getActivePlaybackPlan();
+
+    if (active == nullptr || active->sceneIndex < 0 || active->lengthBeats <= 0.0)
+        return;
+
+    // Compiled a whole scene ahead, so the swap at the bar line is all that's left
+    int next = (active->sceneIndex + 1) % numScenes;
+    transport.queuePlaybackPlan (playbackPlans.create (compileScenePlan (next, active->startBeat + active->lengthBeats)));
+}
+
+void MainComponent::rebuildScenesMenu()
+{
+    scenesMenuRoot = std::make_unique<MenuNode> ("Scenes");
+
+    for (int i = 0; i < composition.getNumScenes() && i < 9; ++i)
+    {
+        auto scene = composition.getScene (i);
+        auto title = scene.getName() + " (" + juce::String (scene.getLengthBars()) + " bars)";
+        auto sceneNode = std::make_unique<MenuNode> (title, juce::KeyPress ('1' + i));
+        sceneNode->tag = "scene" + juce::String (i);
+        sceneNode->onAction = [this, i]()
+        { queueScene (i); };
+        scenesMenuRoot->addChild (std::move (sceneNode));
+    }
+
+    auto allNode = std::make_unique<MenuNode> ("All tracks", juce::KeyPress ('a'));
+    allNode->onAction = [this]()
+    { queueScene (-1); };
+    scenesMenuRoot->addChild (std::move (allNode));
+
+    // A new scene from the tracks playing now
+    auto captureNode = std::make_unique<MenuNode> ("Capture scene", juce::KeyPress ('c'));
+    captureNode->onAction = [this]()
+    {
+        juce::uint32 mask = 0;
+        const auto& sequences = composition.getSequences();
+
+        for (size_t i = 0; i < sequences.size() && i < 32; ++i)
+            if (sequences[i] && sequences[i]->isEnabled() && ! sequences[i]->isMuted())
+                mask |= juce::uint32 { 1 } << i;
+
+        cursor.getUndoHistory().beginTransaction ("captureScene");
+        composition.addScene (mask, &cursor.getUndoHistory());
+    };
+    scenesMenuRoot->addChild (std::move (captureNode));
+
+    auto songNode = std::make_unique<MenuNode> ("Song mode", juce::KeyPress ('s'));
+    songNode->tag = "song";
+    songNode->onAction = [this]()
+    { songMode = ! songMode; };
+    scenesMenuRoot->addChild (std::move (songNode));
+
+    // Fill and Not Fill trig conditions follow this from the next scheduled notes
+    auto fillNode = std::make_unique<MenuNode> ("Fill", juce::KeyPress ('f'));
+    fillNode->tag = "fill";
+    fillNode->onAction = [this]()
+    { trigContext.fill = ! trigContext.fill; };
+    scenesMenuRoot->addChild (std::move (fillNode));
+}
+
+//==============================================================================
+void MainComponent::paint (juce::Graphics& g)
+{
+#if MODALITY_OPENGL
+    // The GL renderer clears the background underneath the component layer
+    if (gridRenderer.isActive())
+        return;
+#endif
+
     // (Our component is opaque, so we must completely fill the background with a solid colour)
-    g.fillAll (juce::Colour (255, 253, 240));
+    g.fillAll (AppColours::background);
+}
 
-    // Get the current position from transport (in seconds)
-    double currentPosition = transport.getCurrentPosition();
-    sequenceComponent.setCurrentPlayheadTime (currentPosition);
+void MainComponent::changeListenerCallback ([[maybe_unused]] juce::ChangeBroadcaster* source)
+{
+    // The composition's dirty flag or the undo history changed
+    statusBarComponent.repaint();
 }
 
 void MainComponent::resized()
@@ -201,71 +515,272 @@ void MainComponent::start()
     // Set up track count based on number of sequences
     transport.setNumTracks (composition.getSequences().size());
 
-    // Schedule initial beats for all tracks (0-2 beats)
-    size_t numTracks = composition.getSequences().size();
-    for (size_t i = 0; i < numTracks; ++i)
+    // MPE receivers need the zone layout before the first per-note pitch bend arrives
+    for (const auto& seq : composition.getSequences())
+    {
+        if (seq && Tuning::outputFromString (seq->getTuningOutput()) == Tuning::Output::mpe)
+        {
+            if (auto* output = midiOutputManager.getOutput (seq->getMidiOutputId()))
+                output->sendBlockOfMessagesNow (TuningTable::createMpeZoneLayout());
+        }
+    }
+
+    // Following a clock that continued mid-song starts where it is now
+    double startBeat = 0.0;
+    if (transport.isFollowingExternalTimebase())
+    {
+        auto followed = clockFollower.getTimebase().read();
+        transport.setTempo (followed.tempo);
+        startBeat = juce::jmax (0.0, followed.getBeatAt (juce::Time::getMillisecondCounterHiRes()));
+        transport.setPosition (transport.beatsToSeconds (startBeat));
+    }
+
+    syncTrackMuteSolo();
+
+    // Trig conditions count loop passes from here
+    trigContext.originBeat = startBeat;
+    for (auto& seq : composition.getSequences())
+        seq->lastConditionPassed = true;
+
+    for (size_t i = 0; i < liveEdits.size(); ++i)
     {
-        scheduleTrackBeats (i, 0.0);
+        liveEdits[i].scheduledRevisions.clear();
+
+        if (i < composition.getSequences().size())
+        {
+            liveEdits[i].notesRevision = composition.getSequence (i).getNotesRevision();
+            liveEdits[i].settingsRevision = composition.getSequence (i).getSettingsRevision();
+            liveEdits[i].generatorRevision = composition.getSequence (i).getGeneratorRevision();
+        }
     }
 
+    // Schedule initial beats for all tracks
+    std::vector<ScheduleRequest> requests;
+    for (size_t i = 0; i < composition.getSequences().size(); ++i)
+        requests.push_back ({ i, startBeat, startBeat + TransportEngine::LOOKAHEAD_BEATS, nullptr });
+
+    scheduleLookahead (requests);
+
     transport.start();
     juce::Logger::writeToLog ("Transport Started at " + juce::String (transport.getTempo()) + " BPM");
 }
 
-void MainComponent::scheduleTrackBeats (size_t trackIndex, double currentBeat)
+void MainComponent::scheduleLookahead (const std::vector<ScheduleRequest>& requests)
 {
-    auto& seq = cursor.getSequence (trackIndex);
+    auto scheduled = scheduleTracks (requests);
 
-    // Solo logic: if any sequence is soloed, only soloed sequences play
-    const auto& sequences = composition.getSequences();
-    bool anySoloed = std::any_of (sequences.begin(), sequences.end(), [] (const auto& s)
-                                  { return s && s->isSoloed(); });
+    for (size_t i = 0; i < requests.size(); ++i)
+    {
+        // Mark beats as scheduled
+        if (scheduled[i])
+            transport.markBeatsScheduled (requests[i].trackIndex, requests[i].endBeat);
+    }
+}
 
-    if (anySoloed && ! seq.isSoloed())
-        return;
+juce::uint32 MainComponent::getSliceSeed (juce::uint32 seed, size_t trackIndex, double startBeat)
+{
+    auto beatKey = static_cast<juce::uint64> (std::llround (startBeat * 960.0));
+    std::seed_seq sequence { seed,
+                             static_cast<juce::uint32> (trackIndex),
+                             static_cast<juce::uint32> (beatKey),
+                             static_cast<juce::uint32> (beatKey >> 32) };
+    juce::uint32 sliceSeed = 0;
+    sequence.generate (&sliceSeed, &sliceSeed + 1);
+    return sliceSeed;
+}
 
-    // Skip disabled or muted tracks
-    if (! seq.isEnabled() || seq.isMuted())
-        return;
+std::vector<bool> MainComponent::scheduleTracks (const std::vector<ScheduleRequest>& requests)
+{
+    std::vector<bool> scheduled (requests.size(), false);
+    std::vector<TrackSlice> slices (requests.size());
 
-    // Get the MIDI output for this track
-    juce::MidiOutput* output = midiOutputManager.getOutput (seq.getMidiOutputId());
-    if (output == nullptr)
+    double tempo = transport.getTempo();
+    auto seed = composition.getSeed();
+
+    // Routing is resolved here: the output manager belongs to this thread
+    for (size_t i = 0; i < requests.size(); ++i)
     {
-        // Fall back to default output if specified output not available
-        output = midiOutputManager.getDefaultOutput();
+        // Muted, soloed and disabled tracks are still scheduled: the audio thread
+        // decides what is heard, so toggles apply within one block
+        const auto& request = requests[i];
+        auto& seq = cursor.getSequence (request.trackIndex);
+
+        // Get the MIDI output for this track
+        juce::MidiOutput* output = midiOutputManager.getOutput (seq.getMidiOutputId());
+        if (output == nullptr)
+        {
+            // Fall back to default output if specified output not available
+            output = midiOutputManager.getDefaultOutput();
+        }
+
+        // No output available: the track is skipped
+        scheduled[i] = output != nullptr;
+
+        auto& slice = slices[i];
+        slice.trackIndex = request.trackIndex;
+        slice.loopStartTime = transport.beatsToSeconds (request.startBeat);
+        slice.routing.output = output;
+        slice.routing.midiChannel = seq.getMidiChannel();
+        slice.routing.tuning = Tuning::outputFromString (seq.getTuningOutput());
     }
 
-    if (output == nullptr)
+    // Notes each pass looked at, whether or not they play
+    std::vector<std::vector<const Note*>> considered (requests.size());
+
+    // Tracks don't share notes or engine state, so each can be extracted and built
+    // on its own thread. Only the random modifiers are shared, and they draw from
+    // a generator per thread, reseeded per slice when the composition has a seed
+    schedulingPool.run (requests.size(), [&] (size_t i)
+                        {
+                            if (! scheduled[i])
+                                return;
+
+                            const auto& request = requests[i];
+
+                            if (seed != 0)
+                                ModifierApplicator::seedThreadRandom (getSliceSeed (seed, request.trackIndex, request.startBeat));
+
+                            slices[i].notes = composition.extractMidiSequenceForBeatRange (request.trackIndex, request.startBeat, request.endBeat, tempo, request.filter, trigContext, request.includeGenerated, &considered[i]);
+                            transport.buildTrackEvents (slices[i]);
+                        });
+
+    // Remember what was scheduled so later edits can be found. Notes that
+    // were dropped or muted count too, so an edit elsewhere doesn't re-roll them
+    for (size_t i = 0; i < slices.size(); ++i)
     {
-        // No output available, skip this track
-        return;
+        const auto& slice = slices[i];
+
+        if (! slice.built || slice.trackIndex >= liveEdits.size())
+            continue;
+
+        auto& revisions = liveEdits[slice.trackIndex].scheduledRevisions;
+
+        for (const auto* note : considered[i])
+            revisions[note->getId()] = note->getRevision();
+
+        for (const auto& note : slice.notes)
+            revisions[note.sourceId] = note.sourceRevision;
+
+        // A pass that generated nothing still counts as the generator's
+        const auto& seq = composition.getSequence (requests[i].trackIndex);
+        if (requests[i].includeGenerated && seq.isGenerative())
+            revisions[seq.getGeneratorSourceId()] = 0;
     }
 
-    double tempo = transport.getTempo();
+    transport.commitTrackEvents (slices);
+    return scheduled;
+}
+
+void MainComponent::propagateLiveEdits()
+{
+    const auto& sequences = composition.getSequences();
+
+    // Events before this are left alone: the audio thread may be sending them
+    double fromTime = transport.getCurrentPosition() + liveEditMarginSeconds;
+    double fromBeat = transport.secondsToBeats (fromTime);
+
+    // Every edited track's replacements go out in one pass
+    std::array<std::vector<juce::uint32>, TransportEngine::MAX_TRACKS> changedNotes;
+    std::vector<ScheduleRequest> requests;
+
+    for (size_t i = 0; i < sequences.size() && i < liveEdits.size(); ++i)
+    {
+        if (! sequences[i])
+            continue;
+
+        const auto& seq = *sequences[i];
+        auto& track = liveEdits[i];
 
-    // Calculate beat range to schedule
-    double startBeat = currentBeat;
-    double endBeat = startBeat + TransportEngine::LOOKAHEAD_BEATS; // Schedule ahead
+        bool settingsChanged = seq.getSettingsRevision() != track.settingsRevision;
+        bool generatorChanged = seq.getGeneratorRevision() != track.generatorRevision;
 
-    // Extract MIDI notes for this beat range
-    auto notes = composition.extractMidiSequenceForBeatRange (trackIndex, startBeat, endBeat, tempo);
+        if (! settingsChanged && ! generatorChanged && seq.getNotesRevision() == track.notesRevision)
+            continue;
 
-    // Convert beat times to absolute seconds for scheduling
-    double loopStartTimeSeconds = transport.beatsToSeconds (startBeat);
-    int midiChannel = seq.getMidiChannel();
+        track.notesRevision = seq.getNotesRevision();
+        track.settingsRevision = seq.getSettingsRevision();
+        track.generatorRevision = seq.getGeneratorRevision();
 
-    // Schedule the beat slice
-    transport.scheduleTrack (trackIndex, notes, loopStartTimeSeconds, output, midiChannel);
+        // Scheduled notes that changed since, or were removed. A sequence setting
+        // (scale, root note, channel...) can change every note's output
+        auto& changed = changedNotes[i];
+        std::unordered_set<juce::uint32> present;
 
-    // Mark beats as scheduled
-    transport.markBeatsScheduled (trackIndex, endBeat);
+        for (const auto& note : seq.notes)
+        {
+            present.insert (note->getId());
+
+            auto it = track.scheduledRevisions.find (note->getId());
+            if (it != track.scheduledRevisions.end() && (settingsChanged || it->second != note->getRevision()))
+                changed.push_back (note->getId());
+        }
+
+        // A generator's notes share one id and change only with the generator
+        // or the settings; stored notes are left alone when just it changes
+        bool regenerate = false;
+        if (seq.isGenerative())
+        {
+            auto generatorId = seq.getGeneratorSourceId();
+            present.insert (generatorId);
+
+            bool wasScheduled = track.scheduledRevisions.contains (generatorId);
+            bool generatedChanged = settingsChanged || generatorChanged;
+
+            if (wasScheduled && generatedChanged)
+                changed.push_back (generatorId);
+
+            regenerate = generatedChanged || ! wasScheduled;
+        }
+
+        for (auto it = track.scheduledRevisions.begin(); it != track.scheduledRevisions.end();)
+        {
+            if (! present.contains (it->first))
+            {
+                changed.push_back (it->first);
+                it = track.scheduledRevisions.erase (it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        transport.cancelNoteEvents (changed, fromTime);
+
+        double endBeat = transport.getScheduledEndBeat (i);
+        if (endBeat <= fromBeat)
+            continue;
+
+        // Replacements for what was retracted, plus notes added inside the window
+        std::sort (changed.begin(), changed.end());
+        requests.push_back ({ i, fromBeat, endBeat, [&changed, &track] (const Note& note)
+                              { return std::binary_search (changed.begin(), changed.end(), note.getId())
+                                       || ! track.scheduledRevisions.contains (note.getId()); },
+                              regenerate });
+    }
+
+    if (! requests.empty())
+        scheduleTracks (requests);
 }
 
 void MainComponent::stop()
 {
+    // Notes still held when the transport stops end where it stopped
+    recordMidiInput();
+    if (noteRecorder.isArmed())
+    {
+        noteRecorder.releaseAll (transport.getCurrentBeat());
+        auto batch = cursor.getSelectedSequence().createEditBatch ("recordMidi");
+        noteRecorder.addFinishedNotes (cursor.getSelectedSequence(), batch);
+        cursor.commitRecordedNotes (batch);
+    }
+
     transport.stop();
 
+    // Scene plans are timed from the run that just ended; the next start
+    // plays every track until a scene is queued again
+    transport.clearPlaybackPlans();
+
     // Clear stale flash state on all notes so they don't show the velocity
     // flash colour when the transport is stopped and restarted
     for (auto& seq : composition.getSequences())
@@ -276,10 +791,138 @@ void MainComponent::stop()
     juce::Logger::writeToLog ("Transport Stopped");
 }
 
+void MainComponent::updateMidiClockOutputs()
+{
+    midiOutputManager.setClockEnabled ({}, AppSettings::getInstance().getSendMidiClock());
+    midiClockGenerator.setOutputs (midiOutputManager.getClockOutputs());
+}
+
+void MainComponent::setRecordArmed (bool shouldBeArmed)
+{
+    noteRecorder.setArmed (shouldBeArmed);
+
+    if (! updateMidiInput())
+        noteRecorder.setArmed (false);
+
+    cursor.beginRecordingTake();
+    statusBarComponent.setRecordArmed (noteRecorder.isArmed());
+}
+
+bool MainComponent::updateMidiInput()
+{
+    bool needsInput = noteRecorder.isArmed() || transport.isFollowingExternalTimebase();
+
+    if (! needsInput)
+    {
+        midiInputManager.closeDevice();
+        return true;
+    }
+
+    if (midiInputManager.isOpen())
+        return true;
+
+    if (midiInputManager.openDevice (AppSettings::getInstance().getMidiInputDevice()))
+        return true;
+
+    contextualMenuComponent.showMessage ("No MIDI input available", 2000);
+    return false;
+}
+
+void MainComponent::setFollowMidiClock (bool shouldFollow)
+{
+    // The MIDI thread must be done with the follower before it is reset
+    midiInputManager.setClockFollower (nullptr);
+    clockFollower.reset();
+    midiInputManager.setClockFollower (shouldFollow ? &clockFollower : nullptr);
+    transport.setExternalTimebase (shouldFollow ? &clockFollower.getTimebase() : nullptr);
+
+    if (! updateMidiInput())
+    {
+        midiInputManager.setClockFollower (nullptr);
+        transport.setExternalTimebase (nullptr);
+        shouldFollow = false;
+    }
+
+    statusBarComponent.setExternalClockText (shouldFollow ? "EXT" : juce::String());
+}
+
+void MainComponent::followMidiClock()
+{
+    if (! transport.isFollowingExternalTimebase())
+        return;
+
+    // Play while the external clock runs; a clock that vanished without
+    // sending Stop counts as stopped
+    bool externalRunning = clockFollower.getTimebase().read().playing
+                           && clockFollower.isReceivingClock (juce::Time::getMillisecondCounterHiRes());
+
+    if (externalRunning && ! transport.isPlaying())
+        start();
+    else if (! externalRunning && transport.isPlaying())
+        stop();
+
+    // The followed tempo really changed: what was scheduled at the old one
+    // is timed wrong, so every track schedules again from here
+    if (transport.takeFollowedTempoChange() && transport.isPlaying())
+        transport.rescheduleFrom (transport.getCurrentBeat());
+
+    auto stats = clockFollower.getStatistics();
+    juce::String text = "EXT";
+
+    if (stats.ticksReceived > 0)
+    {
+        text << " " << juce::String (stats.tempo, 1) << " bpm"
+             << (stats.locked ? "" : " (locking)")
+             << " jitter " << juce::String (stats.jitterMs, 2) << "ms"
+             << " drift " << juce::String (stats.driftMs, 2) << "ms";
+    }
+
+    statusBarComponent.setExternalClockText (text);
+}
+
+void MainComponent::recordMidiInput()
+{
+    if (! midiInputManager.isOpen())
+        return;
+
+    pendingInputEvents.clear();
+    if (midiInputManager.popEvents (pendingInputEvents) == 0)
+        return;
+
+    // Input is only written while the transport runs
+    if (! noteRecorder.isArmed() || ! transport.isPlaying())
+        return;
+
+    // Each event is placed at the beat it was played, using the age of its
+    // device timestamp rather than the time it was drained
+    double now = MidiInputManager::getCurrentTimestamp();
+    double currentBeat = transport.getCurrentBeat();
+
+    for (const auto& event : pendingInputEvents)
+    {
+        double beat = currentBeat - transport.secondsToBeats (juce::jmax (0.0, now - event.timestamp));
+
+        if (event.isNoteOn)
+            noteRecorder.noteOn (event.noteNumber, event.velocity, beat);
+        else
+            noteRecorder.noteOff (event.noteNumber, beat);
+    }
+
+    auto& seq = cursor.getSelectedSequence();
+    auto batch = seq.createEditBatch ("recordMidi");
+
+    if (noteRecorder.addFinishedNotes (seq, batch) > 0)
+        cursor.commitRecordedNotes (batch);
+}
+
 bool MainComponent::keyPressed (const juce::KeyPress& key)
 {
     if (shortcutManager.handleKeyPress (key, cursor.getMode()))
     {
+        // Shortcuts can move the cursor, change mode or switch sequence, all of
+        // which affect the cached note layer (duration lines, selected notes)
+        sequenceComponent.invalidateStaticLayer();
+        repaint();
         return true;
     }
 
@@ -345,92 +988,92 @@ void MainComponent::setupKeyboardShortcuts()
             "Enter insert mode"),
 
         Shortcut (
-            juce::KeyPress ('h'),
+            { juce::KeyPress ('h') },
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
-            [this]()
+            [this] (int count)
             {
-                cursor.move (Direction::left);
+                cursor.move (Direction::left, Selection::MoveMode::extend, count);
                 return true;
             },
             "Left",
             "Move the cursor left"),
 
         Shortcut (
-            juce::KeyPress ('l'),
+            { juce::KeyPress ('l') },
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
-            [this]()
+            [this] (int count)
             {
-                cursor.move (Direction::right);
+                cursor.move (Direction::right, Selection::MoveMode::extend, count);
                 return true;
             },
             "Right",
             "Move cursor right"),
 
         Shortcut (
-            juce::KeyPress ('j'),
+            { juce::KeyPress ('j') },
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
-            [this]()
+            [this] (int count)
             {
-                cursor.move (Direction::down);
+                cursor.move (Direction::down, Selection::MoveMode::extend, count);
                 return true;
             },
             "Down",
             "Move cursor down"),
 
         Shortcut (
-            juce::KeyPress ('k'),
+            { juce::KeyPress ('k') },
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
-            [this]()
+            [this] (int count)
             {
-                cursor.move (Direction::up);
+                cursor.move (Direction::up, Selection::MoveMode::extend, count);
                 return true;
             },
             "Up",
             "Move cursor up"),
 
         Shortcut (
-            juce::KeyPress::createFromDescription ("shift+h"),
+            { juce::KeyPress::createFromDescription ("shift+h") },
             { Mode::normal, Mode::visualLine, Mode::visualBlock },
-            [this]()
+            [this] (int count)
             {
-                cursor.moveCursorSelection (Direction::left);
+                cursor.moveCursorSelection (Direction::left, count);
                 return true;
             },
             "Selection left",
-            "Move visual selection left"),
+            "Move visual selection left").markAsEdit(),
 
         Shortcut (
-            juce::KeyPress::createFromDescription ("shift+l"),
+            { juce::KeyPress::createFromDescription ("shift+l") },
             { Mode::normal, Mode::visualLine, Mode::visualBlock },
-            [this]()
+            [this] (int count)
             {
-                cursor.moveCursorSelection (Direction::right);
+                cursor.moveCursorSelection (Direction::right, count);
                 return true;
             },
             "Selection right",
-            "Move visual selection right"),
+            "Move visual selection right").markAsEdit(),
 
         Shortcut (
-            juce::KeyPress::createFromDescription ("shift+j"),
+            { juce::KeyPress::createFromDescription ("shift+j") },
             { Mode::normal, Mode::visualLine, Mode::visualBlock },
-            [this]()
+            [this] (int count)
             {
-                cursor.moveCursorSelection (Direction::down);
+                cursor.moveCursorSelection (Direction::down, count);
                 return true;
             },
             "Selection down",
-            "Move visual selection down"),
+            "Move visual selection down").markAsEdit(),
 
         Shortcut (
-            juce::KeyPress::createFromDescription ("shift+k"),
+            { juce::KeyPress::createFromDescription ("shift+k") },
             { Mode::normal, Mode::visualLine, Mode::visualBlock },
-            [this]()
+            [this] (int count)
             {
-                cursor.moveCursorSelection (Direction::up);
+                cursor.moveCursorSelection (Direction::up, count);
                 return true;
             },
             "Selection up",
-            "Move visual selection up"),
+            "Move visual selection up").markAsEdit(),
 
         Shortcut (
             juce::KeyPress ('u'),
@@ -475,7 +1118,7 @@ void MainComponent::setupKeyboardShortcuts()
                 return true;
             },
             "Paste",
-            "Paste yanked items relative to the cursor position"),
+            "Paste yanked items relative to the cursor position").markAsEdit(),
 
         Shortcut (
             juce::KeyPress ('d'),
@@ -488,6 +1131,51 @@ void MainComponent::setupKeyboardShortcuts()
             "Smaller steps",
             "Decrease timeline step size"),
 
+        Shortcut (
+            { juce::KeyPress ('d'), juce::KeyPress ('d') },
+            { Mode::normal },
+            [this] (int count)
+            {
+                cursor.removeNotesInColumns (count);
+                return true;
+            },
+            "Delete columns",
+            "Remove every note in the column under the cursor, or in [count] columns").markAsEdit(),
+
+        Shortcut (
+            { juce::KeyPress ('y'), juce::KeyPress ('y') },
+            { Mode::normal },
+            [this] (int count)
+            {
+                cursorComponent.triggerYankFlash();
+                cursor.yankColumns (count);
+                return true;
+            },
+            "Yank columns",
+            "Yank every note in the column under the cursor, or in [count] columns"),
+
+        Shortcut (
+            { juce::KeyPress ('>', juce::ModifierKeys::shiftModifier, 0), juce::KeyPress ('>', juce::ModifierKeys::shiftModifier, 0) },
+            { Mode::normal, Mode::visualBlock, Mode::visualLine },
+            [this] (int count)
+            {
+                cursor.shiftNotes (count);
+                return true;
+            },
+            "Shift later",
+            "Move notes at the cursor or in the selection [count] steps later").markAsEdit(),
+
+        Shortcut (
+            { juce::KeyPress ('<', juce::ModifierKeys::shiftModifier, 0), juce::KeyPress ('<', juce::ModifierKeys::shiftModifier, 0) },
+            { Mode::normal, Mode::visualBlock, Mode::visualLine },
+            [this] (int count)
+            {
+                cursor.shiftNotes (-count);
+                return true;
+            },
+            "Shift earlier",
+            "Move notes at the cursor or in the selection [count] steps earlier").markAsEdit(),
+
         Shortcut (
             juce::KeyPress ('f'),
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
@@ -607,7 +1295,7 @@ void MainComponent::setupKeyboardShortcuts()
                 return true;
             },
             "Insert note",
-            "Insert a note at the current cursor position"),
+            "Insert a note at the current cursor position").markAsEdit(),
 
         Shortcut (
             juce::KeyPress ('x'),
@@ -618,7 +1306,7 @@ void MainComponent::setupKeyboardShortcuts()
                 return true;
             },
             "Delete note",
-            "Remove note at cursor position"),
+            "Remove note at cursor position").markAsEdit(),
 
         Shortcut (
             juce::KeyPress ('m'),
@@ -639,6 +1327,18 @@ void MainComponent::setupKeyboardShortcuts()
             "Modifiers",
             "Open the modifier menu for selected notes"),
 
+        Shortcut (
+            juce::KeyPress ('n'),
+            { Mode::normal, Mode::visualBlock, Mode::visualLine },
+            [this]()
+            {
+                contextualMenuComponent.displayMenu (generatorMenuManager.getMenuNodeRoot(), [this] (const juce::String& tag)
+                                                     { return tag.isNotEmpty() && cursor.getSelectedSequence().getGeneratorState().hasType (juce::Identifier (tag)); });
+                return true;
+            },
+            "Generators",
+            "Generate a pattern into the selected sequence"),
+
         Shortcut (
             juce::KeyPress ('1'),
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
@@ -694,6 +1394,25 @@ void MainComponent::setupKeyboardShortcuts()
             "Settings",
             "Open global settings menu"),
 
+        Shortcut (
+            juce::KeyPress ('g'),
+            { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
+            [this]()
+            {
+                rebuildScenesMenu();
+                contextualMenuComponent.displayMenu (scenesMenuRoot.get(), [this] (const juce::String& tag)
+                                                     {
+                                                        if (tag == "song")
+                                                            return songMode;
+                                                        if (tag == "fill")
+                                                            return trigContext.fill;
+                                                        auto* active = transport.getActivePlaybackPlan();
+                                                        return active != nullptr && tag == "scene" + juce::String (active->sceneIndex); });
+                return true;
+            },
+            "Scenes",
+            "Queue a scene for the next bar, capture one, or toggle song mode or fill"),
+
         Shortcut (
             juce::KeyPress ('?', juce::ModifierKeys::shiftModifier, 0),
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
@@ -724,56 +1443,150 @@ void MainComponent::setupKeyboardShortcuts()
             "Open settings menu for the currently selected sequence"),
 
         Shortcut (
-            juce::KeyPress ('(', juce::ModifierKeys::shiftModifier, 0),
+            { juce::KeyPress ('(', juce::ModifierKeys::shiftModifier, 0) },
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
-            [this]()
+            [this] (int count)
             {
-                cursor.decreaseNoteVelocity();
+                cursor.decreaseNoteVelocity (count);
                 return true;
             },
             "Decrease velocity",
-            "Decrease velocity of notes at cursor by 10"),
+            "Decrease velocity of notes at cursor by 10").markAsEdit(),
 
         Shortcut (
-            juce::KeyPress (')', juce::ModifierKeys::shiftModifier, 0),
+            { juce::KeyPress (')', juce::ModifierKeys::shiftModifier, 0) },
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
-            [this]()
+            [this] (int count)
             {
-                cursor.increaseNoteVelocity();
+                cursor.increaseNoteVelocity (count);
                 return true;
             },
             "Increase velocity",
-            "Increase velocity of notes at cursor by 10"),
+            "Increase velocity of notes at cursor by 10").markAsEdit(),
 
         Shortcut (
-            juce::KeyPress ('['),
+            { juce::KeyPress ('[') },
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
-            [this]()
+            [this] (int count)
             {
-                cursor.decreaseNoteDuration();
+                cursor.decreaseNoteDuration (count);
                 return true;
             },
             "Decrease duration",
-            "Decrease duration of notes at cursor by one step"),
+            "Decrease duration of notes at cursor by one step").markAsEdit(),
 
         Shortcut (
-            juce::KeyPress (']'),
+            { juce::KeyPress (']') },
             { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
-            [this]()
+            [this] (int count)
             {
-                cursor.increaseNoteDuration();
+                cursor.increaseNoteDuration (count);
                 return true;
             },
             "Increase duration",
-            "Increase duration of notes at cursor by one step"),
+            "Increase duration of notes at cursor by one step").markAsEdit(),
+
+        Shortcut (
+            { juce::KeyPress::createFromDescription ("shift+r") },
+            { Mode::normal, Mode::insert, Mode::visualBlock, Mode::visualLine },
+            [this] (int)
+            {
+                setRecordArmed (! noteRecorder.isArmed());
+                return true;
+            },
+            "Record arm",
+            "Arm or disarm recording of MIDI input into the selected sequence"),
 
     };
 
+    std::vector<Shortcut> macroShortcuts = {
+
+        Shortcut (
+            { juce::KeyPress ('q') },
+            { Mode::normal, Mode::visualBlock, Mode::visualLine },
+            [this] (int)
+            {
+                if (shortcutManager.isRecording())
+                {
+                    shortcutManager.stopRecording();
+                    statusBarComponent.setRecordingRegister (0);
+                    return true;
+                }
+
+                shortcutManager.awaitRegister ([this] (juce::juce_wchar reg)
+                                               {
+                                                   shortcutManager.startRecording (reg);
+                                                   statusBarComponent.setRecordingRegister (shortcutManager.getRecordingRegister());
+                                                   return shortcutManager.isRecording(); });
+                return true;
+            },
+            "Record macro",
+            "q{register} starts recording shortcuts into a register, q again stops").markAsNotRecorded(),
+
+        Shortcut (
+            { juce::KeyPress ('@', juce::ModifierKeys::shiftModifier, 0) },
+            { Mode::normal, Mode::visualBlock, Mode::visualLine },
+            [this] (int count)
+            {
+                shortcutManager.awaitRegister ([this, count] (juce::juce_wchar reg)
+                                               {
+                                                   auto replay = [this, reg, count]() { return shortcutManager.replayMacro (reg, count); };
+                                                   return replayAsOneEdit ("replayMacro", replay); });
+                return true;
+            },
+            "Play macro",
+            "[count]@{register} replays a recorded macro, @@ the last one played").markAsNotRecorded(),
+
+        Shortcut (
+            { juce::KeyPress ('.') },
+            { Mode::normal, Mode::visualBlock, Mode::visualLine },
+            [this] (int count)
+            {
+                auto replay = [this, count]() { return shortcutManager.repeatLastChange (count); };
+                return replayAsOneEdit ("repeatChange", replay);
+            },
+            "Repeat",
+            "Repeat the last edit [count] times").markAsNotRecorded(),
+    };
+
+    shortcuts.insert (shortcuts.end(), macroShortcuts.begin(), macroShortcuts.end());
     shortcutManager.registerShortcuts (shortcuts);
+
+    // Ambiguous prefixes such as "d" or a lone digit run after a short timeout
+    shortcutManager.onDeferredShortcutExecuted = [this]()
+    {
+        sequenceComponent.invalidateStaticLayer();
+        repaint();
+    };
+}
+
+bool MainComponent::replayAsOneEdit (const juce::String& name, std::function<bool()> replay)
+{
+    auto& undoHistory = cursor.getUndoHistory();
+    auto transactionsBefore = undoHistory.getNumUndoableTransactions();
+    auto bytesBefore = undoHistory.getEstimatedBytes();
+    bool handled = false;
+
+    {
+        // Per-step change messages are held back until the replay is done;
+        // it runs synchronously, so no frame is drawn part way through
+        NoteEditBatch::ScopedDeferredNotifications deferNotifications;
+
+        undoHistory.beginTransactionGroup (name);
+        handled = replay();
+        undoHistory.endTransactionGroup();
+    }
+
+    if (undoHistory.getNumUndoableTransactions() != transactionsBefore || undoHistory.getEstimatedBytes() != bytesBefore)
+        composition.setIsDirty (true);
+
+    sequenceComponent.invalidateStaticLayer();
+    repaint();
+    return handled;
 }
 
 void MainComponent::repaintSequenceComponents()
 {
-    sequenceComponent.repaint();
+    sequenceComponent.invalidateStaticLayer();
     sequenceSelectionComponent.repaint();
 }
@@ -1,10 +1,15 @@
 #pragma once
 
+#include "Audio/ClockFollower.h"
+#include "Audio/MidiClockGenerator.h"
+#include "Audio/MidiInputManager.h"
 #include "Audio/MidiOutputManager.h"
+#include "Audio/SchedulingPool.h"
 #include "Audio/Transport.h"
 #include "Components/BeatLegendComponent.h"
 #include "Components/ContextualMenuComponent.h"
 #include "Components/CursorComponent.h"
+#include "Components/Generators/GeneratorMenuManager.h"
 #include "Components/MidlineComponent.h"
 #include "Components/Modifiers/ModifierMenuManager.h"
 #include "Components/PitchLegendComponent.h"
@@ -17,14 +22,19 @@
 #include "Data/Cursor.h"
 #include "Data/KeyboardShortcutManager.h"
 #include "Data/MenuNode.h"
+#include "Data/NoteRecorder.h"
 #include <JuceHeader.h>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
 
 //==============================================================================
 /*
     This component lives inside our window, and this is where you should put all
     your controls and content.
 */
-class MainComponent : public juce::AnimatedAppComponent
+class MainComponent : public juce::Component,
+                      public juce::ChangeListener
 {
 public:
     //==============================================================================
@@ -32,7 +42,11 @@ public:
     ~MainComponent() override;
 
     //==============================================================================
-    void update() override;
+    // Called on every display refresh. Nothing is repainted wholesale here:
+    // each child invalidates only the regions that actually animate
+    void update();
+
+    void changeListenerCallback (juce::ChangeBroadcaster* source) override;
 
     //==============================================================================
     void paint (juce::Graphics& g) override;
@@ -52,9 +66,24 @@ private:
     // Unified transport control (owns tempo, play state, MIDI scheduling)
     Transport transport;
 
+    // Extracts and builds each track's events in parallel during a scheduling pass
+    SchedulingPool schedulingPool;
+
     // MIDI output management (per-track routing)
     MidiOutputManager midiOutputManager;
 
+    // MIDI clock to followers, timed from the transport's timebase
+    MidiClockGenerator midiClockGenerator { transport.getTimebase() };
+
+    // Tempo and position from incoming MIDI clock; declared before the
+    // input manager so the device is closed before the follower goes away
+    ClockFollower clockFollower;
+
+    // MIDI input capture for note recording
+    MidiInputManager midiInputManager;
+    NoteRecorder noteRecorder;
+    std::vector<MidiInputManager::InputEvent> pendingInputEvents;
+
     // Audio device management
     juce::AudioDeviceManager deviceManager;
 
@@ -71,31 +100,131 @@ private:
     SequenceSelectionComponent sequenceSelectionComponent;
 
     ModifierMenuManager modifierMenuManager;
+    GeneratorMenuManager generatorMenuManager;
 
     ContextualMenuComponent contextualMenuComponent;
 
     // Menu structures
     std::unique_ptr<MenuNode> helpMenuRoot;
     std::unique_ptr<MenuNode> globalSettingsMenuRoot;
+    std::unique_ptr<MenuNode> scenesMenuRoot;
 
     SequenceSettingsManager sequenceSettngsManager;
 
     KeyboardShortcutManager shortcutManager;
 
+    // Drives update() in sync with the display; declared last so every
+    // component exists before the first callback
+    juce::VBlankAttachment vBlankAttachment;
+
+#if MODALITY_OPENGL
+    NoteGridRenderer gridRenderer;
+#endif
+
     //==============================================================================
     // Private methods
     std::unique_ptr<MenuNode> createHelpMenuTree();
 
-    // Schedule beats for a track (per-beat scheduling)
-    void scheduleTrackBeats (size_t trackIndex, double currentBeat);
+    // One track's part of a scheduling pass: its notes in [startBeat, endBeat),
+    // optionally only those the filter accepts
+    struct ScheduleRequest
+    {
+        size_t trackIndex = 0;
+        double startBeat = 0.0;
+        double endBeat = 0.0;
+        std::function<bool (const Note&)> filter;
+        bool includeGenerated = true;
+    };
+
+    // Extracts and builds the requested tracks on the scheduling pool, then hands all
+    // their events to the transport at once. Returns which requests were scheduled
+    // (false where the track has no output)
+    std::vector<bool> scheduleTracks (const std::vector<ScheduleRequest>& requests);
+
+    // Schedules the requests and marks each scheduled track up to its end beat
+    void scheduleLookahead (const std::vector<ScheduleRequest>& requests);
+
+    // Seed for a track's random modifiers in one window; windows start on the same
+    // beats every run, so a seeded composition plays the same way every time
+    static juce::uint32 getSliceSeed (juce::uint32 seed, size_t trackIndex, double startBeat);
+
+    // Further behind than this (a seek, a stall), lookahead restarts at the playhead
+    // rather than catching up on the notes it missed
+    static constexpr double maxCatchUpBeats = 0.25;
+
+    // Replaces the pending events of notes edited since the last frame
+    void propagateLiveEdits();
+
+    // Edits closer to the playhead than this are heard from the next loop
+    static constexpr double liveEditMarginSeconds = 0.03;
+
+    struct LiveEditState
+    {
+        juce::uint32 notesRevision = 0;
+        juce::uint32 settingsRevision = 0;
+        juce::uint32 generatorRevision = 0;
+        std::unordered_map<juce::uint32, juce::uint32> scheduledRevisions; // note id -> revision scheduled
+    };
+    std::array<LiveEditState, TransportEngine::MAX_TRACKS> liveEdits;
 
     // Check and schedule any tracks that need their next loop
     void checkAndScheduleTracks();
 
+    // Hands each sequence's mute, solo and enabled state to the audio thread
+    void syncTrackMuteSolo();
+
+    // Recompiles a track's automation plan when its lanes or routing change
+    void syncAutomation();
+    AutomationPlan compileAutomationPlan (const Sequence& seq, juce::MidiOutput* output) const;
+
+    struct AutomationSyncState
+    {
+        const Sequence* sequence = nullptr;
+        juce::MidiOutput* output = nullptr;
+        juce::uint32 automationRevision = 0;
+        juce::uint32 settingsRevision = 0;
+    };
+    std::array<AutomationSyncState, TransportEngine::MAX_TRACKS> automationSync;
+    AutomationPlanQueue automationPlans;
+
+    // Scenes: the plan for a scene starting at a beat, queued for the next bar line
+    PlaybackPlan compileScenePlan (int sceneIndex, double startBeat) const;
+    void queueScene (int sceneIndex);
+
+    // Song mode: queues the scene after the active one to follow it
+    void advanceSong();
+    void rebuildScenesMenu();
+    PlaybackPlanQueue playbackPlans;
+    bool songMode = false;
+
+    // Playback start and fill state for trig conditions
+    TrigCondition::Context trigContext;
+
     void start();
     void stop();
 
+    // Arms or disarms note recording, opening the MIDI input while armed
+    void setRecordArmed (bool shouldBeArmed);
+
+    // Opens the MIDI input while recording is armed or the clock is followed
+    bool updateMidiInput();
+
+    // Switches the transport between the internal tempo and incoming MIDI clock
+    void setFollowMidiClock (bool shouldFollow);
+
+    // Starts and stops the transport with the followed clock and shows its statistics
+    void followMidiClock();
+
+    // Drains captured MIDI input into the selected sequence as one edit per frame
+    void recordMidiInput();
+
     void setupKeyboardShortcuts();
 
+    // Applies the MIDI clock setting to the outputs and the clock generator
+    void updateMidiClockOutputs();
+
+    // Runs a macro or repeat as a single undo step with one redraw at the end
+    bool replayAsOneEdit (const juce::String& name, std::function<bool()> replay);
+
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MainComponent)
 };
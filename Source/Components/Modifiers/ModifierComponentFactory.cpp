@@ -12,6 +12,17 @@ std::unique_ptr<ISelectableWidget> createWidget (const SingleValueParamDefinitio
     {
         case ParamWidgetType::slider:
             return std::make_unique<SliderWidgetComponent> (def.displayName, valueBinding, def.min, def.max, def.interval);
+        case ParamWidgetType::choice:
+        {
+            // A stepped slider that shows the chosen label
+            auto choices = def.choices;
+            auto min = def.min;
+            return std::make_unique<SliderWidgetComponent> (def.displayName, valueBinding, def.min, def.max, 1.0, [choices, min] (double v) -> juce::String
+                                                            {
+                                                                auto index = juce::roundToInt (v - min);
+                                                                return juce::isPositiveAndBelow (index, static_cast<int> (choices.size())) ? choices[static_cast<size_t> (index)] : juce::String (v);
+                                                            });
+        }
         case ParamWidgetType::toggle:
             // TODO: Implement toggle widget when needed
             return nullptr;
@@ -33,13 +44,18 @@ std::unique_ptr<ISelectableWidget> createDualValueWidget (const DualValueParamDe
 
 std::vector<std::unique_ptr<ISelectableWidget>> createWidgets (const juce::Identifier& modifierType, juce::ValueTree& state)
 {
-    std::vector<std::unique_ptr<ISelectableWidget>> widgets;
-
     const auto* definition = ModifierRegistry::getInstance().getDefinition (modifierType);
     if (definition == nullptr)
-        return widgets;
+        return {};
+
+    return createWidgets (definition->params, state);
+}
+
+std::vector<std::unique_ptr<ISelectableWidget>> createWidgets (const std::vector<ParamDefinition>& params, juce::ValueTree& state)
+{
+    std::vector<std::unique_ptr<ISelectableWidget>> widgets;
 
-    for (const auto& paramDef : definition->params)
+    for (const auto& paramDef : params)
     {
         std::unique_ptr<ISelectableWidget> widget;
 
@@ -11,6 +11,9 @@ namespace ModifierComponentFactory
 // Creates widgets for all parameters of a modifier type, bound to a ValueTree via juce::Value
 std::vector<std::unique_ptr<ISelectableWidget>> createWidgets (const juce::Identifier& modifierType, juce::ValueTree& state);
 
+// Creates widgets for a list of parameter definitions, e.g. a generator's
+std::vector<std::unique_ptr<ISelectableWidget>> createWidgets (const std::vector<ParamDefinition>& params, juce::ValueTree& state);
+
 // Creates a single widget for a parameter, bound to a single ValueTree property
 std::unique_ptr<ISelectableWidget> createWidget (const SingleValueParamDefinition& def, juce::Value valueBinding);
 
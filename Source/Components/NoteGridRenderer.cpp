@@ -0,0 +1,246 @@
+#include "Components/NoteGridRenderer.h"
+
+#if MODALITY_OPENGL
+
+#include <cstddef>
+
+namespace
+{
+// Triangle corners in unit bounds space, matching CoordinateUtils::getTriangleAtPoint
+const char* vertexShaderSource = R"(#version 330 core
+layout (location = 0) in vec4 bounds;
+layout (location = 1) in vec4 colour;
+
+uniform vec2 gridSize;
+
+out vec4 fillColour;
+out vec3 barycentric;
+
+const vec2 corners[3] = vec2[3] (vec2 (0.0, 0.0), vec2 (1.0, 0.5), vec2 (0.0, 1.0));
+
+void main()
+{
+    vec2 position = bounds.xy + corners[gl_VertexID] * bounds.zw;
+    gl_Position = vec4 (position.x / gridSize.x * 2.0 - 1.0, 1.0 - position.y / gridSize.y * 2.0, 0.0, 1.0);
+
+    barycentric = vec3 (0.0);
+    barycentric[gl_VertexID] = 1.0;
+    fillColour = colour;
+}
+)";
+
+// The outline comes from the distance to the nearest edge, so fill and
+// stroke need only the one draw call
+const char* fragmentShaderSource = R"(#version 330 core
+in vec4 fillColour;
+in vec3 barycentric;
+
+out vec4 fragColour;
+
+void main()
+{
+    vec3 edgeDistance = barycentric / fwidth (barycentric);
+    float edge = clamp (min (min (edgeDistance.x, edgeDistance.y), edgeDistance.z), 0.0, 1.0);
+    fragColour = mix (vec4 (0.0, 0.0, 0.0, 1.0), fillColour, edge);
+}
+)";
+} // namespace
+
+//==============================================================================
+NoteGridRenderer::NoteGridRenderer()
+{
+    context.setRenderer (this);
+    context.setOpenGLVersionRequired (juce::OpenGLContext::openGL3_2);
+    context.setComponentPaintingEnabled (true);
+    context.setContinuousRepainting (false);
+}
+
+NoteGridRenderer::~NoteGridRenderer()
+{
+    cancelPendingUpdate();
+    detach();
+}
+
+void NoteGridRenderer::attachTo (juce::Component& target, juce::Colour backgroundColour)
+{
+    background = backgroundColour;
+    context.attachTo (target);
+}
+
+void NoteGridRenderer::detach()
+{
+    context.detach();
+}
+
+bool NoteGridRenderer::isActive() const
+{
+    return active.load();
+}
+
+void NoteGridRenderer::setNotes (std::vector<NoteInstance> notes, const juce::Component& grid)
+{
+    auto* target = context.getTargetComponent();
+    if (target == nullptr)
+        return;
+
+    {
+        const juce::ScopedLock sl (snapshotLock);
+        pendingNotes = std::move (notes);
+        pendingArea = target->getLocalArea (&grid, grid.getLocalBounds());
+        pendingTargetBounds = target->getLocalBounds();
+        ++generation;
+    }
+
+    context.triggerRepaint();
+}
+
+bool NoteGridRenderer::isSoftwareRenderer (const juce::String& rendererName)
+{
+    static const juce::StringArray softwareRenderers { "llvmpipe", "softpipe", "swrast", "Software Rasterizer", "SwiftShader", "Microsoft Basic Render", "GDI Generic" };
+
+    for (const auto& name : softwareRenderers)
+    {
+        if (rendererName.containsIgnoreCase (name))
+            return true;
+    }
+
+    return false;
+}
+
+//==============================================================================
+void NoteGridRenderer::newOpenGLContextCreated()
+{
+    using namespace juce::gl;
+
+    auto rendererName = juce::String (reinterpret_cast<const char*> (glGetString (GL_RENDERER)));
+    auto glslVersion = juce::OpenGLShaderProgram::getLanguageVersion();
+
+    if (glslVersion < 3.3 || isSoftwareRenderer (rendererName) || ! createShader())
+    {
+        juce::Logger::writeToLog ("OpenGL grid renderer unavailable (" + rendererName + ", GLSL " + juce::String (glslVersion) + "), using software rendering");
+        active = false;
+        triggerAsyncUpdate();
+        return;
+    }
+
+    glGenVertexArrays (1, &vertexArray);
+    glGenBuffers (1, &instanceBuffer);
+
+    glBindVertexArray (vertexArray);
+    glBindBuffer (GL_ARRAY_BUFFER, instanceBuffer);
+
+    glEnableVertexAttribArray (0);
+    glVertexAttribPointer (0, 4, GL_FLOAT, GL_FALSE, sizeof (NoteInstance), nullptr);
+    glVertexAttribDivisor (0, 1);
+
+    glEnableVertexAttribArray (1);
+    glVertexAttribPointer (1, 4, GL_FLOAT, GL_FALSE, sizeof (NoteInstance), reinterpret_cast<void*> (offsetof (NoteInstance, red)));
+    glVertexAttribDivisor (1, 1);
+
+    glBindVertexArray (0);
+    glBindBuffer (GL_ARRAY_BUFFER, 0);
+
+    // Force the first snapshot to be uploaded
+    uploadedGeneration = 0;
+    uploadedCount = 0;
+
+    juce::Logger::writeToLog ("OpenGL grid renderer active (" + rendererName + ")");
+    active = true;
+    triggerAsyncUpdate();
+}
+
+void NoteGridRenderer::renderOpenGL()
+{
+    using namespace juce::gl;
+
+    juce::OpenGLHelpers::clear (background);
+
+    if (! active)
+        return;
+
+    {
+        const juce::ScopedLock sl (snapshotLock);
+        if (generation != uploadedGeneration)
+        {
+            glBindBuffer (GL_ARRAY_BUFFER, instanceBuffer);
+            glBufferData (GL_ARRAY_BUFFER, static_cast<GLsizeiptr> (pendingNotes.size() * sizeof (NoteInstance)), pendingNotes.data(), GL_DYNAMIC_DRAW);
+            glBindBuffer (GL_ARRAY_BUFFER, 0);
+
+            uploadedCount = pendingNotes.size();
+            uploadedGeneration = generation;
+            drawArea = pendingArea;
+            drawTargetBounds = pendingTargetBounds;
+        }
+    }
+
+    if (uploadedCount == 0 || drawArea.isEmpty())
+        return;
+
+    // GL's origin is bottom-left, the component's is top-left
+    auto scale = static_cast<float> (context.getRenderingScale());
+    auto toPixels = [scale] (int v)
+    { return juce::roundToInt (static_cast<float> (v) * scale); };
+
+    glViewport (toPixels (drawArea.getX()),
+                toPixels (drawTargetBounds.getHeight() - drawArea.getBottom()),
+                toPixels (drawArea.getWidth()),
+                toPixels (drawArea.getHeight()));
+
+    glEnable (GL_BLEND);
+    glBlendFunc (GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+    shader->use();
+    shader->setUniform ("gridSize", static_cast<GLfloat> (drawArea.getWidth()), static_cast<GLfloat> (drawArea.getHeight()));
+
+    glBindVertexArray (vertexArray);
+    glDrawArraysInstanced (GL_TRIANGLES, 0, 3, static_cast<GLsizei> (uploadedCount));
+    glBindVertexArray (0);
+
+    // Restore the full viewport for the component layer composited on top
+    glViewport (0, 0, toPixels (drawTargetBounds.getWidth()), toPixels (drawTargetBounds.getHeight()));
+}
+
+void NoteGridRenderer::openGLContextClosing()
+{
+    using namespace juce::gl;
+
+    active = false;
+    shader.reset();
+
+    if (instanceBuffer != 0)
+        glDeleteBuffers (1, &instanceBuffer);
+
+    if (vertexArray != 0)
+        glDeleteVertexArrays (1, &vertexArray);
+
+    instanceBuffer = 0;
+    vertexArray = 0;
+}
+
+void NoteGridRenderer::handleAsyncUpdate()
+{
+    // Detaching has to happen on the message thread
+    if (! active)
+        detach();
+
+    if (onAvailabilityChanged)
+        onAvailabilityChanged();
+}
+
+bool NoteGridRenderer::createShader()
+{
+    auto program = std::make_unique<juce::OpenGLShaderProgram> (context);
+
+    if (! program->addVertexShader (vertexShaderSource)
+        || ! program->addFragmentShader (fragmentShaderSource)
+        || ! program->link())
+    {
+        juce::Logger::writeToLog ("OpenGL grid shader failed: " + program->getLastError());
+        return false;
+    }
+
+    shader = std::move (program);
+    return true;
+}
+
+#endif
@@ -0,0 +1,83 @@
+#pragma once
+
+#if MODALITY_OPENGL
+
+#include <JuceHeader.h>
+#include <atomic>
+#include <functional>
+#include <vector>
+
+//==============================================================================
+/**
+    Draws every note triangle of the grid with a single instanced draw call.
+
+    Instances are built on the message thread and handed over as a snapshot;
+    the GL thread only re-uploads when a new snapshot has arrived. The renderer
+    switches itself off when the context is older than GL 3.3 or runs on a
+    software rasteriser (e.g. Mesa llvmpipe), and the grid then falls back to
+    juce::Graphics.
+*/
+class NoteGridRenderer : private juce::OpenGLRenderer,
+                         private juce::AsyncUpdater
+{
+public:
+    /** One note triangle: bounds in grid pixels and its fill colour. */
+    struct NoteInstance
+    {
+        float x, y, width, height;
+        float red, green, blue, alpha;
+    };
+
+    NoteGridRenderer();
+    ~NoteGridRenderer() override;
+
+    /** Attaches a GL context to the top-level component. Child components keep
+        painting on top of the GL output, so the target must not fill its
+        background while the renderer is active.
+    */
+    void attachTo (juce::Component& target, juce::Colour backgroundColour);
+    void detach();
+
+    /** True once the context exists and has passed the capability checks. */
+    bool isActive() const;
+
+    /** Replaces the drawn notes. Must be called on the message thread. */
+    void setNotes (std::vector<NoteInstance> notes, const juce::Component& grid);
+
+    /** Called on the message thread when the renderer becomes active or falls back. */
+    std::function<void()> onAvailabilityChanged;
+
+    static bool isSoftwareRenderer (const juce::String& rendererName);
+
+private:
+    void newOpenGLContextCreated() override;
+    void renderOpenGL() override;
+    void openGLContextClosing() override;
+    void handleAsyncUpdate() override;
+
+    bool createShader();
+
+    juce::OpenGLContext context;
+    juce::Colour background;
+    std::atomic<bool> active { false };
+
+    // GL thread only
+    std::unique_ptr<juce::OpenGLShaderProgram> shader;
+    juce::gl::GLuint vertexArray = 0;
+    juce::gl::GLuint instanceBuffer = 0;
+    size_t uploadedCount = 0;
+    size_t uploadedGeneration = 0;
+    juce::Rectangle<int> drawArea;
+    juce::Rectangle<int> drawTargetBounds;
+
+    // Snapshot shared between the message and GL threads
+    juce::CriticalSection snapshotLock;
+    std::vector<NoteInstance> pendingNotes;
+    juce::Rectangle<int> pendingArea;
+    juce::Rectangle<int> pendingTargetBounds;
+    size_t generation = 0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (NoteGridRenderer)
+};
+
+#endif
@@ -16,14 +16,16 @@
 #include <unordered_set>
 
 //==============================================================================
-SequenceComponent::SequenceComponent (const Cursor& c, const Transport& t)
-    : cursor (c), transport (t)
+SequenceComponent::SequenceComponent (const Cursor& c, const Transport& t, juce::ValueTree compositionStateToWatch)
+    : cursor (c), transport (t), compositionState (std::move (compositionStateToWatch))
 {
     setWantsKeyboardFocus (false);
+    compositionState.addListener (this);
 }
 
 SequenceComponent::~SequenceComponent()
 {
+    compositionState.removeListener (this);
 }
 
 void SequenceComponent::paint (juce::Graphics& g)
@@ -31,18 +33,59 @@ void SequenceComponent::paint (juce::Graphics& g)
     float width = static_cast<float> (getWidth());
     float height = static_cast<float> (getHeight());
 
-    // Draw the playhead
+    if (width <= 0.0f || height <= 0.0f)
+        return;
+
+    // Draw the playhead underneath the notes
+    auto playhead = getPlayheadBounds().toFloat();
     g.setColour (AppColours::playhead);
+    g.drawLine (playhead.getCentreX(), 0, playhead.getCentreX(), height, playheadThickness);
 
-    const auto& selectedSequence = cursor.getSelectedSequence();
-    double tempoBPM = transport.getTempo();
+    // The static layer is rendered at the physical pixel scale so it stays
+    // sharp on high-DPI displays, and is only rebuilt after an invalidation
+    float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+
+    if (staticLayerDirty || ! staticLayer.isValid() || ! juce::approximatelyEqual (scale, staticLayerScale))
+    {
+        staticLayerScale = scale;
+        staticLayer = juce::Image (juce::Image::ARGB,
+                                   juce::jmax (1, juce::roundToInt (width * scale)),
+                                   juce::jmax (1, juce::roundToInt (height * scale)),
+                                   true);
 
-    double sequenceDurationInSeconds = selectedSequence.getLengthSeconds (tempoBPM);
+        bool drawNoteTriangles = true;
 
-    double loopedPosition = std::fmod (currentPlayheadTime_, sequenceDurationInSeconds);
-    double playheadX = (loopedPosition / sequenceDurationInSeconds) * width;
-    g.drawLine (static_cast<float> (playheadX), 0, static_cast<float> (playheadX), height, 3.0f);
+#if MODALITY_OPENGL
+        if (isGridRendererActive())
+        {
+            gridRenderer->setNotes (createNoteInstances (width, height), *this);
+            drawNoteTriangles = false;
+        }
+#endif
+
+        juce::Graphics layerGraphics (staticLayer);
+        layerGraphics.addTransform (juce::AffineTransform::scale (scale));
+        renderStaticLayer (layerGraphics, width, height, drawNoteTriangles);
+        staticLayerDirty = false;
+    }
+
+    g.drawImageTransformed (staticLayer, juce::AffineTransform::scale (1.0f / staticLayerScale));
+
+    // Playing notes are drawn on top of their cached triangle
+    if (transport.isPlaying())
+    {
+        double loopedPosition = getLoopedPosition();
+
+        for (auto& note : cursor.getSelectedSequence().notes)
+        {
+            if (isNotePlaying (*note, loopedPosition))
+                paintPlayingNote (g, *note, loopedPosition, width, height);
+        }
+    }
+}
 
+void SequenceComponent::renderStaticLayer (juce::Graphics& g, float width, float height, bool drawNoteTriangles) const
+{
     // Draw the outline
     g.setColour (juce::Colours::grey);
     g.drawRect (getLocalBounds(), 1);
@@ -65,8 +108,6 @@ void SequenceComponent::paint (juce::Graphics& g)
     // Draw the notes
     for (auto& note : cursor.getSelectedSequence().notes)
     {
-        auto tri = CoordinateUtils::getTriangleAtPoint (*note, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale());
-
         // Duration line — only for the note under the cursor
         // Drawn first so the triangle paints on top of it
         // Anchored at the left edge of the triangle (note start), extending right
@@ -80,100 +121,253 @@ void SequenceComponent::paint (juce::Graphics& g)
             g.drawLine (origin.x, midY, origin.x + durWidth, midY, 1.5f);
         }
 
-        // Velocity shading: map 0-127 to darkening amount, clamped so even
-        // velocity-0 notes remain visibly coloured (max darkening = 0.5)
-        float velocityT = static_cast<float> (note->getVelocity()) / 127.0f;
-        float darkenAmount = 0.5f * (1.0f - velocityT);
+        if (! drawNoteTriangles)
+            continue;
 
-        juce::Colour baseColour = note->hasAnyModifier() ? juce::Colours::orange
-                                                         : juce::Colours::lightgrey;
-        // Duration fill and ghost notes: only show while note is actually playing
-        if (transport.isPlaying() && note->lastTriggeredMidiNote.has_value())
-        {
-            const auto& triggered = *note->lastTriggeredMidiNote;
-            // Keep timing calculations in double precision to avoid precision loss
-            double noteStart = triggered.startTime;
-            double noteDur = triggered.duration;
-            double elapsed = loopedPosition - noteStart;
-
-            // Add timing tolerance to account for frame timing and floating-point precision
-            // Use a small tolerance (1/60th second ~= 16.67ms) to handle UI/audio sync differences
-            const double timingTolerance = 1.0 / 60.0;
-
-            // Check if note is currently playing (within its duration window with tolerance)
-            bool isCurrentlyPlaying = (elapsed >= -timingTolerance && elapsed <= (noteDur + timingTolerance));
-
-            // Only draw ghost notes while the note is playing
-            if (! triggered.isMuted && isCurrentlyPlaying && triggered.noteNumber != (selectedSequence.getRootNote() + static_cast<int> (note->getDegree())))
-            {
-                // Original left edge position
-                auto origPoint = CoordinateUtils::musicToScreen (*note, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale());
-                float stepW = CoordinateUtils::getStepWidthAtSmallestSize (width, cursor.getCurrentTimeline());
-                float stepH = CoordinateUtils::getStepHeight (height);
-                float origLeftX = origPoint.x;
-                float origMidY = origPoint.y + stepH * 0.5f;
-
-                double ghostDegree = static_cast<double> (triggered.noteNumber - selectedSequence.getRootNote());
-                auto ghostPoint = CoordinateUtils::musicToScreen (note->getStartTime(), ghostDegree, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale());
-                float ghostLeftX = ghostPoint.x;
-                float ghostMidY = ghostPoint.y + stepH * 0.5f;
-
-                // Draw connector from left edges
-                g.setColour (juce::Colours::black);
-                g.drawLine (origLeftX, origMidY, ghostLeftX, ghostMidY, 1.0f);
-
-                // Build ghost triangle path
-                juce::Path ghostTri;
-                ghostTri.startNewSubPath (ghostPoint);
-                ghostTri.lineTo (juce::Point<float> (ghostPoint.x + stepW, ghostPoint.y + stepH / 2.0f));
-                ghostTri.lineTo (juce::Point<float> (ghostPoint.x, ghostPoint.y + stepH));
-                ghostTri.closeSubPath();
-
-                // Light red fill and subtle stroke
-                g.setColour (juce::Colours::red.withAlpha (0.35f));
-                g.fillPath (ghostTri);
-                g.setColour (juce::Colours::black.withAlpha (0.6f));
-                g.strokePath (ghostTri, juce::PathStrokeType (1.0f));
-            }
-        }
+        auto tri = CoordinateUtils::getTriangleAtPoint (*note, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale());
 
-        g.setColour (baseColour.darker (darkenAmount));
+        g.setColour (getNoteColour (*note));
         g.fillPath (tri);
 
-        // Velocity flash: cyan overlay fading out over the note's duration
-        // Do not show a velocity flash for muted notes
-        if (transport.isPlaying() && note->lastTriggeredMidiNote.has_value())
-        {
-            const auto& triggered = *note->lastTriggeredMidiNote;
-            float noteStart = static_cast<float> (triggered.startTime);
-            float noteDur = static_cast<float> (triggered.duration);
-            float elapsed = static_cast<float> (loopedPosition) - noteStart;
-
-            if (! triggered.isMuted && elapsed >= 0.0f && elapsed < noteDur)
-            {
-                float fadeAlpha = 1.0f - (elapsed / noteDur);
-                float triggeredV = static_cast<float> (triggered.velocity) / 127.0f;
-                g.setColour (AppColours::velocityFlash.withAlpha (fadeAlpha * triggeredV));
-                g.fillPath (tri);
-            }
-        }
-
         g.setColour (juce::Colours::black);
         g.strokePath (tri, juce::PathStrokeType (1.0f));
     }
 }
 
+void SequenceComponent::paintPlayingNote (juce::Graphics& g, const Note& note, double loopedPosition, float width, float height) const
+{
+    const auto& selectedSequence = cursor.getSelectedSequence();
+    const auto& triggered = *note.lastTriggeredMidiNote;
+    auto tri = CoordinateUtils::getTriangleAtPoint (note, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale());
+
+    // Ghost note: shows where a modifier moved the pitch to
+    if (triggered.noteNumber != (selectedSequence.getRootNote() + static_cast<int> (note.getDegree())))
+    {
+        // Original left edge position
+        auto origPoint = CoordinateUtils::musicToScreen (note, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale());
+        float stepW = CoordinateUtils::getStepWidthAtSmallestSize (width, cursor.getCurrentTimeline());
+        float stepH = CoordinateUtils::getStepHeight (height);
+        float origLeftX = origPoint.x;
+        float origMidY = origPoint.y + stepH * 0.5f;
+
+        double ghostDegree = static_cast<double> (triggered.noteNumber - selectedSequence.getRootNote());
+        auto ghostPoint = CoordinateUtils::musicToScreen (note.getStartTime(), ghostDegree, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale());
+        float ghostLeftX = ghostPoint.x;
+        float ghostMidY = ghostPoint.y + stepH * 0.5f;
+
+        // Draw connector from left edges
+        g.setColour (juce::Colours::black);
+        g.drawLine (origLeftX, origMidY, ghostLeftX, ghostMidY, 1.0f);
+
+        // Build ghost triangle path
+        juce::Path ghostTri;
+        ghostTri.startNewSubPath (ghostPoint);
+        ghostTri.lineTo (juce::Point<float> (ghostPoint.x + stepW, ghostPoint.y + stepH / 2.0f));
+        ghostTri.lineTo (juce::Point<float> (ghostPoint.x, ghostPoint.y + stepH));
+        ghostTri.closeSubPath();
+
+        // Light red fill and subtle stroke
+        g.setColour (juce::Colours::red.withAlpha (0.35f));
+        g.fillPath (ghostTri);
+        g.setColour (juce::Colours::black.withAlpha (0.6f));
+        g.strokePath (ghostTri, juce::PathStrokeType (1.0f));
+
+        // Repaint the original triangle so the connector stays underneath it
+        g.setColour (getNoteColour (note));
+        g.fillPath (tri);
+    }
+
+    // Velocity flash: cyan overlay fading out over the note's duration
+    float noteStart = static_cast<float> (triggered.startTime);
+    float noteDur = static_cast<float> (triggered.duration);
+    float elapsed = static_cast<float> (loopedPosition) - noteStart;
+
+    if (elapsed >= 0.0f && elapsed < noteDur)
+    {
+        float fadeAlpha = 1.0f - (elapsed / noteDur);
+        float triggeredV = static_cast<float> (triggered.velocity) / 127.0f;
+        g.setColour (AppColours::velocityFlash.withAlpha (fadeAlpha * triggeredV));
+        g.fillPath (tri);
+    }
+
+    g.setColour (juce::Colours::black);
+    g.strokePath (tri, juce::PathStrokeType (1.0f));
+}
+
+juce::Colour SequenceComponent::getNoteColour (const Note& note) const
+{
+    // Velocity shading: map 0-127 to darkening amount, clamped so even
+    // velocity-0 notes remain visibly coloured (max darkening = 0.5)
+    float velocityT = static_cast<float> (note.getVelocity()) / 127.0f;
+    float darkenAmount = 0.5f * (1.0f - velocityT);
+
+    juce::Colour baseColour = note.hasAnyModifier() ? juce::Colours::orange
+                                                    : juce::Colours::lightgrey;
+
+    return baseColour.darker (darkenAmount);
+}
+
+bool SequenceComponent::isNotePlaying (const Note& note, double loopedPosition) const
+{
+    // Muted notes never show a flash or ghost
+    if (! note.lastTriggeredMidiNote.has_value() || note.lastTriggeredMidiNote->isMuted)
+        return false;
+
+    // Keep timing calculations in double precision to avoid precision loss
+    const auto& triggered = *note.lastTriggeredMidiNote;
+    double elapsed = loopedPosition - triggered.startTime;
+
+    return elapsed >= -timingTolerance && elapsed <= (triggered.duration + timingTolerance);
+}
+
+double SequenceComponent::getLoopedPosition() const
+{
+    double sequenceDurationInSeconds = cursor.getSelectedSequence().getLengthSeconds (transport.getTempo());
+
+    if (sequenceDurationInSeconds <= 0.0)
+        return 0.0;
+
+    return std::fmod (currentPlayheadTime_, sequenceDurationInSeconds);
+}
+
+juce::Rectangle<int> SequenceComponent::getPlayheadBounds() const
+{
+    double sequenceDurationInSeconds = cursor.getSelectedSequence().getLengthSeconds (transport.getTempo());
+    double playheadX = sequenceDurationInSeconds > 0.0 ? (getLoopedPosition() / sequenceDurationInSeconds) * getWidth()
+                                                       : 0.0;
+
+    return juce::Rectangle<float> (static_cast<float> (playheadX) - playheadThickness,
+                                   0.0f,
+                                   playheadThickness * 2.0f,
+                                   static_cast<float> (getHeight()))
+        .getSmallestIntegerContainer();
+}
+
+juce::Rectangle<int> SequenceComponent::getPlayingNoteBounds (const Note& note, float width, float height) const
+{
+    auto bounds = CoordinateUtils::getTriangleAtPoint (note, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale()).getBounds();
+
+    // The ghost note and its connector can sit anywhere in the note's column
+    if (note.lastTriggeredMidiNote.has_value())
+    {
+        double ghostDegree = static_cast<double> (note.lastTriggeredMidiNote->noteNumber - cursor.getSelectedSequence().getRootNote());
+        bounds = bounds.getUnion (CoordinateUtils::getRectAtPoint (note.getStartTime(), ghostDegree, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale()));
+    }
+
+    // Leave room for the stroke
+    return bounds.expanded (2.0f).getSmallestIntegerContainer();
+}
+
 void SequenceComponent::resized()
 {
+    invalidateStaticLayer();
 }
 
 //==============================================================================
 void SequenceComponent::update()
 {
+    auto playheadBounds = getPlayheadBounds();
+
+    if (playheadBounds != lastPlayheadBounds)
+    {
+        repaint (lastPlayheadBounds);
+        repaint (playheadBounds);
+        lastPlayheadBounds = playheadBounds;
+    }
+
+    // Clear last frame's overlays, then add this frame's
+    for (const auto& bounds : lastPlayingNoteBounds)
+        repaint (bounds);
+
+    lastPlayingNoteBounds.clear();
+
+    if (! transport.isPlaying())
+        return;
+
+    float width = static_cast<float> (getWidth());
+    float height = static_cast<float> (getHeight());
+    double loopedPosition = getLoopedPosition();
+
+    for (auto& note : cursor.getSelectedSequence().notes)
+    {
+        if (isNotePlaying (*note, loopedPosition))
+        {
+            auto bounds = getPlayingNoteBounds (*note, width, height);
+            repaint (bounds);
+            lastPlayingNoteBounds.push_back (bounds);
+        }
+    }
 }
 
 void SequenceComponent::setCurrentPlayheadTime (double time)
 {
     currentPlayheadTime_ = time;
+}
+
+void SequenceComponent::invalidateStaticLayer()
+{
+    staticLayerDirty = true;
     repaint();
 }
+
+#if MODALITY_OPENGL
+void SequenceComponent::setGridRenderer (NoteGridRenderer* renderer)
+{
+    gridRenderer = renderer;
+    invalidateStaticLayer();
+}
+
+bool SequenceComponent::isGridRendererActive() const
+{
+    return gridRenderer != nullptr && gridRenderer->isActive();
+}
+
+std::vector<NoteGridRenderer::NoteInstance> SequenceComponent::createNoteInstances (float width, float height) const
+{
+    const auto& notes = cursor.getSelectedSequence().notes;
+
+    std::vector<NoteGridRenderer::NoteInstance> instances;
+    instances.reserve (notes.size());
+
+    for (const auto& note : notes)
+    {
+        auto bounds = CoordinateUtils::getTriangleBoundsAtPoint (*note, width, height, cursor.getCurrentTimeline(), cursor.getCurrentScale());
+        auto colour = getNoteColour (*note);
+
+        instances.push_back ({ bounds.getX(), bounds.getY(), bounds.getWidth(), bounds.getHeight(), colour.getFloatRed(), colour.getFloatGreen(), colour.getFloatBlue(), colour.getFloatAlpha() });
+    }
+
+    return instances;
+}
+#endif
+
+//==============================================================================
+void SequenceComponent::valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&)
+{
+    // A bulk edit sends one message once it has been applied
+    if (NoteEditBatch::isApplying())
+        return;
+
+    invalidateStaticLayer();
+}
+
+void SequenceComponent::valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&)
+{
+    if (NoteEditBatch::isApplying())
+        return;
+
+    invalidateStaticLayer();
+}
+
+void SequenceComponent::valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int)
+{
+    if (NoteEditBatch::isApplying())
+        return;
+
+    invalidateStaticLayer();
+}
+
+void SequenceComponent::valueTreeChildOrderChanged (juce::ValueTree&, int, int)
+{
+    invalidateStaticLayer();
+}
@@ -10,6 +10,7 @@
 
 #pragma once
 
+#include "Components/NoteGridRenderer.h"
 #include "Data/Cursor.h"
 #include <JuceHeader.h>
 
@@ -19,22 +20,74 @@ class Transport;
 //==============================================================================
 /*
 */
-class SequenceComponent : public juce::Component
+class SequenceComponent : public juce::Component,
+                          public juce::ValueTree::Listener
 {
 public:
-    SequenceComponent (const Cursor& c, const Transport& t);
+    SequenceComponent (const Cursor& c, const Transport& t, juce::ValueTree compositionState);
     ~SequenceComponent() override;
 
     void paint (juce::Graphics&) override;
     void resized() override;
+
+    // Called once per frame: repaints only the playhead strip and the notes
+    // that are currently playing, never the whole grid
     void update();
     void setCurrentPlayheadTime (double time);
     juce::Path createNotePath (Note& n);
 
+    // Marks the cached note layer as stale and schedules a full repaint.
+    // Model edits are picked up by the ValueTree listener; cursor moves and
+    // mode changes must call this explicitly
+    void invalidateStaticLayer();
+
+#if MODALITY_OPENGL
+    // While the renderer is active it draws the note triangles and this
+    // component only paints the outline, duration lines and overlays
+    void setGridRenderer (NoteGridRenderer* renderer);
+#endif
+
+    void valueTreePropertyChanged (juce::ValueTree&, const juce::Identifier&) override;
+    void valueTreeChildAdded (juce::ValueTree&, juce::ValueTree&) override;
+    void valueTreeChildRemoved (juce::ValueTree&, juce::ValueTree&, int) override;
+    void valueTreeChildOrderChanged (juce::ValueTree&, int, int) override;
+
 private:
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (SequenceComponent)
 
+    // Outline, duration lines and note triangles; everything that only
+    // changes when the model or the cursor changes
+    void renderStaticLayer (juce::Graphics& g, float width, float height, bool drawNoteTriangles) const;
+    void paintPlayingNote (juce::Graphics& g, const Note& note, double loopedPosition, float width, float height) const;
+
+    juce::Colour getNoteColour (const Note& note) const;
+    bool isNotePlaying (const Note& note, double loopedPosition) const;
+    double getLoopedPosition() const;
+    juce::Rectangle<int> getPlayheadBounds() const;
+    juce::Rectangle<int> getPlayingNoteBounds (const Note& note, float width, float height) const;
+
     const Cursor& cursor;
     const Transport& transport;
+    juce::ValueTree compositionState;
     double currentPlayheadTime_ = 0.0;
+
+#if MODALITY_OPENGL
+    bool isGridRendererActive() const;
+    std::vector<NoteGridRenderer::NoteInstance> createNoteInstances (float width, float height) const;
+
+    NoteGridRenderer* gridRenderer = nullptr;
+#endif
+
+    juce::Image staticLayer;
+    float staticLayerScale = 1.0f;
+    bool staticLayerDirty = true;
+
+    // Regions repainted last frame, cleared again this frame so fading
+    // flashes and the previous playhead position do not leave trails
+    juce::Rectangle<int> lastPlayheadBounds;
+    std::vector<juce::Rectangle<int>> lastPlayingNoteBounds;
+
+    // Absorbs UI/audio sync differences of up to one frame (~16.67ms)
+    static constexpr double timingTolerance = 1.0 / 60.0;
+    static constexpr float playheadThickness = 3.0f;
 };
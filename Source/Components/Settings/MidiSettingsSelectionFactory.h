@@ -1,5 +1,6 @@
 #pragma once
 
+#include "Audio/MidiInputManager.h"
 #include "Audio/MidiOutputManager.h"
 #include "Components/Settings/PaginatedSettingsComponent.h"
 #include "Components/Widgets/ISelectableWidget.h"
@@ -39,6 +40,30 @@ namespace detail
         return deviceOptions;
     }
 
+    static std::vector<SelectionOption> buildMidiInputOptions (const MidiInputManager& midiInManager)
+    {
+        std::vector<SelectionOption> deviceOptions;
+
+        for (auto d : midiInManager.getAvailableDevices())
+        {
+            deviceOptions.push_back (SelectionOption { d.name, d.identifier });
+        }
+
+        // Not available on Windows, where opening it fails and is reported
+        deviceOptions.push_back (SelectionOption { "Virtual Port", MidiInputManager::virtualDeviceId });
+        return deviceOptions;
+    }
+
+    static std::vector<SelectionOption> buildClockSourceOptions()
+    {
+        return { SelectionOption { "Internal", "0" }, SelectionOption { "External", "1" } };
+    }
+
+    static std::vector<SelectionOption> buildOnOffOptions()
+    {
+        return { SelectionOption { "Off", "0" }, SelectionOption { "On", "1" } };
+    }
+
 } // namespace detail
 [[maybe_unused]] static std::unique_ptr<juce::Component> createComponent (const Cursor& cursor, const MidiOutputManager& midiOutManager)
 {
@@ -62,7 +87,9 @@ namespace detail
     const juce::String& initialMidiOutput,
     const juce::String& initialMidiChannel,
     const std::function<void (const juce::String&)> onMidiOutputChanged,
-    const std::function<void (const juce::String&)> onMidiChannelChanged)
+    const std::function<void (const juce::String&)> onMidiChannelChanged,
+    const juce::String& initialMidiClock = {},
+    const std::function<void (const juce::String&)> onMidiClockChanged = nullptr)
 {
     std::vector<std::unique_ptr<ISelectableWidget>> widgets;
     std::vector<SelectionOption> deviceOptions = detail::buildMidiDeviceOptions (midiOutManager);
@@ -71,6 +98,9 @@ namespace detail
     widgets.push_back (std::make_unique<SelectionWidgetComponent> ("MIDI Output", deviceOptions, initialMidiOutput, onMidiOutputChanged));
     widgets.push_back (std::make_unique<SelectionWidgetComponent> ("MIDI Channel", channelOptions, initialMidiChannel, onMidiChannelChanged));
 
+    if (onMidiClockChanged != nullptr)
+        widgets.push_back (std::make_unique<SelectionWidgetComponent> ("MIDI Clock", detail::buildOnOffOptions(), initialMidiClock, onMidiClockChanged));
+
     auto midiSettings = std::make_unique<PaginatedSettingsComponent> (std::move (widgets));
     return midiSettings;
 }
@@ -89,14 +119,34 @@ namespace detail
     const juce::String& initialMidiOutput,
     const juce::String& initialMidiChannel,
     const std::function<void (const juce::String&)> onMidiOutputChanged,
-    const std::function<void (const juce::String&)> onMidiChannelChanged)
+    const std::function<void (const juce::String&)> onMidiChannelChanged,
+    const juce::String& initialMidiClock = {},
+    const std::function<void (const juce::String&)> onMidiClockChanged = nullptr)
 {
     auto midiSettingsNode = std::make_unique<MenuNode> ("Midi Settings", juce::KeyPress::createFromDescription ("i"));
 
-    auto settingsComponent = createComponent (midiOutManager, initialMidiOutput, initialMidiChannel, onMidiOutputChanged, onMidiChannelChanged);
+    auto settingsComponent = createComponent (midiOutManager, initialMidiOutput, initialMidiChannel, onMidiOutputChanged, onMidiChannelChanged, initialMidiClock, onMidiClockChanged);
     midiSettingsNode->setComponent (std::move (settingsComponent));
 
     return midiSettingsNode;
 }
 
+[[maybe_unused]] static std::unique_ptr<MenuNode> createInputMenuNode (
+    const MidiInputManager& midiInManager,
+    const juce::String& initialMidiInput,
+    const juce::String& initialClockSource,
+    const std::function<void (const juce::String&)> onMidiInputChanged,
+    const std::function<void (const juce::String&)> onClockSourceChanged)
+{
+    std::vector<std::unique_ptr<ISelectableWidget>> widgets;
+
+    widgets.push_back (std::make_unique<SelectionWidgetComponent> ("MIDI Input", detail::buildMidiInputOptions (midiInManager), initialMidiInput, onMidiInputChanged));
+    widgets.push_back (std::make_unique<SelectionWidgetComponent> ("Clock Source", detail::buildClockSourceOptions(), initialClockSource, onClockSourceChanged));
+
+    auto inputSettingsNode = std::make_unique<MenuNode> ("Midi Input", juce::KeyPress::createFromDescription ("n"));
+    inputSettingsNode->setComponent (std::make_unique<PaginatedSettingsComponent> (std::move (widgets)));
+
+    return inputSettingsNode;
+}
+
 } // namespace MidiSettingsSelectionFactory
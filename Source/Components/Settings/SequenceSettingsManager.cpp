@@ -6,9 +6,62 @@
 #include "Components/Widgets/SelectionWidgetComponent.h"
 #include "Components/Widgets/SliderWidgetComponent.h"
 #include "Components/Widgets/TextInputWidgetComponent.h"
+#include "Data/AutomationLane.h"
+#include "Data/GrooveRegistry.h"
 #include "Data/Scale.h"
 #include <memory>
 
+namespace
+{
+// A lane's value at one beat, as 0-127; writing it sets a point there
+class AutomationPointValueSource : public juce::Value::ValueSource
+{
+public:
+    AutomationPointValueSource (AutomationLane l, double b, double length, juce::UndoManager* um)
+        : lane (std::move (l)), beat (b), loopLengthBeats (length), undoManager (um) {}
+
+    juce::var getValue() const override
+    {
+        return Automation::getValueAt (lane.getPoints(), lane.getMode(), beat, loopLengthBeats) * 127.0;
+    }
+
+    void setValue (const juce::var& newValue) override
+    {
+        lane.setPoint (beat, static_cast<double> (newValue) / 127.0, undoManager);
+        sendChangeMessage (false);
+    }
+
+private:
+    AutomationLane lane;
+    double beat;
+    double loopLengthBeats;
+    juce::UndoManager* undoManager;
+};
+
+// A sequence's length counted in its current steps, so loops can be any
+// number of tuplet steps (5 against 7 against 11)
+class LengthInStepsValueSource : public juce::Value::ValueSource
+{
+public:
+    explicit LengthInStepsValueSource (Timeline& t) : timeline (t) {}
+
+    juce::var getValue() const override
+    {
+        return juce::roundToInt (timeline.getUpperBound() / timeline.getStepSize());
+    }
+
+    void setValue (const juce::var& newValue) override
+    {
+        auto steps = juce::jmax (1, static_cast<int> (newValue));
+        timeline.setUpperBound (Ticks::toBeats (Ticks::fromBeats (timeline.getStepSize()) * steps));
+        sendChangeMessage (false);
+    }
+
+private:
+    Timeline& timeline;
+};
+} // namespace
+
 SequenceSettingsManager::SequenceSettingsManager (Cursor& c, MidiOutputManager& m) : cursor (c), midiOutManager (m)
 {
     menuRoot = std::make_unique<MenuNode> ("Sequence Settings");
@@ -48,6 +101,15 @@ SequenceSettingsManager::SequenceSettingsManager (Cursor& c, MidiOutputManager&
         auto timelineSlider = std::make_unique<SliderWidgetComponent> ("Length", seq.getTimeline().getUpperBoundAsValue(), 1.0, 8.0, 0.25);
         widgets.push_back (std::move (timelineSlider));
 
+        // Tuplet steps, and a length in those steps for exact polyrhythms
+        std::vector<SelectionOption> tupletOptions;
+        for (auto notes : Division::tuplets)
+            tupletOptions.push_back (SelectionOption (notes == 1 ? juce::String ("Straight") : juce::String (notes) + "-tuplet", juce::String (notes)));
+        widgets.push_back (std::make_unique<SelectionWidgetComponent> ("Tuplet", tupletOptions, seq.getTimeline().getTupletAsValue()));
+
+        juce::Value lengthInSteps (new LengthInStepsValueSource (seq.getTimeline()));
+        widgets.push_back (std::make_unique<SliderWidgetComponent> ("Length in Steps", lengthInSteps, 1.0, 128.0, 1.0));
+
         // Root note
         static const char* noteNames[] = { "C", "C#", "D", "D#", "E", "F", "F#", "G", "G#", "A", "A#", "B" };
         auto rootNoteFormatter = [] (double v) -> juce::String
@@ -58,12 +120,120 @@ SequenceSettingsManager::SequenceSettingsManager (Cursor& c, MidiOutputManager&
         auto rootNoteSlider = std::make_unique<SliderWidgetComponent> ("Root Note", seq.getRootNoteAsValue(), 0.0, 127.0, 1.0, rootNoteFormatter);
         widgets.push_back (std::move (rootNoteSlider));
 
+        // Tuning output for scales between equal-tempered semitones
+        std::vector<SelectionOption> tuningOptions = {
+            SelectionOption ("Nearest note", "nearest"),
+            SelectionOption ("MPE pitch bend", "mpe"),
+            SelectionOption ("MTS SysEx", "mts"),
+        };
+        widgets.push_back (std::make_unique<SelectionWidgetComponent> ("Tuning", tuningOptions, seq.getTuningOutputAsValue()));
+
+        // Groove: swing, an imported template and humanise, heard from the next scheduled notes
+        auto percentFormatter = [] (double v) -> juce::String
+        { return juce::String (juce::roundToInt (v)) + "%"; };
+        widgets.push_back (std::make_unique<SliderWidgetComponent> ("Swing", seq.getGroove().getSwingAsValue(), Groove::straightSwing, Groove::maxSwing, 1.0, percentFormatter));
+
+        std::vector<SelectionOption> grooveOptions = { SelectionOption ("None", "") };
+        for (const auto& name : GrooveRegistry::getInstance().getTemplateNames())
+            grooveOptions.push_back (SelectionOption (name, name));
+        widgets.push_back (std::make_unique<SelectionWidgetComponent> ("Groove", grooveOptions, seq.getGroove().getTemplateNameAsValue()));
+
+        widgets.push_back (std::make_unique<SliderWidgetComponent> ("Humanise", seq.getGroove().getHumaniseAsValue(), 0.0, 100.0, 5.0, percentFormatter));
+
         auto settingsComponent = std::make_unique<PaginatedSettingsComponent> (std::move (widgets));
         propertiesNode->setComponent (std::move (settingsComponent));
     };
 
     propertiesNode = menuRoot->addChild (std::move (sequenceProperties));
 
+    // Automation lanes: points are written at the cursor's beat
+    auto automationNode = std::make_unique<MenuNode> ("Automation", juce::KeyPress ('a'));
+
+    auto laneSettings = std::make_unique<MenuNode> ("Edit Lane", juce::KeyPress ('e'));
+    laneSettings->onEnter = [this]()
+    {
+        auto& seq = cursor.getSelectedSequence();
+
+        // Editing a sequence without lanes starts its first one
+        if (seq.getNumAutomationLanes() == 0)
+        {
+            seq.addAutomationLane (Automation::Target::controller, 1, cursor.getUndoManager());
+            selectedLane = 0;
+        }
+
+        auto lane = getSelectedLane();
+        std::vector<std::unique_ptr<ISelectableWidget>> widgets;
+
+        std::vector<SelectionOption> targetOptions;
+        for (size_t i = 0; i < Automation::targetIds.size(); ++i)
+            targetOptions.push_back (SelectionOption (Automation::targetNames[i], Automation::targetIds[i]));
+        widgets.push_back (std::make_unique<SelectionWidgetComponent> ("Target", targetOptions, lane.getTargetAsValue()));
+
+        widgets.push_back (std::make_unique<SliderWidgetComponent> ("Controller", lane.getControllerAsValue(), 0.0, 127.0, 1.0));
+
+        std::vector<SelectionOption> modeOptions = {
+            SelectionOption ("Linear", "linear"),
+            SelectionOption ("Step", "step"),
+        };
+        widgets.push_back (std::make_unique<SelectionWidgetComponent> ("Interpolation", modeOptions, lane.getModeAsValue()));
+
+        // Pitch bend reads as an offset from centre
+        bool isPitchBend = lane.getTarget() == Automation::Target::pitchBend;
+        auto valueFormatter = [isPitchBend] (double v) -> juce::String
+        {
+            int n = juce::roundToInt (v);
+            return isPitchBend ? (n >= 64 ? "+" : "") + juce::String (n - 64) : juce::String (n);
+        };
+
+        double beat = cursor.cursorPosition.xTimepoint.value;
+        juce::Value pointValue (new AutomationPointValueSource (lane, beat, seq.getLengthBeats(), cursor.getUndoManager()));
+        widgets.push_back (std::make_unique<SliderWidgetComponent> ("Value at Cursor", pointValue, 0.0, 127.0, 1.0, valueFormatter));
+
+        laneSettingsNode->setComponent (std::make_unique<PaginatedSettingsComponent> (std::move (widgets)));
+    };
+    laneSettingsNode = automationNode->addChild (std::move (laneSettings));
+
+    auto addLaneNode = std::make_unique<MenuNode> ("Add Lane", juce::KeyPress ('n'));
+    addLaneNode->onAction = [this]()
+    {
+        auto& seq = cursor.getSelectedSequence();
+
+        if (seq.addAutomationLane (Automation::Target::controller, 1, cursor.getUndoManager()).isValid())
+            selectedLane = seq.getNumAutomationLanes() - 1;
+    };
+    automationNode->addChild (std::move (addLaneNode));
+
+    auto nextLaneNode = std::make_unique<MenuNode> ("Next Lane", juce::KeyPress ('l'));
+    nextLaneNode->onAction = [this]()
+    {
+        auto numLanes = cursor.getSelectedSequence().getNumAutomationLanes();
+        selectedLane = numLanes > 0 ? (selectedLane + 1) % numLanes : 0;
+    };
+    automationNode->addChild (std::move (nextLaneNode));
+
+    auto removePointNode = std::make_unique<MenuNode> ("Remove Point at Cursor", juce::KeyPress ('x'));
+    removePointNode->onAction = [this]()
+    {
+        auto lane = getSelectedLane();
+        if (lane.isValid())
+            lane.removePoint (cursor.cursorPosition.xTimepoint.value, cursor.getUndoManager());
+    };
+    automationNode->addChild (std::move (removePointNode));
+
+    auto removeLaneNode = std::make_unique<MenuNode> ("Remove Lane", juce::KeyPress ('d'));
+    removeLaneNode->onAction = [this]()
+    {
+        auto& seq = cursor.getSelectedSequence();
+
+        if (getSelectedLane().isValid())
+            seq.removeAutomationLane (selectedLane, cursor.getUndoManager());
+
+        selectedLane = juce::jmax (0, juce::jmin (selectedLane, seq.getNumAutomationLanes() - 1));
+    };
+    automationNode->addChild (std::move (removeLaneNode));
+
+    menuRoot->addChild (std::move (automationNode));
+
     // Mute node
     auto muteNode = std::make_unique<MenuNode> ("Mute", juce::KeyPress ('m'));
     muteNode->tag = "muted";
@@ -82,6 +252,9 @@ SequenceSettingsManager::SequenceSettingsManager (Cursor& c, MidiOutputManager&
             seq.setSoloed (false);
             seq.setMuted (true);
         }
+   
+        if (onMuteSoloChanged != nullptr)
+            onMuteSoloChanged();
     };
     menuRoot->addChild (std::move (muteNode));
 
@@ -103,6 +276,9 @@ SequenceSettingsManager::SequenceSettingsManager (Cursor& c, MidiOutputManager&
             seq.setMuted (false);
             seq.setSoloed (true);
         }
+   
+        if (onMuteSoloChanged != nullptr)
+            onMuteSoloChanged();
     };
     menuRoot->addChild (std::move (soloNode));
 }
@@ -114,13 +290,24 @@ MenuNode* SequenceSettingsManager::getMenuNodeRoot()
     return menuRoot.get();
 }
 
+AutomationLane SequenceSettingsManager::getSelectedLane()
+{
+    auto& seq = cursor.getSelectedSequence();
+
+    // The selection may belong to another sequence, or to a lane since removed
+    if (selectedLane < 0 || selectedLane >= seq.getNumAutomationLanes())
+        selectedLane = 0;
+
+    return seq.getAutomationLane (selectedLane);
+}
+
 std::vector<SelectionOption> SequenceSettingsManager::getScaleOptions()
 {
     std::vector<SelectionOption> options;
 
-    for (auto scale : scaleDefinitions)
+    for (const auto& name : Scale::getScaleNames())
     {
-        options.push_back (SelectionOption (scale.first, scale.first));
+        options.push_back (SelectionOption (name, name));
     }
     return options;
 }
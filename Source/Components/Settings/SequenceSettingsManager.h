@@ -14,12 +14,20 @@ public:
 
     MenuNode* getMenuNodeRoot();
 
+    // Called after the selected sequence is muted, unmuted, soloed or unsoloed
+    std::function<void()> onMuteSoloChanged;
+
 private:
     Cursor& cursor;
     MidiOutputManager& midiOutManager;
     std::unique_ptr<MenuNode> menuRoot;
     MenuNode* midiSettingsNode;
     MenuNode* propertiesNode;
+    MenuNode* laneSettingsNode;
+
+    // Automation lane of the selected sequence that the lane menu edits
+    int selectedLane = 0;
+    AutomationLane getSelectedLane();
 
     std::vector<SelectionOption> getScaleOptions();
 };
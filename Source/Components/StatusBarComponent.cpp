@@ -89,9 +89,9 @@ void StatusBarComponent::paint (juce::Graphics& g)
     g.drawEllipse (pieRect, 1.0f);
 
     // Dirty state indicator (* asterisk, right side just left of cursor box)
+    const int dirtyWidth = 20;
     if (composition.isDirty())
     {
-        const int dirtyWidth = 20;
         juce::Rectangle<int> dirtyBox (cursorBox.getX() - dirtyWidth, 0, dirtyWidth, height);
         g.setColour (juce::Colours::orangered);
         g.setFont (juce::Font (juce::FontOptions (20.0f).withStyle ("Bold")));
@@ -102,11 +102,56 @@ void StatusBarComponent::paint (juce::Graphics& g)
     g.setColour (juce::Colours::darkgrey);
     g.setFont (juce::Font (juce::FontOptions (12.0f).withStyle ("Italic")));
 
-    const int helpLeft = pieBackground.getRight() + padding;
+    // Undo history readout (left of the dirty indicator)
+    const auto& undoHistory = cursor.getUndoHistory();
+    const int undoWidth = 130;
+    juce::Rectangle<int> undoBox (cursorBox.getX() - dirtyWidth - undoWidth, 0, undoWidth, height);
+    juce::String undoText = "undo " + juce::String (undoHistory.getNumUndoableTransactions())
+                            + " / " + juce::String (juce::roundToInt (undoHistory.getEstimatedBytes() / 1024.0)) + " KB";
+    g.drawText (undoText, undoBox, juce::Justification::centredRight, true);
+
+    // Record arm and macro recording indicators (right of the pie)
+    int helpLeft = pieBackground.getRight() + padding;
+    if (recordArmed)
+    {
+        const int armedWidth = 40;
+        juce::Rectangle<int> armedBox (helpLeft, 0, armedWidth, height);
+        g.setColour (juce::Colours::red);
+        g.drawText ("REC", armedBox, juce::Justification::centredLeft, true);
+        g.setColour (juce::Colours::darkgrey);
+        helpLeft = armedBox.getRight();
+    }
+
+    if (recordingRegister != 0)
+    {
+        const int recordingWidth = 110;
+        juce::Rectangle<int> recordingBox (helpLeft, 0, recordingWidth, height);
+        g.setColour (juce::Colours::orangered);
+        g.drawText ("recording @" + juce::String::charToString (recordingRegister), recordingBox, juce::Justification::centredLeft, true);
+        g.setColour (juce::Colours::darkgrey);
+        helpLeft = recordingBox.getRight();
+    }
+
+    if (externalClockText.isNotEmpty())
+    {
+        const int clockWidth = 260;
+        juce::Rectangle<int> clockBox (helpLeft, 0, clockWidth, height);
+        g.drawText (externalClockText, clockBox, juce::Justification::centredLeft, true);
+        helpLeft = clockBox.getRight();
+    }
+
+    if (sceneText.isNotEmpty())
+    {
+        const int sceneWidth = 180;
+        juce::Rectangle<int> sceneBox (helpLeft, 0, sceneWidth, height);
+        g.drawText (sceneText, sceneBox, juce::Justification::centredLeft, true);
+        helpLeft = sceneBox.getRight();
+    }
+
     auto helpTextBounds = juce::Rectangle<int> (
         helpLeft,
         0,
-        cursorBox.getX() - helpLeft - padding,
+        undoBox.getX() - helpLeft - padding,
         height);
 
     g.drawText ("/ : settings    ? : help", helpTextBounds, juce::Justification::centred, true);
@@ -123,6 +168,36 @@ void StatusBarComponent::resized()
     }
 }
 
+void StatusBarComponent::setRecordingRegister (juce::juce_wchar reg)
+{
+    recordingRegister = reg;
+    repaint();
+}
+
+void StatusBarComponent::setRecordArmed (bool armed)
+{
+    recordArmed = armed;
+    repaint();
+}
+
+void StatusBarComponent::setExternalClockText (const juce::String& text)
+{
+    if (text == externalClockText)
+        return;
+
+    externalClockText = text;
+    repaint();
+}
+
+void StatusBarComponent::setSceneText (const juce::String& text)
+{
+    if (text == sceneText)
+        return;
+
+    sceneText = text;
+    repaint();
+}
+
 void StatusBarComponent::setPiePercentage (float percentage)
 {
     // Ensure percentage is between 0 and 1
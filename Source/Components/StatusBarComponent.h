@@ -22,9 +22,25 @@ public:
 
     void setPiePercentage (float percentage);
 
+    // Register a macro is being recorded into, or 0 when not recording
+    void setRecordingRegister (juce::juce_wchar reg);
+
+    // MIDI input recording is armed
+    void setRecordArmed (bool armed);
+
+    // Followed MIDI clock readout, or empty when running from the internal tempo
+    void setExternalClockText (const juce::String& text);
+
+    // Playing scene, and the one queued for the next bar line
+    void setSceneText (const juce::String& text);
+
 private:
     int barHeight = 30;
     float piePercentage; // Value between 0 and 1
+    juce::juce_wchar recordingRegister = 0;
+    bool recordArmed = false;
+    juce::String externalClockText;
+    juce::String sceneText;
 
     const Cursor& cursor;
     const Composition& composition;
@@ -1,4 +1,5 @@
 #include "Data/AppSettings.h"
+#include "Data/UndoHistory.h"
 #include "juce_core/juce_core.h"
 
 AppSettings& AppSettings::getInstance()
@@ -134,3 +135,93 @@ void AppSettings::setDefaultMidiChannel (juce::String channel)
 {
     setStringValue (AppSettingsIDs::MidiDefaultChannel, channel);
 }
+
+juce::String AppSettings::getMidiInputDevice()
+{
+    return getStringValue (AppSettingsIDs::MidiInputDevice);
+}
+
+void AppSettings::setMidiInputDevice (juce::String deviceID)
+{
+    setStringValue (AppSettingsIDs::MidiInputDevice, deviceID);
+}
+
+bool AppSettings::getSendMidiClock()
+{
+    return getBoolValue (AppSettingsIDs::SendMidiClock, false);
+}
+
+void AppSettings::setSendMidiClock (bool shouldSend)
+{
+    setBoolValue (AppSettingsIDs::SendMidiClock, shouldSend);
+}
+
+bool AppSettings::getFollowMidiClock()
+{
+    return getBoolValue (AppSettingsIDs::FollowMidiClock, false);
+}
+
+void AppSettings::setFollowMidiClock (bool shouldFollow)
+{
+    setBoolValue (AppSettingsIDs::FollowMidiClock, shouldFollow);
+}
+
+bool AppSettings::getMidiRunningStatus()
+{
+    return getBoolValue (AppSettingsIDs::MidiRunningStatus, false);
+}
+
+void AppSettings::setMidiRunningStatus (bool shouldUse)
+{
+    setBoolValue (AppSettingsIDs::MidiRunningStatus, shouldUse);
+}
+
+int AppSettings::getAutomationRate()
+{
+    return getIntValue (AppSettingsIDs::AutomationRate, 100);
+}
+
+void AppSettings::setAutomationRate (int hz)
+{
+    setIntValue (AppSettingsIDs::AutomationRate, hz);
+}
+
+bool AppSettings::getUseOpenGLRenderer()
+{
+    return getBoolValue (AppSettingsIDs::UseOpenGLRenderer, true);
+}
+
+void AppSettings::setUseOpenGLRenderer (bool shouldUse)
+{
+    setBoolValue (AppSettingsIDs::UseOpenGLRenderer, shouldUse);
+}
+
+int AppSettings::getUndoMaxTransactions()
+{
+    return getIntValue (AppSettingsIDs::UndoMaxTransactions, UndoHistory::defaultMaxTransactions);
+}
+
+void AppSettings::setUndoMaxTransactions (int count)
+{
+    setIntValue (AppSettingsIDs::UndoMaxTransactions, count);
+}
+
+int AppSettings::getUndoMaxKilobytes()
+{
+    return getIntValue (AppSettingsIDs::UndoMaxKilobytes, UndoHistory::defaultMaxKilobytes);
+}
+
+void AppSettings::setUndoMaxKilobytes (int kilobytes)
+{
+    setIntValue (AppSettingsIDs::UndoMaxKilobytes, kilobytes);
+}
+
+juce::File AppSettings::getUserScalesDirectory()
+{
+    return properties->getFile().getSiblingFile ("Scales");
+}
+
+juce::File AppSettings::getUserGroovesDirectory()
+{
+    return properties->getFile().getSiblingFile ("Grooves");
+}
@@ -11,6 +11,14 @@ DECLARE_ID (WindowLastHeight)
 DECLARE_ID (WindowLastWidth)
 DECLARE_ID (MidiDefaultOutputDevice)
 DECLARE_ID (MidiDefaultChannel)
+DECLARE_ID (MidiInputDevice)
+DECLARE_ID (SendMidiClock)
+DECLARE_ID (FollowMidiClock)
+DECLARE_ID (MidiRunningStatus)
+DECLARE_ID (AutomationRate)
+DECLARE_ID (UseOpenGLRenderer)
+DECLARE_ID (UndoMaxTransactions)
+DECLARE_ID (UndoMaxKilobytes)
 
 #undef DECLARE_ID
 } // namespace AppSettingsIDs
@@ -53,6 +61,42 @@ public:
     juce::String getDefaultMidiChannel();
     void setDefaultMidiChannel (juce::String channel);
 
+    // Device used for note recording; empty means the first available input
+    juce::String getMidiInputDevice();
+    void setMidiInputDevice (juce::String deviceID);
+
+    // Send MIDI clock and song position to the default output
+    bool getSendMidiClock();
+    void setSendMidiClock (bool shouldSend);
+
+    // Follow MIDI clock from the input device instead of the internal tempo
+    bool getFollowMidiClock();
+    void setFollowMidiClock (bool shouldFollow);
+
+    // Send note-offs as zero-velocity note-ons so DIN outputs can use running status
+    bool getMidiRunningStatus();
+    void setMidiRunningStatus (bool shouldUse);
+
+    // How often automation lanes are sampled during playback, in Hz
+    int getAutomationRate();
+    void setAutomationRate (int hz);
+
+    // Only takes effect in builds with MODALITY_OPENGL
+    bool getUseOpenGLRenderer();
+    void setUseOpenGLRenderer (bool shouldUse);
+
+    // Undo history limits, by transaction count and by estimated size
+    int getUndoMaxTransactions();
+    void setUndoMaxTransactions (int count);
+    int getUndoMaxKilobytes();
+    void setUndoMaxKilobytes (int kilobytes);
+
+    // User-supplied Scala (.scl) files, next to the settings file
+    juce::File getUserScalesDirectory();
+
+    // Groove templates as standard MIDI files, next to the settings file
+    juce::File getUserGroovesDirectory();
+
 private:
     AppSettings();
     ~AppSettings();
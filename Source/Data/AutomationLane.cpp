@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+    AutomationLane.cpp
+    A sequence's controller, pitch bend or aftertouch curve over its loop.
+
+  ==============================================================================
+*/
+
+#include "AutomationLane.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+// Points closer than this share a beat
+constexpr double pointEpsilon = 1.0e-4;
+
+Automation::Target targetFromId (const juce::String& id)
+{
+    for (size_t i = 0; i < Automation::targetIds.size(); ++i)
+        if (Automation::targetIds[i] == id)
+            return static_cast<Automation::Target> (i);
+
+    return Automation::Target::controller;
+}
+} // namespace
+
+float Automation::getValueAt (const std::vector<Point>& points, Mode mode, double beat, double loopLengthBeats)
+{
+    if (points.empty())
+        return 0.0f;
+
+    if (points.size() == 1)
+        return points.front().value;
+
+    // First point after the beat; the one before it is the segment start
+    auto next = std::upper_bound (points.begin(), points.end(), beat, [] (double b, const Point& p)
+                                  { return b < p.beat; });
+
+    const auto& from = next == points.begin() ? points.back() : *(next - 1);
+
+    if (mode == Mode::step)
+        return from.value;
+
+    const auto& to = next == points.end() ? points.front() : *next;
+
+    // Segments that cross the loop end are measured through it
+    double fromBeat = from.beat;
+    double toBeat = to.beat;
+
+    if (toBeat <= fromBeat)
+        toBeat += loopLengthBeats;
+    if (beat < fromBeat)
+        beat += loopLengthBeats;
+
+    if (toBeat - fromBeat <= 0.0)
+        return from.value;
+
+    auto t = static_cast<float> ((beat - fromBeat) / (toBeat - fromBeat));
+    return from.value + (to.value - from.value) * juce::jlimit (0.0f, 1.0f, t);
+}
+
+AutomationLane::AutomationLane (juce::ValueTree existingState) : state (std::move (existingState))
+{
+    jassert (! state.isValid() || state.hasType (AutomationIDs::Lane));
+}
+
+juce::ValueTree AutomationLane::createState (Automation::Target target, int controller)
+{
+    juce::ValueTree s (AutomationIDs::Lane);
+    s.setProperty (AutomationIDs::Target, Automation::targetIds[static_cast<size_t> (target)], nullptr);
+    s.setProperty (AutomationIDs::Controller, juce::jlimit (0, 127, controller), nullptr);
+    s.setProperty (AutomationIDs::Mode, "linear", nullptr);
+    s.setProperty (AutomationIDs::Points, juce::MemoryBlock(), nullptr);
+    return s;
+}
+
+juce::ValueTree& AutomationLane::getState() { return state; }
+
+bool AutomationLane::isValid() const { return state.isValid(); }
+
+Automation::Target AutomationLane::getTarget() const
+{
+    return targetFromId (state.getProperty (AutomationIDs::Target).toString());
+}
+
+void AutomationLane::setTarget (Automation::Target target, juce::UndoManager* undoManager)
+{
+    state.setProperty (AutomationIDs::Target, Automation::targetIds[static_cast<size_t> (target)], undoManager);
+}
+
+juce::Value AutomationLane::getTargetAsValue() { return state.getPropertyAsValue (AutomationIDs::Target, nullptr); }
+
+int AutomationLane::getController() const { return state.getProperty (AutomationIDs::Controller); }
+
+void AutomationLane::setController (int controller, juce::UndoManager* undoManager)
+{
+    state.setProperty (AutomationIDs::Controller, juce::jlimit (0, 127, controller), undoManager);
+}
+
+juce::Value AutomationLane::getControllerAsValue() { return state.getPropertyAsValue (AutomationIDs::Controller, nullptr); }
+
+Automation::Mode AutomationLane::getMode() const
+{
+    return state.getProperty (AutomationIDs::Mode).toString() == "step" ? Automation::Mode::step : Automation::Mode::linear;
+}
+
+void AutomationLane::setMode (Automation::Mode mode, juce::UndoManager* undoManager)
+{
+    state.setProperty (AutomationIDs::Mode, mode == Automation::Mode::step ? "step" : "linear", undoManager);
+}
+
+juce::Value AutomationLane::getModeAsValue() { return state.getPropertyAsValue (AutomationIDs::Mode, nullptr); }
+
+std::vector<Automation::Point> AutomationLane::getPoints() const
+{
+    std::vector<Automation::Point> points;
+
+    // Saved files carry the block as base64 text
+    juce::MemoryBlock block;
+    const auto& property = state.getProperty (AutomationIDs::Points);
+
+    if (const auto* binary = property.getBinaryData())
+        block = *binary;
+    else
+        block.fromBase64Encoding (property.toString());
+
+    points.resize (block.getSize() / sizeof (Automation::Point));
+    block.copyTo (points.data(), 0, points.size() * sizeof (Automation::Point));
+    return points;
+}
+
+void AutomationLane::setPoints (const std::vector<Automation::Point>& points, juce::UndoManager* undoManager)
+{
+    state.setProperty (AutomationIDs::Points, juce::MemoryBlock (points.data(), points.size() * sizeof (Automation::Point)), undoManager);
+}
+
+void AutomationLane::setPoint (double beat, double value, juce::UndoManager* undoManager)
+{
+    auto points = getPoints();
+    Automation::Point point { static_cast<float> (beat), static_cast<float> (juce::jlimit (0.0, 1.0, value)) };
+
+    auto it = std::lower_bound (points.begin(), points.end(), beat - pointEpsilon, [] (const Automation::Point& p, double b)
+                                { return p.beat < b; });
+
+    if (it != points.end() && std::abs (it->beat - beat) < pointEpsilon)
+        *it = point;
+    else
+        points.insert (it, point);
+
+    setPoints (points, undoManager);
+}
+
+void AutomationLane::removePoint (double beat, juce::UndoManager* undoManager)
+{
+    auto points = getPoints();
+    auto removed = std::erase_if (points, [beat] (const Automation::Point& p)
+                                  { return std::abs (p.beat - beat) < pointEpsilon; });
+
+    if (removed > 0)
+        setPoints (points, undoManager);
+}
+
+void AutomationLane::clearPoints (juce::UndoManager* undoManager)
+{
+    setPoints ({}, undoManager);
+}
+
+juce::String AutomationLane::getDisplayName() const
+{
+    auto target = getTarget();
+
+    if (target == Automation::Target::controller)
+        return "CC " + juce::String (getController());
+
+    return Automation::targetNames[static_cast<size_t> (target)];
+}
@@ -0,0 +1,99 @@
+/*
+  ==============================================================================
+
+    AutomationLane.h
+    A sequence's controller, pitch bend or aftertouch curve over its loop.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "juce_data_structures/juce_data_structures.h"
+#include <array>
+#include <vector>
+
+namespace AutomationIDs
+{
+#define DECLARE_ID(name) inline const juce::Identifier name { #name };
+DECLARE_ID (Automation)
+DECLARE_ID (Lane)
+DECLARE_ID (Target)
+DECLARE_ID (Controller)
+DECLARE_ID (Mode)
+DECLARE_ID (Points)
+#undef DECLARE_ID
+} // namespace AutomationIDs
+
+namespace Automation
+{
+enum class Target
+{
+    controller,      // A continuous controller on the track's channel
+    pitchBend,
+    channelPressure,
+    polyAftertouch,  // Sent to each note sounding on the track's channel
+};
+
+inline const std::array<juce::String, 4> targetIds = { "cc", "pitchBend", "pressure", "polyAftertouch" };
+inline const std::array<juce::String, 4> targetNames = { "CC", "Pitch Bend", "Channel Pressure", "Poly Aftertouch" };
+
+enum class Mode
+{
+    step,  // Each point holds until the next
+    linear // Straight lines between points
+};
+
+// Beat within the loop, and a value from 0 to 1 (pitch bend centre is 0.5)
+struct Point
+{
+    float beat = 0.0f;
+    float value = 0.0f;
+};
+
+// The value of a curve at a loop-local beat. Points are sorted by beat; the
+// curve wraps, so before the first point it carries on from the last
+float getValueAt (const std::vector<Point>& points, Mode mode, double beat, double loopLengthBeats);
+} // namespace Automation
+
+// A lightweight handle on a lane's ValueTree; copies refer to the same lane.
+// Points are kept as one binary block of floats rather than a child per point
+class AutomationLane
+{
+public:
+    static constexpr int maxLanesPerSequence = 8;
+
+    explicit AutomationLane (juce::ValueTree existingState);
+
+    static juce::ValueTree createState (Automation::Target target, int controller = 1);
+
+    juce::ValueTree& getState();
+    bool isValid() const;
+
+    Automation::Target getTarget() const;
+    void setTarget (Automation::Target target, juce::UndoManager* undoManager = nullptr);
+    juce::Value getTargetAsValue();
+
+    // Controller number for CC lanes
+    int getController() const;
+    void setController (int controller, juce::UndoManager* undoManager = nullptr);
+    juce::Value getControllerAsValue();
+
+    Automation::Mode getMode() const;
+    void setMode (Automation::Mode mode, juce::UndoManager* undoManager = nullptr);
+    juce::Value getModeAsValue();
+
+    std::vector<Automation::Point> getPoints() const;
+
+    // Add a point, or move the one already at this beat
+    void setPoint (double beat, double value, juce::UndoManager* undoManager = nullptr);
+    void removePoint (double beat, juce::UndoManager* undoManager = nullptr);
+    void clearPoints (juce::UndoManager* undoManager = nullptr);
+
+    juce::String getDisplayName() const;
+
+private:
+    juce::ValueTree state;
+
+    void setPoints (const std::vector<Automation::Point>& points, juce::UndoManager* undoManager);
+};
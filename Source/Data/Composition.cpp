@@ -1,8 +1,102 @@
 #include "Data/Composition.h"
+#include "Data/GeneratorRegistry.h"
+#include "Data/Generators.h"
 #include "Data/Sequence.h"
+#include "Data/Ticks.h"
 #include "juce_core/juce_core.h"
 #include "juce_core/system/juce_PlatformDefs.h"
 #include "juce_data_structures/juce_data_structures.h"
+#include <algorithm>
+#include <cmath>
+#include <optional>
+
+namespace
+{
+// Where a note at tick starts once the groove has moved it, relative to
+// startTick, if that is inside the window. Each note lands in exactly one
+// window, the one its grooved time falls in, so callers look the groove's
+// reach beyond each end. A note the groove would pull before playback
+// started plays as it starts instead
+std::optional<Ticks::Count> getGroovedOffset (const Groove& groove,
+                                              Ticks::Count tick,
+                                              double loopBeat,
+                                              Ticks::Count startTick,
+                                              Ticks::Count windowTicks,
+                                              Ticks::Count playStartTick)
+{
+    auto grooved = tick + Ticks::fromBeats (groove.getOffsetBeats (loopBeat));
+
+    if (tick >= playStartTick)
+        grooved = std::max (grooved, playStartTick);
+
+    auto offset = grooved - startTick;
+
+    if (offset < 0 || offset >= windowTicks)
+        return std::nullopt;
+
+    return offset;
+}
+
+// A generative sequence's notes starting in [startTick, startTick + windowTicks),
+// after the groove has moved them. Steps are counted from originTick and only
+// the window's steps (and those the groove can reach into it) are generated,
+// so a pattern that never repeats costs no more than a stored one
+void appendGeneratedNotes (const Sequence& seq,
+                           Ticks::Count originTick,
+                           Ticks::Count startTick,
+                           Ticks::Count windowTicks,
+                           Ticks::Count loopTicks,
+                           Ticks::Count playStartTick,
+                           double tempo,
+                           std::vector<MidiNote>& midiClip)
+{
+    auto stepTicks = Ticks::fromBeats (seq.getTimeline().getStepSize());
+    if (stepTicks <= 0)
+        return;
+
+    const auto& scale = seq.getScale();
+    const auto& groove = seq.getGroove();
+    double secondsPerBeat = 60.0 / tempo;
+
+    // The first step at or after each end of the window, widened by the
+    // groove's reach
+    auto ceilDiv = [] (Ticks::Count a, Ticks::Count b)
+    { return Ticks::floorDiv (a + b - 1, b); };
+
+    auto reachTicks = Ticks::fromBeats (groove.getMaxOffsetBeats());
+
+    GeneratorContext context;
+    context.firstStep = juce::jmax (Ticks::Count { 0 }, ceilDiv (startTick - reachTicks - originTick, stepTicks));
+    context.endStep = ceilDiv (startTick + windowTicks + reachTicks - originTick, stepTicks);
+    context.scaleStepsPerOctave = Generators::getScaleStepsPerOctave (scale);
+
+    for (const auto& generated : GeneratorRegistry::getInstance().generate (seq.getGeneratorState(), context))
+    {
+        double pitch = seq.getRootNote() + Generators::getDegree (scale, generated.scaleStep);
+        auto noteNumber = juce::roundToInt (pitch);
+
+        if (! juce::isPositiveAndBelow (noteNumber, 128))
+            continue;
+
+        auto tick = originTick + generated.step * stepTicks;
+
+        // Grooved by the note's place in the loop, as stored notes are
+        double loopBeat = Ticks::toBeats (Ticks::wrap (tick, loopTicks));
+        auto offset = getGroovedOffset (groove, tick, loopBeat, startTick, windowTicks, playStartTick);
+
+        if (! offset)
+            continue;
+
+        double startTime = Ticks::toBeats (*offset);
+        double duration = Ticks::toBeats (generated.lengthSteps * stepTicks);
+
+        MidiNote midi (startTime * secondsPerBeat, noteNumber, juce::jlimit (1, 127, generated.velocity), duration * secondsPerBeat);
+        midi.sourceId = seq.getGeneratorSourceId();
+        midi.detune = static_cast<float> (pitch - noteNumber);
+        midiClip.push_back (midi);
+    }
+}
+} // namespace
 
 Composition::Composition() : state (CompositionIDs::Composition)
 {
@@ -41,6 +135,36 @@ void Composition::createDefaultSequences()
 
 juce::ValueTree Composition::getSequencesState() { return state.getChildWithName (CompositionIDs::Sequences); }
 
+int Composition::getNumScenes() const
+{
+    return state.getChildWithName (SceneIDs::Scenes).getNumChildren();
+}
+
+Scene Composition::getScene (int index) const
+{
+    return Scene (state.getChildWithName (SceneIDs::Scenes).getChild (index));
+}
+
+Scene Composition::addScene (juce::uint32 trackMask, juce::UndoManager* undoManager)
+{
+    auto scenesState = state.getChildWithName (SceneIDs::Scenes);
+
+    if (! scenesState.isValid())
+    {
+        scenesState = juce::ValueTree (SceneIDs::Scenes);
+        state.addChild (scenesState, -1, undoManager);
+    }
+
+    auto sceneState = Scene::createState ("Scene " + juce::String (scenesState.getNumChildren() + 1), trackMask);
+    scenesState.addChild (sceneState, -1, undoManager);
+    return Scene (sceneState);
+}
+
+void Composition::removeScene (int index, juce::UndoManager* undoManager)
+{
+    state.getChildWithName (SceneIDs::Scenes).removeChild (index, undoManager);
+}
+
 double Composition::getTempo() const
 {
     return static_cast<double> (state.getProperty (CompositionIDs::Tempo));
@@ -51,6 +175,19 @@ void Composition::setTempo (double newTemp, juce::UndoManager* undoManager)
     state.setProperty (CompositionIDs::Tempo, newTemp, undoManager);
 }
 
+juce::uint32 Composition::getSeed() const
+{
+    return static_cast<juce::uint32> (static_cast<juce::int64> (state.getProperty (CompositionIDs::Seed, 0)));
+}
+
+void Composition::setSeed (juce::uint32 newSeed, juce::UndoManager* undoManager)
+{
+    if (newSeed == 0)
+        state.removeProperty (CompositionIDs::Seed, undoManager);
+    else
+        state.setProperty (CompositionIDs::Seed, static_cast<juce::int64> (newSeed), undoManager);
+}
+
 void Composition::valueTreeChildAdded (juce::ValueTree& parentTree,
                                        juce::ValueTree& childWhichHasBeenAdded)
 {
@@ -59,7 +196,10 @@ void Composition::valueTreeChildAdded (juce::ValueTree& parentTree,
         auto sequence = std::make_unique<Sequence> (childWhichHasBeenAdded);
         sequences.emplace_back (std::move (sequence));
     }
-    setIsDirty (true);
+
+    // Bulk note edits report once, when the whole batch has been applied
+    if (! NoteEditBatch::isApplying())
+        setIsDirty (true);
 }
 
 void Composition::valueTreeChildRemoved (juce::ValueTree& parentTree,
@@ -71,13 +211,16 @@ void Composition::valueTreeChildRemoved (juce::ValueTree& parentTree,
         std::erase_if (sequences, [&] (const auto& sequence)
                        { return sequence->getState() == childWhichHasBeenRemoved; });
     }
-    setIsDirty (true);
+
+    if (! NoteEditBatch::isApplying())
+        setIsDirty (true);
 }
 
 void Composition::valueTreePropertyChanged (juce::ValueTree& treeWhosePropertyHasChanged,
                                             const juce::Identifier& property)
 {
-    setIsDirty (true);
+    if (! NoteEditBatch::isApplying())
+        setIsDirty (true);
 }
 
 void Composition::valueTreeChildOrderChanged (ValueTree& treeWhichChildrenBelongTo,
@@ -103,83 +246,146 @@ const std::vector<std::unique_ptr<Sequence>>& Composition::getSequences() const
     return sequences;
 }
 
-std::vector<MidiNote> Composition::extractMidiSequenceForBeatRange (size_t seqIndex, double startBeat, double endBeat, double tempo)
+std::vector<MidiNote> Composition::extractMidiSequenceForBeatRange (size_t seqIndex,
+                                                                 double startBeat,
+                                                                 double endBeat,
+                                                                 double tempo,
+                                                                 const std::function<bool (const Note&)>& filter,
+                                                                 const TrigCondition::Context& context,
+                                                                 bool includeGenerated,
+                                                                 std::vector<const Note*>* considered)
 {
     std::vector<MidiNote> midiClip;
 
     auto& seq = getSequence (seqIndex);
     double loopLengthBeats = seq.getLengthBeats();
-    
+    const auto& groove = seq.getGroove();
+
     // Clear any stale triggered state from previous scheduling passes
     for (auto& n : seq.notes)
     {
-        n->clearLastTriggeredMidiNote();
+        if (filter == nullptr || filter (*n))
+            n->clearLastTriggeredMidiNote();
     }
 
-    // Convert global beats to loop-local beats
-    double localStartBeat = std::fmod (startBeat, loopLengthBeats);
-    double localEndBeat = localStartBeat + (endBeat - startBeat);
+    // Windows and loops are measured in whole ticks, so back-to-back windows
+    // split the timeline exactly and loops of any length (7/12 of a beat, an
+    // 11-step tuplet) stay in phase however long playback runs
+    auto loopTicks = Ticks::fromBeats (loopLengthBeats);
+    auto startTick = Ticks::fromBeats (startBeat);
+    auto windowTicks = Ticks::fromBeats (endBeat) - startTick;
 
-    // Handle wraparound case where we need notes from multiple loop iterations
-    bool wrapsAround = localEndBeat > loopLengthBeats;
+    if (loopTicks <= 0 || windowTicks <= 0)
+        return midiClip;
+
+    // Passes of the loop since playback started, for trig conditions
+    auto playStartTick = Ticks::fromBeats (context.originBeat);
+    auto originPass = Ticks::floorDiv (playStartTick, loopTicks);
+    auto getLoopPass = [&] (Ticks::Count tick)
+    { return juce::jmax (Ticks::Count { 0 }, Ticks::floorDiv (tick, loopTicks) - originPass); };
+
+    // Generated patterns start with the pass playback started in
+    if (includeGenerated && seq.isGenerative())
+        appendGeneratedNotes (seq, originPass * loopTicks, startTick, windowTicks, loopTicks, playStartTick, tempo, midiClip);
+
+    struct ConditionalNote
+    {
+        MidiNote midi;
+        Note* note;
+        juce::int64 pass;
+    };
+    std::vector<ConditionalNote> conditional;
+
+    // Occurrences are looked for this far beyond each end of the window, so
+    // one the groove moves into it from a neighbouring window is found
+    auto reachTicks = Ticks::fromBeats (groove.getMaxOffsetBeats());
 
     for (auto& n : seq.notes)
     {
+        if (filter != nullptr && ! filter (*n))
+            continue;
+
+        if (considered != nullptr)
+            considered->push_back (n.get());
+
         auto midi = n->asMidiNote (seq.getTimeline(), seq.getScale(), tempo, seq.getRootNote());
 
         if (! midi)
             continue;
 
-        double noteStartBeat = midi->startTime / (60.0 / tempo); // Convert seconds back to beats
+        // Note positions are stored in beats
+        double noteStartBeat = n->getStartTime();
+        auto noteTick = Ticks::fromBeats (noteStartBeat);
 
-        // Check if note falls within the requested range
-        bool inRange = false;
-        double adjustedStartTime = 0.0;
+        // Store the post-modifier result on the note for the UI to read for visualisation
+        // Use loop-local start time in seconds so it's directly comparable to
+        // the looped playhead position in SequenceComponent::paint
+        bool triggered = false;
 
-        if (wrapsAround)
-        {
-            // Need to check both before and after wraparound
-            if (noteStartBeat >= localStartBeat && noteStartBeat < loopLengthBeats)
-            {
-                // Note is in the first part (before wrap)
-                inRange = true;
-                adjustedStartTime = noteStartBeat - localStartBeat;
-            }
-            else if (noteStartBeat < (localEndBeat - loopLengthBeats))
-            {
-                // Note is in the wrapped part (after wrap)
-                inRange = true;
-                adjustedStartTime = (loopLengthBeats - localStartBeat) + noteStartBeat;
-            }
-        }
-        else
+        // Every occurrence in the window: a loop shorter than the window plays more than once
+        for (auto offset = Ticks::wrap (noteTick - startTick + reachTicks, loopTicks) - reachTicks; offset < windowTicks + reachTicks; offset += loopTicks)
         {
-            // No wraparound - simple range check
-            if (noteStartBeat >= localStartBeat && noteStartBeat < localEndBeat)
+            // Measured from the window start through whole ticks, so nothing accumulates
+            auto noteTickInTransport = startTick + offset;
+            auto grooved = getGroovedOffset (groove, noteTickInTransport, noteStartBeat, startTick, windowTicks, playStartTick);
+
+            if (! grooved)
+                continue;
+
+            if (! triggered)
             {
-                inRange = true;
-                adjustedStartTime = noteStartBeat - localStartBeat;
+                MidiNote shown = *midi;
+                shown.startTime = noteStartBeat * (60.0 / tempo);
+                n->setLastTriggeredMidiNote (shown);
+                triggered = true;
             }
+
+            // Do not schedule muted notes for playback, but still allow the UI to show them
+            if (midi->isMuted)
+                break;
+
+            double adjustedStartTime = Ticks::toBeats (*grooved);
+
+            MidiNote scheduled = *midi;
+            scheduled.startTime = adjustedStartTime * (60.0 / tempo);
+
+            if (scheduled.condition == 0)
+                midiClip.push_back (scheduled);
+            else
+                conditional.push_back ({ scheduled, n.get(), getLoopPass (noteTickInTransport) });
         }
+    }
 
-        if (inRange)
-        {
-            // Convert adjusted beat time back to seconds
-            double adjustedStartTimeSeconds = adjustedStartTime * (60.0 / tempo);
+    // Conditions are evaluated in time order, so Pre sees the note before it
+    std::stable_sort (conditional.begin(), conditional.end(), [] (const auto& a, const auto& b)
+                      { return a.midi.startTime < b.midi.startTime; });
 
-            // Store the post-modifier result on the note for the UI to read for visualisation
-            // Use loop-local start time in seconds so it's directly comparable to
-            // the looped playhead position in SequenceComponent::paint
-            MidiNote triggered = *midi;
-            triggered.startTime = noteStartBeat * (60.0 / tempo);
-            n->setLastTriggeredMidiNote (triggered);
+    // Only a full pass moves the sequence's Pre state on: a live edit
+    // re-extracts a few notes of a window that was already evaluated
+    bool lastPassed = seq.lastConditionPassed;
 
-            // Do not schedule muted notes for playback, but still allow the UI to show them
-            if (! midi->isMuted)
-                midiClip.emplace_back (adjustedStartTimeSeconds, midi->noteNumber, midi->velocity, midi->duration);
+    for (auto& [midi, note, pass] : conditional)
+    {
+        auto type = TrigCondition::fromIndex (midi.condition);
+        bool plays = TrigCondition::evaluate (type, midi.conditionA, midi.conditionB, pass, context.fill, lastPassed);
+
+        if (TrigCondition::updatesPrevious (type))
+            lastPassed = plays;
+
+        if (plays)
+        {
+            midiClip.push_back (midi);
+        }
+        else if (note->lastTriggeredMidiNote.has_value())
+        {
+            // Shown like a muted note
+            note->lastTriggeredMidiNote->isMuted = true;
         }
     }
 
+    if (filter == nullptr)
+        seq.lastConditionPassed = lastPassed;
+
     return midiClip;
 }
 
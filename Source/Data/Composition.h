@@ -1,6 +1,8 @@
 #pragma once
 
+#include "Data/Scene.h"
 #include "Data/Sequence.h"
+#include "Data/TrigCondition.h"
 #include "juce_data_structures/juce_data_structures.h"
 
 namespace CompositionIDs
@@ -9,6 +11,7 @@ namespace CompositionIDs
 DECLARE_ID (Composition)
 DECLARE_ID (Tempo)
 DECLARE_ID (Sequences)
+DECLARE_ID (Seed)
 #undef DECLARE_ID
 
 } // namespace CompositionIDs
@@ -25,11 +28,36 @@ public:
     double getTempo() const;
     void setTempo (double newTemp, juce::UndoManager* undoManager = nullptr);
 
+    // Seeds the random modifiers so playback repeats exactly; 0 leaves them unseeded
+    juce::uint32 getSeed() const;
+    void setSeed (juce::uint32 newSeed, juce::UndoManager* undoManager = nullptr);
+
     juce::ValueTree getSequencesState();
+
+    // Song sections, in play order
+    int getNumScenes() const;
+    Scene getScene (int index) const;
+    Scene addScene (juce::uint32 trackMask, juce::UndoManager* undoManager = nullptr);
+    void removeScene (int index, juce::UndoManager* undoManager = nullptr);
     Sequence& getSequence (size_t index) const;
     const std::vector<std::unique_ptr<Sequence>>& getSequences() const;
 
-    std::vector<MidiNote> extractMidiSequenceForBeatRange (size_t seqIndex, double startBeat, double endBeat, double tempo);
+    // Notes starting in [startBeat, endBeat) once the groove has moved them,
+    // relative to startBeat; back-to-back ranges play each note once. With a
+    // filter, only the notes it accepts are extracted (and have their
+    // triggered state touched). Notes with a trig condition are dropped on
+    // the passes it rules out. A generative sequence's pattern is generated
+    // for the range alone, when includeGenerated is set. Every note the filter
+    // accepts is added to considered, including those muted or dropped by
+    // probability or condition
+    std::vector<MidiNote> extractMidiSequenceForBeatRange (size_t seqIndex,
+                                                           double startBeat,
+                                                           double endBeat,
+                                                           double tempo,
+                                                           const std::function<bool (const Note&)>& filter = nullptr,
+                                                           const TrigCondition::Context& context = {},
+                                                           bool includeGenerated = true,
+                                                           std::vector<const Note*>* considered = nullptr);
 
     void valueTreeChildAdded (juce::ValueTree& parentTree,
                               juce::ValueTree& childWhichHasBeenAdded) override;
@@ -9,6 +9,8 @@
 */
 
 #include "Cursor.h"
+#include "Data/GeneratorRegistry.h"
+#include "Data/Generators.h"
 #include "Data/Note.h"
 #include "Data/Scale.h"
 #include "Data/Selection.h"
@@ -54,99 +56,114 @@ bool Cursor::isSequenceSelected (const Sequence& otherSequence) const
     return &selectedSequence == &otherSequence;
 }
 
-void Cursor::moveCursorSelection (Direction d)
+void Cursor::moveCursorSelection (Direction d, int count)
 {
-    // Check if the selection can move before doing anything
-    if (! shouldWrap && ! visualSelection.canSelectionMove (getCurrentTimeline(), getCurrentScale(), d))
+    // Without wrapping, only move as far as the selection can go before hitting a boundary
+    int steps = count;
+
+    if (! shouldWrap)
+    {
+        auto probe = visualSelection;
+        steps = 0;
+
+        while (steps < count && probe.canSelectionMove (getCurrentTimeline(), getCurrentScale(), d))
+        {
+            probe.moveSelection (getCurrentTimeline(), getCurrentScale(), d, shouldWrap);
+            ++steps;
+        }
+    }
+
+    if (steps <= 0)
         return;
 
-    moveNotesInSelection (d);
-    move (d, Selection::MoveMode::shift);
+    moveNotesInSelection (d, steps);
+    move (d, Selection::MoveMode::shift, steps);
 }
 
-void Cursor::moveNotesInSelection (Direction d)
+void Cursor::moveNotesInSelection (Direction d, int count)
 {
-    undoManager.beginNewTransaction ("moveNotesInSelection");
     auto& seq = getSelectedSequence();
-    std::vector<Note*> notesToMove;
+    auto batch = seq.createEditBatch ("moveNotesInSelection");
 
-    // Collect notes first, then move. Otherwise we are continually adding the notes we have just moved.
-    for (const Position& pos : getVisualSelectionPositions())
+    // Changes are collected first and applied together, so moved notes are never re-visited.
+    // Only notes on the selected cells move; off-grid notes stay where they are
+    for (auto& note : seq.notes)
     {
-        for (auto& note : seq.notes)
-        {
-            if (Division::isEqual (pos.xTimepoint.value, note->getStartTime())
-                && Division::isEqual (pos.yDegree.value, note->getDegree()))
-            {
-                notesToMove.push_back (note.get());
-            }
-        }
-    }
+        if (! visualSelection.containsCell (note->getStartTime(), note->getDegree()))
+            continue;
 
-    for (auto* note : notesToMove)
-    {
         switch (d)
         {
             case Direction::left:
             {
-                TimePoint currentTime (note->getStartTime());
-                TimePoint newTime = seq.getTimeline().getPrevStep (currentTime, shouldWrap);
-                note->setStartTime (newTime.value, &undoManager);
+                TimePoint newTime (note->getStartTime());
+                for (int i = 0; i < count; ++i)
+                    newTime = seq.getTimeline().getPrevStep (newTime, shouldWrap);
+                batch.setProperty (note->getState(), NoteIDs::StartTime, newTime.value);
                 break;
             }
             case Direction::right:
             {
-                TimePoint currentTime (note->getStartTime());
-                TimePoint newTime = seq.getTimeline().getNextStep (currentTime, shouldWrap);
-                note->setStartTime (newTime.value, &undoManager);
+                TimePoint newTime (note->getStartTime());
+                for (int i = 0; i < count; ++i)
+                    newTime = seq.getTimeline().getNextStep (newTime, shouldWrap);
+                batch.setProperty (note->getState(), NoteIDs::StartTime, newTime.value);
                 break;
             }
             case Direction::up:
             {
-                Degree currentDeg = note->getDegree();
-                Degree higherDeg = seq.getScale().getHigher (currentDeg, shouldWrap);
-                note->setDegree (higherDeg.value, &undoManager);
+                Degree higherDeg = note->getDegree();
+                for (int i = 0; i < count; ++i)
+                    higherDeg = seq.getScale().getHigher (higherDeg, shouldWrap);
+                batch.setProperty (note->getState(), NoteIDs::Degree, higherDeg.value);
                 break;
             }
             case Direction::down:
             {
-                Degree currentDeg = note->getDegree();
-                Degree lowerDeg = seq.getScale().getLower (currentDeg, shouldWrap);
-                note->setDegree (lowerDeg.value, &undoManager);
+                Degree lowerDeg = note->getDegree();
+                for (int i = 0; i < count; ++i)
+                    lowerDeg = seq.getScale().getLower (lowerDeg, shouldWrap);
+                batch.setProperty (note->getState(), NoteIDs::Degree, lowerDeg.value);
                 break;
             }
             default:
                 break;
         }
     }
+
+    commitNoteEdits (batch, true);
 }
 
 // Moves the cursor and relevant cursor selection
 // If in a visual mode, new notes will be added to the selection if they fall within the boundary
 // TODO: Also remove notes from selection?
-void Cursor::move (Direction dir, Selection::MoveMode moveMode)
+void Cursor::move (Direction dir, Selection::MoveMode moveMode, int count)
 {
-    switch (dir)
+    for (int i = 0; i < count; ++i)
     {
-        case Direction::left:
-            cursorPosition.xTimepoint = getCurrentTimeline().getPrevStep (cursorPosition.xTimepoint, shouldWrap);
-            break;
-        case Direction::right:
-            cursorPosition.xTimepoint = getCurrentTimeline().getNextStep (cursorPosition.xTimepoint, shouldWrap);
-            break;
-        case Direction::up:
-            cursorPosition.yDegree = getCurrentScale().getHigher (cursorPosition.yDegree, shouldWrap);
-            break;
-        case Direction::down:
-            cursorPosition.yDegree = getCurrentScale().getLower (cursorPosition.yDegree, shouldWrap);
-            break;
-        default:
-            break;
+        switch (dir)
+        {
+            case Direction::left:
+                cursorPosition.xTimepoint = getCurrentTimeline().getPrevStep (cursorPosition.xTimepoint, shouldWrap);
+                break;
+            case Direction::right:
+                cursorPosition.xTimepoint = getCurrentTimeline().getNextStep (cursorPosition.xTimepoint, shouldWrap);
+                break;
+            case Direction::up:
+                cursorPosition.yDegree = getCurrentScale().getHigher (cursorPosition.yDegree, shouldWrap);
+                break;
+            case Direction::down:
+                cursorPosition.yDegree = getCurrentScale().getLower (cursorPosition.yDegree, shouldWrap);
+                break;
+            default:
+                break;
+        }
     }
 
     if (moveMode == Selection::MoveMode::shift)
     {
-        visualSelection.moveSelection (getCurrentTimeline(), getCurrentScale(), dir, shouldWrap);
+        for (int i = 0; i < count; ++i)
+            visualSelection.moveSelection (getCurrentTimeline(), getCurrentScale(), dir, shouldWrap);
     }
     else if (moveMode == Selection::MoveMode::extend)
     {
@@ -157,7 +174,7 @@ void Cursor::move (Direction dir, Selection::MoveMode moveMode)
 
         if (isVisualBlockMode())
         {
-            visualSelection.addToVisualBlockSelection (cursorPosition, getCurrentTimeline(), getCurrentScale(), shouldWrap);
+            visualSelection.addToVisualBlockSelection (cursorPosition, getCurrentTimeline());
         }
     }
 }
@@ -201,7 +218,7 @@ void Cursor::enableVisualLineMode()
 void Cursor::enableVisualBlockMode()
 {
     mode = Mode::visualBlock;
-    visualSelection.addToVisualBlockSelection (cursorPosition, getCurrentTimeline(), getCurrentScale(), shouldWrap);
+    visualSelection.addToVisualBlockSelection (cursorPosition, getCurrentTimeline());
 }
 
 void Cursor::enableInsertMode()
@@ -291,15 +308,107 @@ void Cursor::removeNotesAtCursor()
     }
     else if (isVisualLineMode() || isVisualBlockMode())
     {
-        double degMin = visualSelection.getLowestPosition().yDegree.value;
-        double degMax = visualSelection.getHighestPosition().yDegree.value;
-        double timeStart = visualSelection.getEarliestPosition().xTimepoint.value;
-        double timeEnd = visualSelection.getLatestPosition().xTimepoint.value + getCurrentTimeline().getStepSize();
+        auto batch = getSelectedSequence().createEditBatch ("removeNotes");
 
-        getSelectedSequence().removeNotes (timeStart, timeEnd, degMin, degMax, &undoManager);
+        for (auto& ref : findNotesInCursorSelection())
+            batch.removeNote (ref.get()->getState());
+
+        commitNoteEdits (batch);
     }
 }
 
+void Cursor::removeNotesInColumns (int count)
+{
+    auto notes = findNotesInColumns (count);
+    if (notes.empty())
+        return;
+
+    auto batch = getSelectedSequence().createEditBatch ("removeColumns");
+
+    for (auto& ref : notes)
+        batch.removeNote (ref.get()->getState());
+
+    commitNoteEdits (batch);
+}
+
+void Cursor::yankColumns (int count)
+{
+    yankNotes (findNotesInColumns (count), cursorPosition.xTimepoint.value, cursorPosition.yDegree.value);
+}
+
+void Cursor::shiftNotes (int steps)
+{
+    if (steps == 0)
+        return;
+
+    auto dir = steps > 0 ? Direction::right : Direction::left;
+    auto count = std::abs (steps);
+
+    if (isVisualLineMode() || isVisualBlockMode())
+    {
+        moveCursorSelection (dir, count);
+        return;
+    }
+
+    auto notes = findNotesAtCursor();
+    if (notes.empty())
+        return;
+
+    auto& timeline = getCurrentTimeline();
+    TimePoint newTime = cursorPosition.xTimepoint;
+
+    for (int i = 0; i < count; ++i)
+    {
+        auto next = steps > 0 ? timeline.getNextStep (newTime, shouldWrap) : timeline.getPrevStep (newTime, shouldWrap);
+        if (juce::approximatelyEqual (next.value, newTime.value))
+            break;
+        newTime = next;
+    }
+
+    auto batch = getSelectedSequence().createEditBatch ("shiftNotes");
+
+    for (auto& ref : notes)
+        batch.setProperty (ref.get()->getState(), NoteIDs::StartTime, newTime.value);
+
+    commitNoteEdits (batch, true);
+    cursorPosition.xTimepoint = newTime;
+}
+
+int Cursor::writeGeneratedNotes (const juce::ValueTree& generatorState)
+{
+    auto& seq = getSelectedSequence();
+    auto& timeline = getCurrentTimeline();
+    auto& scale = getCurrentScale();
+
+    auto stepTicks = Ticks::fromBeats (timeline.getStepSize());
+    if (stepTicks <= 0)
+        return 0;
+
+    auto numSteps = juce::jmax<Ticks::Count> (1, Ticks::floorDiv (Ticks::fromBeats (timeline.getUpperBound()) + stepTicks - 1, stepTicks));
+    GeneratorContext context { 0, numSteps, Generators::getScaleStepsPerOctave (scale) };
+    auto generated = GeneratorRegistry::getInstance().generate (generatorState, context);
+
+    auto batch = seq.createEditBatch ("generate");
+
+    for (const auto& note : seq.notes)
+        batch.removeNote (note->getState());
+
+    for (const auto& g : generated)
+    {
+        juce::ValueTree noteState (NoteIDs::Note);
+
+        noteState.setProperty (NoteIDs::Degree, Generators::getDegree (scale, g.scaleStep), nullptr);
+        noteState.setProperty (NoteIDs::StartTime, Ticks::toBeats (g.step * stepTicks), nullptr);
+        noteState.setProperty (NoteIDs::Duration, Ticks::toBeats (g.lengthSteps * stepTicks), nullptr);
+        noteState.setProperty (NoteIDs::Velocity, juce::jlimit (1, 127, g.velocity), nullptr);
+
+        batch.addNote (noteState);
+    }
+
+    commitNoteEdits (batch);
+    return static_cast<int> (generated.size());
+}
+
 const juce::String Cursor::readableCursorPosition() const
 {
     return juce::String (cursorPosition.yDegree.value) + " :: " + juce::String (cursorPosition.xTimepoint.value);
@@ -317,77 +426,81 @@ void Cursor::increaseTimelineStepSize() { getSelectedSequence().increaseTimeline
 
 void Cursor::decreaseTimelineStepSize() { getSelectedSequence().decreaseTimelineStepSize(); }
 
-void Cursor::increaseNoteVelocity()
+void Cursor::increaseNoteVelocity (int count)
 {
     auto notes = findNotesForCursorMode();
     if (notes.empty())
         return;
-    undoManager.beginNewTransaction ("increaseNoteVelocity");
+    auto batch = getSelectedSequence().createEditBatch ("increaseNoteVelocity");
     for (auto& ref : notes)
     {
         auto& note = *ref.get();
-        note.setVelocity (juce::jlimit (0, 127, note.getVelocity() + 10), &undoManager);
+        batch.setProperty (note.getState(), NoteIDs::Velocity, juce::jlimit (0, 127, note.getVelocity() + 10 * count));
     }
+    commitNoteEdits (batch, true);
 }
 
-void Cursor::decreaseNoteVelocity()
+void Cursor::decreaseNoteVelocity (int count)
 {
     auto notes = findNotesForCursorMode();
     if (notes.empty())
         return;
-    undoManager.beginNewTransaction ("decreaseNoteVelocity");
+    auto batch = getSelectedSequence().createEditBatch ("decreaseNoteVelocity");
     for (auto& ref : notes)
     {
         auto& note = *ref.get();
-        note.setVelocity (juce::jlimit (0, 127, note.getVelocity() - 10), &undoManager);
+        batch.setProperty (note.getState(), NoteIDs::Velocity, juce::jlimit (0, 127, note.getVelocity() - 10 * count));
     }
+    commitNoteEdits (batch, true);
 }
 
-void Cursor::increaseNoteDuration()
+void Cursor::increaseNoteDuration (int count)
 {
     auto notes = findNotesForCursorMode();
     if (notes.empty())
         return;
     double stepSize = getCurrentTimeline().getStepSize();
-    undoManager.beginNewTransaction ("increaseNoteDuration");
+    auto batch = getSelectedSequence().createEditBatch ("increaseNoteDuration");
     for (auto& ref : notes)
     {
         auto& note = *ref.get();
-        note.setDuration (note.getDuration() + stepSize, &undoManager);
+        batch.setProperty (note.getState(), NoteIDs::Duration, note.getDuration() + stepSize * count);
     }
+    commitNoteEdits (batch, true);
 }
 
-void Cursor::decreaseNoteDuration()
+void Cursor::decreaseNoteDuration (int count)
 {
     auto notes = findNotesForCursorMode();
     if (notes.empty())
         return;
     double stepSize = getCurrentTimeline().getStepSize();
-    undoManager.beginNewTransaction ("decreaseNoteDuration");
+    auto batch = getSelectedSequence().createEditBatch ("decreaseNoteDuration");
     for (auto& ref : notes)
     {
         auto& note = *ref.get();
-        note.setDuration (std::max (note.getDuration() - stepSize, stepSize), &undoManager);
+        batch.setProperty (note.getState(), NoteIDs::Duration, std::max (note.getDuration() - stepSize * count, stepSize));
     }
+    commitNoteEdits (batch, true);
 }
 
 void Cursor::increaseRootNote (int semitones)
 {
     auto& seq = getSelectedSequence();
-    undoManager.beginNewTransaction ("increaseRootNote");
+    undoManager.beginCoalescedTransaction ("increaseRootNote");
     seq.setRootNote (juce::jlimit (0, 127, seq.getRootNote() + semitones), &undoManager);
 }
 
 void Cursor::decreaseRootNote (int semitones)
 {
     auto& seq = getSelectedSequence();
-    undoManager.beginNewTransaction ("decreaseRootNote");
+    undoManager.beginCoalescedTransaction ("decreaseRootNote");
     seq.setRootNote (juce::jlimit (0, 127, seq.getRootNote() - semitones), &undoManager);
 }
 
-const std::vector<Position>& Cursor::getVisualSelectionPositions() const
+const std::vector<SelectionRange>& Cursor::getVisualSelectionRanges() const
 {
-    return visualSelection.getPositions();
+    return visualSelection.getRanges();
 }
 
 void Cursor::toggleLineMode() { visualSelection.toggleLineMode (cursorPosition, getCurrentTimeline(), getCurrentScale()); }
@@ -413,6 +526,14 @@ std::vector<std::reference_wrapper<std::unique_ptr<Note>>> Cursor::findNotesAtPo
     return getSelectedSequence().findNotes (minTime, maxTime, minDegree, maxDegree);
 }
 
+std::vector<std::reference_wrapper<std::unique_ptr<Note>>> Cursor::findNotesInColumns (int count) const
+{
+    auto start = cursorPosition.xTimepoint.value;
+    auto end = juce::jmin (start + getCurrentTimeline().getStepSize() * count, getCurrentTimeline().getUpperBound());
+
+    return getSelectedSequence().findNotes (start, end, getCurrentScale().getLowerBound(), getCurrentScale().getUpperBound());
+}
+
 std::vector<std::reference_wrapper<std::unique_ptr<Note>>> Cursor::findNotesAtCursor() const
 {
     return getSelectedSequence().findNotes (cursorPosition.xTimepoint.value,
@@ -423,10 +544,15 @@ std::vector<std::reference_wrapper<std::unique_ptr<Note>>> Cursor::findNotesAtCu
 
 std::vector<std::reference_wrapper<std::unique_ptr<Note>>> Cursor::findNotesInCursorSelection() const
 {
-    return getSelectedSequence().findNotes (visualSelection.getEarliestPosition().xTimepoint.value,
-                                            visualSelection.getLatestPosition().xTimepoint.value + getCurrentTimeline().getStepSize(),
-                                            visualSelection.getLowestPosition().yDegree.value,
-                                            visualSelection.getHighestPosition().yDegree.value);
+    std::vector<std::reference_wrapper<std::unique_ptr<Note>>> result;
+
+    for (auto& note : getSelectedSequence().notes)
+    {
+        if (visualSelection.contains (note->getStartTime(), note->getDegree()))
+            result.push_back (std::ref (note));
+    }
+
+    return result;
 }
 
 std::vector<std::reference_wrapper<std::unique_ptr<Note>>> Cursor::findNotesForCursorMode() const
@@ -440,10 +566,7 @@ std::vector<std::reference_wrapper<std::unique_ptr<Note>>> Cursor::findNotesForC
     }
     else if (isVisualBlockMode() || isVisualLineMode())
     {
-        return getSelectedSequence().findNotes (visualSelection.getEarliestPosition().xTimepoint.value,
-                                                visualSelection.getLatestPosition().xTimepoint.value + getCurrentTimeline().getStepSize(),
-                                                visualSelection.getLowestPosition().yDegree.value,
-                                                visualSelection.getHighestPosition().yDegree.value);
+        return findNotesInCursorSelection();
     }
 
     return {};
@@ -456,7 +579,7 @@ int Cursor::addModifier (ModifierType t)
     if (notes.size() == 0)
         return 0;
 
-    undoManager.beginNewTransaction ("addModifier");
+    undoManager.beginTransaction ("addModifier");
 
     Modifier m = Modifier { t };
 
@@ -475,7 +598,7 @@ int Cursor::removeModifier (ModifierType t)
     if (notes.size() == 0)
         return 0;
 
-    undoManager.beginNewTransaction ("removeModifier");
+    undoManager.beginTransaction ("removeModifier");
 
     for (auto& note : notes)
     {
@@ -510,8 +633,11 @@ Scale& Cursor::getCurrentScale()
 
 void Cursor::yankNotes (double originTimepoint, double originDegree)
 {
-    auto notes = findNotesForCursorMode();
+    yankNotes (findNotesForCursorMode(), originTimepoint, originDegree);
+}
 
+void Cursor::yankNotes (const std::vector<std::reference_wrapper<std::unique_ptr<Note>>>& notes, double originTimepoint, double originDegree)
+{
     clipboard = juce::ValueTree (CursorIDs::YankModeNotes);
 
     juce::ValueTree yankedNotes (CursorIDs::YankedNotes);
@@ -555,7 +681,11 @@ void Cursor::paste()
     if (! yankedNotes.isValid())
         return;
 
-    undoManager.beginNewTransaction ("paste");
+    auto& seq = getSelectedSequence();
+    auto batch = seq.createEditBatch ("paste");
+
+    // Cells already filled by this paste, so overlapping clipboard notes land once
+    std::vector<std::pair<double, double>> pastedCells;
 
     for (auto note : yankedNotes)
     {
@@ -588,8 +718,60 @@ void Cursor::paste()
         pastedNote.removeProperty (CursorIDs::YankedNoteTimepointOffset, nullptr);
         pastedNote.removeProperty (CursorIDs::YankedNoteDegreeOffset, nullptr);
 
-        getSelectedSequence().insertNote (pastedNote, &undoManager);
+        bool alreadyPasted = std::any_of (pastedCells.begin(), pastedCells.end(), [&] (const auto& cell)
+                                          { return juce::approximatelyEqual (cell.first, newStartTime) && juce::approximatelyEqual (cell.second, newDegree.value); });
+
+        if (alreadyPasted || seq.isExistingNote (pastedNote))
+            continue;
+
+        pastedCells.emplace_back (newStartTime, newDegree.value);
+        batch.addNote (pastedNote);
     }
+
+    commitNoteEdits (batch);
+}
+
+void Cursor::commitNoteEdits (NoteEditBatch& batch, bool coalesceRepeats)
+{
+    if (batch.isEmpty())
+        return;
+
+    auto targets = batch.getTargets();
+
+    bool repeatsLastEdit = coalesceRepeats
+                           && ! undoManager.canRedo()
+                           && undoManager.getUndoDescription() == batch.getName()
+                           && targets == lastCoalescedTargets;
+
+    if (! repeatsLastEdit)
+        undoManager.beginTransaction (batch.getName());
+
+    lastCoalescedTargets = coalesceRepeats ? std::move (targets) : std::vector<juce::ValueTree> {};
+
+    batch.commit (&undoManager);
+}
+
+void Cursor::beginRecordingTake()
+{
+    recordingTakeOpen = false;
+}
+
+void Cursor::commitRecordedNotes (NoteEditBatch& batch)
+{
+    if (batch.isEmpty())
+        return;
+
+    bool continuesTake = recordingTakeOpen
+                         && ! undoManager.canRedo()
+                         && undoManager.getUndoDescription() == batch.getName();
+
+    if (! continuesTake)
+        undoManager.beginTransaction (batch.getName());
+
+    recordingTakeOpen = true;
+    lastCoalescedTargets.clear();
+
+    batch.commit (&undoManager);
 }
 
 juce::ValueTree Cursor::getClipboard()
@@ -601,3 +783,13 @@ juce::UndoManager* Cursor::getUndoManager()
 {
     return &undoManager;
 }
+
+UndoHistory& Cursor::getUndoHistory()
+{
+    return undoManager;
+}
+
+const UndoHistory& Cursor::getUndoHistory() const
+{
+    return undoManager;
+}
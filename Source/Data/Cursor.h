@@ -12,6 +12,7 @@
 #include "Data/Scale.h"
 #include "Data/Selection.h"
 #include "Data/Timeline.h"
+#include "Data/UndoHistory.h"
 #include "Note.h"
 #include "Sequence.h"
 #include "juce_data_structures/juce_data_structures.h"
@@ -54,10 +55,11 @@ public:
     void undo();
     void redo();
 
-    void move (Direction dir, Selection::MoveMode moveMode = Selection::MoveMode::extend);
+    // A count moves that many steps at once, e.g. from a "6j" key sequence
+    void move (Direction dir, Selection::MoveMode moveMode = Selection::MoveMode::extend, int count = 1);
 
-    void moveCursorSelection (Direction d);
-    void moveNotesInSelection (Direction d);
+    void moveCursorSelection (Direction d, int count = 1);
+    void moveNotesInSelection (Direction d, int count = 1);
 
     void removeNote();
     void enableNormalMode();
@@ -84,6 +86,19 @@ public:
     void insertNote();
     void removeNotesAtCursor();
 
+    // Column operations over count steps from the cursor, across every degree
+    void removeNotesInColumns (int count = 1);
+    void yankColumns (int count = 1);
+
+    // Moves the notes under the cursor, or the visual selection, by a number of
+    // steps in time (negative is earlier) as one edit, taking the cursor along
+    void shiftNotes (int steps);
+
+    // Replaces the selected sequence's notes with a generator's pattern over
+    // its whole length, on the current step grid, as one undoable edit.
+    // Returns the number of notes written
+    int writeGeneratedNotes (const juce::ValueTree& generatorState);
+
     const juce::String readableCursorPosition() const;
 
     bool isNormalMode() const;
@@ -97,21 +112,26 @@ public:
     void increaseTimelineStepSize();
     void decreaseTimelineStepSize();
 
-    void increaseNoteVelocity();
-    void decreaseNoteVelocity();
-    void increaseNoteDuration();
-    void decreaseNoteDuration();
+    void increaseNoteVelocity (int count = 1);
+    void decreaseNoteVelocity (int count = 1);
+    void increaseNoteDuration (int count = 1);
+    void decreaseNoteDuration (int count = 1);
 
     void increaseRootNote (int semitones = 1);
     void decreaseRootNote (int semitones = 1);
 
+    // Notes recorded from MIDI input. Everything committed between calls to
+    // beginRecordingTake() undoes as one step, unless another edit intervenes
+    void beginRecordingTake();
+    void commitRecordedNotes (NoteEditBatch& batch);
+
     void yankNotes (double originTimepoint, double originDegree);
     void yank (juce::Identifier yankMode);
     void paste();
 
     void toggleLineMode();
 
-    const std::vector<Position>& getVisualSelectionPositions() const;
+    const std::vector<SelectionRange>& getVisualSelectionRanges() const;
     Position getVisualSelectionOpposite();
 
     int addModifier (ModifierType t);
@@ -129,11 +149,13 @@ public:
     juce::ValueTree getClipboard();
 
     juce::UndoManager* getUndoManager();
+    UndoHistory& getUndoHistory();
+    const UndoHistory& getUndoHistory() const;
 
 private:
     Composition& composition;
 
-    juce::UndoManager undoManager;
+    UndoHistory undoManager;
 
     std::mt19937 randomGenerator;
 
@@ -150,6 +172,17 @@ private:
     bool shouldWrap { true };
 
     std::vector<std::reference_wrapper<std::unique_ptr<Note>>> findNotesAtPosition (Position& p, Timeline& t, Scale& s);
+    std::vector<std::reference_wrapper<std::unique_ptr<Note>>> findNotesInColumns (int count) const;
+
+    void yankNotes (const std::vector<std::reference_wrapper<std::unique_ptr<Note>>>& notes, double originTimepoint, double originDegree);
+
+    // Starts a new undo transaction for the batch, unless coalescing is asked
+    // for and the batch repeats the previous edit on the same notes, in which
+    // case it folds into that transaction (one undo step for many nudges)
+    void commitNoteEdits (NoteEditBatch& batch, bool coalesceRepeats = false);
+    std::vector<juce::ValueTree> lastCoalescedTargets;
+
+    bool recordingTakeOpen = false;
 
     juce::ValueTree clipboard;
 };
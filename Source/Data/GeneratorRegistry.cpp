@@ -0,0 +1,244 @@
+#include "GeneratorRegistry.h"
+#include "Data/Generators.h"
+
+GeneratorRegistry& GeneratorRegistry::getInstance()
+{
+    static GeneratorRegistry instance;
+    return instance;
+}
+
+bool GeneratorRegistry::registerGenerator (GeneratorDefinition def)
+{
+    definitions[def.type] = std::move (def);
+    return true;
+}
+
+std::vector<juce::Identifier> GeneratorRegistry::getRegisteredTypes() const
+{
+    std::vector<juce::Identifier> types;
+    types.reserve (definitions.size());
+    for (const auto& [type, def] : definitions)
+    {
+        types.push_back (type);
+    }
+    return types;
+}
+
+const GeneratorDefinition* GeneratorRegistry::getDefinition (const juce::Identifier& type) const
+{
+    auto it = definitions.find (type);
+    if (it != definitions.end())
+    {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+juce::ValueTree GeneratorRegistry::createDefaultState (const juce::Identifier& type) const
+{
+    juce::ValueTree state (type);
+    if (auto* def = getDefinition (type))
+    {
+        // Generators only take single values
+        for (const auto& param : def->params)
+        {
+            if (const auto* p = std::get_if<SingleValueParamDefinition> (&param))
+                state.setProperty (p->id, p->defaultVal, nullptr);
+        }
+    }
+    return state;
+}
+
+std::vector<GeneratedNote> GeneratorRegistry::generate (const juce::ValueTree& state, const GeneratorContext& context) const
+{
+    std::vector<GeneratedNote> notes;
+    auto* def = getDefinition (state.getType());
+
+    if (def == nullptr || def->generate == nullptr || context.endStep <= context.firstStep)
+        return notes;
+
+    def->generate (state, context, notes);
+    return notes;
+}
+
+// ============================================
+// Compile-time registrations
+// ============================================
+namespace
+{
+// Parameters most generators share
+SingleValueParamDefinition pitchParam()
+{
+    return { .id = GeneratorIDs::Pitch,
+             .displayName = "Pitch (scale steps)",
+             .widgetType = ParamWidgetType::slider,
+             .defaultVal = 0.0,
+             .min = -14.0,
+             .max = 14.0,
+             .interval = 1.0 };
+}
+
+SingleValueParamDefinition velocityParam()
+{
+    return { .id = GeneratorIDs::Velocity,
+             .displayName = "Velocity",
+             .widgetType = ParamWidgetType::slider,
+             .defaultVal = 100.0,
+             .min = 1.0,
+             .max = 127.0,
+             .interval = 1.0 };
+}
+
+SingleValueParamDefinition seedParam()
+{
+    return { .id = GeneratorIDs::Seed,
+             .displayName = "Seed",
+             .widgetType = ParamWidgetType::slider,
+             .defaultVal = 1.0,
+             .min = 0.0,
+             .max = 999.0,
+             .interval = 1.0 };
+}
+
+static bool reg0 = GeneratorRegistry::getInstance().registerGenerator ({ .type = GeneratorIDs::Euclidean,
+                                                                         .displayName = "Euclidean",
+                                                                         .description = "Spreads a number of pulses as evenly as possible over a cycle of steps. Rotation moves the pattern later.",
+                                                                         .navShortcutDescription = "e",
+                                                                         .params = {
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Pulses,
+                                                                                                          .displayName = "Pulses",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 5.0,
+                                                                                                          .min = 0.0,
+                                                                                                          .max = 32.0,
+                                                                                                          .interval = 1.0 },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Steps,
+                                                                                                          .displayName = "Steps",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 16.0,
+                                                                                                          .min = 1.0,
+                                                                                                          .max = 32.0,
+                                                                                                          .interval = 1.0 },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Rotation,
+                                                                                                          .displayName = "Rotation",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 0.0,
+                                                                                                          .min = 0.0,
+                                                                                                          .max = 31.0,
+                                                                                                          .interval = 1.0 },
+                                                                             pitchParam(),
+                                                                             velocityParam(),
+                                                                         },
+                                                                         .generate = Generators::euclidean });
+
+static bool reg1 = GeneratorRegistry::getInstance().registerGenerator ({ .type = GeneratorIDs::RandomWalk,
+                                                                         .displayName = "Random Walk",
+                                                                         .description = "Wanders up and down the scale by up to Max Leap steps at a time, staying within Span of the start pitch and returning to it every phrase. Density sets how many steps play.",
+                                                                         .navShortcutDescription = "w",
+                                                                         .params = {
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Density,
+                                                                                                          .displayName = "Density (%)",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 75.0,
+                                                                                                          .min = 0.0,
+                                                                                                          .max = 100.0,
+                                                                                                          .interval = 1.0 },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::MaxLeap,
+                                                                                                          .displayName = "Max Leap",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 2.0,
+                                                                                                          .min = 1.0,
+                                                                                                          .max = 7.0,
+                                                                                                          .interval = 1.0 },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Span,
+                                                                                                          .displayName = "Span",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 7.0,
+                                                                                                          .min = 1.0,
+                                                                                                          .max = 14.0,
+                                                                                                          .interval = 1.0 },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Phrase,
+                                                                                                          .displayName = "Phrase (steps)",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 16.0,
+                                                                                                          .min = 1.0,
+                                                                                                          .max = 64.0,
+                                                                                                          .interval = 1.0 },
+                                                                             pitchParam(),
+                                                                             velocityParam(),
+                                                                             seedParam(),
+                                                                         },
+                                                                         .generate = Generators::randomWalk });
+
+static bool reg2 = GeneratorRegistry::getInstance().registerGenerator ({ .type = GeneratorIDs::Arpeggio,
+                                                                         .displayName = "Arpeggiator",
+                                                                         .description = "Plays a chord of stacked scale thirds one note at a time, over one or more octaves. Rate sets the steps per note.",
+                                                                         .navShortcutDescription = "a",
+                                                                         .params = {
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::ChordSize,
+                                                                                                          .displayName = "Chord Size",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 3.0,
+                                                                                                          .min = 1.0,
+                                                                                                          .max = 7.0,
+                                                                                                          .interval = 1.0 },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Direction,
+                                                                                                          .displayName = "Direction",
+                                                                                                          .widgetType = ParamWidgetType::choice,
+                                                                                                          .defaultVal = 0.0,
+                                                                                                          .min = 0.0,
+                                                                                                          .max = 3.0,
+                                                                                                          .interval = 1.0,
+                                                                                                          .choices = { "Up", "Down", "Up-Down", "Random" } },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Octaves,
+                                                                                                          .displayName = "Octaves",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 1.0,
+                                                                                                          .min = 1.0,
+                                                                                                          .max = 4.0,
+                                                                                                          .interval = 1.0 },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Rate,
+                                                                                                          .displayName = "Rate (steps)",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 1.0,
+                                                                                                          .min = 1.0,
+                                                                                                          .max = 8.0,
+                                                                                                          .interval = 1.0 },
+                                                                             pitchParam(),
+                                                                             velocityParam(),
+                                                                             seedParam(),
+                                                                         },
+                                                                         .generate = Generators::arpeggio });
+
+static bool reg3 = GeneratorRegistry::getInstance().registerGenerator ({ .type = GeneratorIDs::CellularAutomaton,
+                                                                         .displayName = "Cellular Automaton",
+                                                                         .description = "An elementary cellular automaton: each row of Width steps is one generation of the rule, and live cells play. The pattern starts over after the set number of generations; seed 0 starts from a single cell.",
+                                                                         .navShortcutDescription = "c",
+                                                                         .params = {
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Rule,
+                                                                                                          .displayName = "Rule",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 90.0,
+                                                                                                          .min = 0.0,
+                                                                                                          .max = 255.0,
+                                                                                                          .interval = 1.0 },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Width,
+                                                                                                          .displayName = "Width (steps)",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 16.0,
+                                                                                                          .min = 2.0,
+                                                                                                          .max = 64.0,
+                                                                                                          .interval = 1.0 },
+                                                                             SingleValueParamDefinition { .id = GeneratorIDs::Generations,
+                                                                                                          .displayName = "Generations",
+                                                                                                          .widgetType = ParamWidgetType::slider,
+                                                                                                          .defaultVal = 16.0,
+                                                                                                          .min = 1.0,
+                                                                                                          .max = 64.0,
+                                                                                                          .interval = 1.0 },
+                                                                             pitchParam(),
+                                                                             velocityParam(),
+                                                                             seedParam(),
+                                                                         },
+                                                                         .generate = Generators::cellularAutomaton });
+} // namespace
@@ -0,0 +1,99 @@
+#pragma once
+
+#include "Data/Modifier.h"
+#include <JuceHeader.h>
+#include <functional>
+#include <map>
+#include <vector>
+
+namespace GeneratorIDs
+{
+#define DECLARE_ID(name) inline const juce::Identifier name { #name };
+
+// Generator types
+DECLARE_ID (Euclidean)
+DECLARE_ID (RandomWalk)
+DECLARE_ID (Arpeggio)
+DECLARE_ID (CellularAutomaton)
+
+// Parameter IDs, shared between generators where they mean the same thing
+DECLARE_ID (Pitch)
+DECLARE_ID (Velocity)
+DECLARE_ID (Seed)
+DECLARE_ID (Pulses)
+DECLARE_ID (Steps)
+DECLARE_ID (Rotation)
+DECLARE_ID (Density)
+DECLARE_ID (MaxLeap)
+DECLARE_ID (Span)
+DECLARE_ID (Phrase)
+DECLARE_ID (ChordSize)
+DECLARE_ID (Direction)
+DECLARE_ID (Octaves)
+DECLARE_ID (Rate)
+DECLARE_ID (Rule)
+DECLARE_ID (Width)
+DECLARE_ID (Generations)
+
+#undef DECLARE_ID
+} // namespace GeneratorIDs
+
+// One generated note, on the generator's step grid. Pitch is counted in
+// scale steps from the root, so the same pattern follows any scale
+struct GeneratedNote
+{
+    juce::int64 step = 0;
+    int scaleStep = 0;
+    int velocity = 100;
+    int lengthSteps = 1;
+};
+
+// The steps to generate, [firstStep, endStep). Generators are pure
+// functions of their parameters and the step number: any window can be
+// generated on its own, in time proportional to the window
+struct GeneratorContext
+{
+    juce::int64 firstStep = 0;
+    juce::int64 endStep = 0;
+    int scaleStepsPerOctave = 7;
+};
+
+using GenerateFunction = std::function<void (const juce::ValueTree& params, const GeneratorContext& context, std::vector<GeneratedNote>& notes)>;
+
+struct GeneratorDefinition
+{
+    juce::Identifier type;
+    juce::String displayName;
+    juce::String description;
+    juce::String navShortcutDescription;
+    std::vector<ParamDefinition> params;
+    GenerateFunction generate;
+
+    juce::KeyPress getNavShortcut() const
+    {
+        return juce::KeyPress::createFromDescription (navShortcutDescription);
+    }
+};
+
+class GeneratorRegistry
+{
+public:
+    static GeneratorRegistry& getInstance();
+
+    // Registration (safe to call from static initializers)
+    bool registerGenerator (GeneratorDefinition def);
+
+    // Queries
+    std::vector<juce::Identifier> getRegisteredTypes() const;
+    const GeneratorDefinition* getDefinition (const juce::Identifier& type) const;
+
+    // Factory - creates ValueTree with default parameter values
+    juce::ValueTree createDefaultState (const juce::Identifier& type) const;
+
+    // The notes a generator's state produces over a window, in step order
+    std::vector<GeneratedNote> generate (const juce::ValueTree& state, const GeneratorContext& context) const;
+
+private:
+    GeneratorRegistry() = default;
+    std::map<juce::Identifier, GeneratorDefinition> definitions;
+};
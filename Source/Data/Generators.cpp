@@ -0,0 +1,216 @@
+#include "Data/Generators.h"
+#include "Data/Ticks.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+int getInt (const juce::ValueTree& params, const juce::Identifier& id, int fallback)
+{
+    return juce::roundToInt (static_cast<double> (params.getProperty (id, fallback)));
+}
+
+// A uniform value in [0, 1) for a step
+double unit (juce::uint32 seed, juce::int64 step, juce::uint32 salt)
+{
+    return Generators::hash (seed, step, salt) / 4294967296.0;
+}
+
+// Salts keep a generator's decisions about one step independent
+constexpr juce::uint32 moveSalt = 1;
+constexpr juce::uint32 densitySalt = 2;
+constexpr juce::uint32 cellSalt = 3;
+constexpr juce::uint32 orderSalt = 4;
+} // namespace
+
+namespace Generators
+{
+juce::uint32 hash (juce::uint32 seed, juce::int64 step, juce::uint32 salt)
+{
+    // splitmix64 finaliser over the three inputs
+    auto x = static_cast<juce::uint64> (step) * 0x9e3779b97f4a7c15ull
+             ^ (static_cast<juce::uint64> (seed) << 32 | salt);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return static_cast<juce::uint32> (x >> 32);
+}
+
+int getScaleStepsPerOctave (const Scale& scale)
+{
+    // Degrees run from the root to the period, which is listed as well
+    return juce::jmax (1, static_cast<int> (scale.getDegrees().size()) - 1);
+}
+
+double getDegree (const Scale& scale, int scaleStep)
+{
+    const auto& degrees = scale.getDegrees();
+
+    if (degrees.size() < 2)
+        return 0.0;
+
+    auto stepsPerOctave = static_cast<Ticks::Count> (getScaleStepsPerOctave (scale));
+    auto octave = Ticks::floorDiv (scaleStep, stepsPerOctave);
+    auto index = static_cast<size_t> (scaleStep - octave * stepsPerOctave);
+    double period = degrees.back();
+    double degree = degrees[index] + static_cast<double> (octave) * period;
+
+    // Keep the note on the grid
+    while (degree > scale.getUpperBound() && degree - period >= scale.getLowerBound())
+        degree -= period;
+    while (degree < scale.getLowerBound() && degree + period <= scale.getUpperBound())
+        degree += period;
+
+    return degree;
+}
+
+void euclidean (const juce::ValueTree& params, const GeneratorContext& context, std::vector<GeneratedNote>& notes)
+{
+    auto steps = juce::jmax (1, getInt (params, GeneratorIDs::Steps, 16));
+    auto pulses = juce::jlimit (0, steps, getInt (params, GeneratorIDs::Pulses, 5));
+    auto rotation = getInt (params, GeneratorIDs::Rotation, 0);
+    auto pitch = getInt (params, GeneratorIDs::Pitch, 0);
+    auto velocity = getInt (params, GeneratorIDs::Velocity, 100);
+
+    for (auto step = context.firstStep; step < context.endStep; ++step)
+    {
+        // Bresenham's spread: the same onsets as Bjorklund's algorithm, starting on the downbeat
+        auto position = Ticks::wrap (step - rotation, steps);
+
+        if ((position * pulses) % steps < pulses)
+            notes.push_back ({ step, pitch, velocity, 1 });
+    }
+}
+
+void randomWalk (const juce::ValueTree& params, const GeneratorContext& context, std::vector<GeneratedNote>& notes)
+{
+    auto seed = static_cast<juce::uint32> (getInt (params, GeneratorIDs::Seed, 0));
+    auto density = getInt (params, GeneratorIDs::Density, 75);
+    auto maxLeap = juce::jmax (1, getInt (params, GeneratorIDs::MaxLeap, 2));
+    auto span = juce::jmax (1, getInt (params, GeneratorIDs::Span, 7));
+    auto phrase = juce::jmax (1, getInt (params, GeneratorIDs::Phrase, 16));
+    auto pitch = getInt (params, GeneratorIDs::Pitch, 0);
+    auto velocity = getInt (params, GeneratorIDs::Velocity, 100);
+
+    // The walk only remembers back to its phrase start
+    auto step = Ticks::floorDiv (context.firstStep, phrase) * phrase;
+    int position = 0;
+
+    for (; step < context.endStep; ++step)
+    {
+        if (Ticks::wrap (step, phrase) == 0)
+        {
+            position = 0;
+        }
+        else
+        {
+            position += juce::roundToInt ((unit (seed, step, moveSalt) * 2.0 - 1.0) * maxLeap);
+
+            // Reflect off the edges of the span until inside: a leap wider
+            // than the span can bounce off both
+            while (position > span || position < -span)
+                position = position > span ? 2 * span - position : -2 * span - position;
+        }
+
+        if (step >= context.firstStep && unit (seed, step, densitySalt) * 100.0 < density)
+            notes.push_back ({ step, pitch + position, velocity, 1 });
+    }
+}
+
+void arpeggio (const juce::ValueTree& params, const GeneratorContext& context, std::vector<GeneratedNote>& notes)
+{
+    enum Direction
+    {
+        up,
+        down,
+        upDown,
+        random
+    };
+
+    auto seed = static_cast<juce::uint32> (getInt (params, GeneratorIDs::Seed, 0));
+    auto chordSize = juce::jlimit (1, 7, getInt (params, GeneratorIDs::ChordSize, 3));
+    auto direction = getInt (params, GeneratorIDs::Direction, up);
+    auto octaves = juce::jlimit (1, 4, getInt (params, GeneratorIDs::Octaves, 1));
+    auto rate = juce::jmax (1, getInt (params, GeneratorIDs::Rate, 1));
+    auto pitch = getInt (params, GeneratorIDs::Pitch, 0);
+    auto velocity = getInt (params, GeneratorIDs::Velocity, 100);
+
+    auto numTones = chordSize * octaves;
+    auto cycle = direction == upDown && numTones > 1 ? 2 * numTones - 2 : numTones;
+
+    // Chord tones are stacked thirds: every other scale step
+    auto toneAt = [&] (int index)
+    {
+        auto octave = index / chordSize;
+        return pitch + 2 * (index % chordSize) + octave * context.scaleStepsPerOctave;
+    };
+
+    for (auto step = Ticks::floorDiv (context.firstStep + rate - 1, rate) * rate; step < context.endStep; step += rate)
+    {
+        auto count = Ticks::floorDiv (step, rate);
+        auto index = static_cast<int> (Ticks::wrap (count, cycle));
+
+        switch (direction)
+        {
+            case down:
+                index = numTones - 1 - index;
+                break;
+            case upDown:
+                index = index < numTones ? index : cycle - index;
+                break;
+            case random:
+                index = static_cast<int> (unit (seed, count, orderSalt) * numTones);
+                break;
+            default:
+                break;
+        }
+
+        notes.push_back ({ step, toneAt (index), velocity, rate });
+    }
+}
+
+void cellularAutomaton (const juce::ValueTree& params, const GeneratorContext& context, std::vector<GeneratedNote>& notes)
+{
+    auto seed = static_cast<juce::uint32> (getInt (params, GeneratorIDs::Seed, 0));
+    auto rule = juce::jlimit (0, 255, getInt (params, GeneratorIDs::Rule, 90));
+    auto width = juce::jlimit (2, 64, getInt (params, GeneratorIDs::Width, 16));
+    auto generations = juce::jlimit (1, 64, getInt (params, GeneratorIDs::Generations, 16));
+    auto pitch = getInt (params, GeneratorIDs::Pitch, 0);
+    auto velocity = getInt (params, GeneratorIDs::Velocity, 100);
+
+    if (context.endStep <= context.firstStep)
+        return;
+
+    // Every generation of the cycle, at most 64 rows of 64 cells
+    std::vector<std::vector<bool>> rows (static_cast<size_t> (generations), std::vector<bool> (static_cast<size_t> (width), false));
+
+    for (int cell = 0; cell < width; ++cell)
+        rows[0][static_cast<size_t> (cell)] = seed == 0 ? cell == 0 : (hash (seed, cell, cellSalt) & 1) != 0;
+
+    for (size_t g = 1; g < rows.size(); ++g)
+    {
+        for (int cell = 0; cell < width; ++cell)
+        {
+            auto at = [&] (int c)
+            { return rows[g - 1][static_cast<size_t> ((c + width) % width)] ? 1 : 0; };
+
+            auto neighbourhood = at (cell - 1) << 2 | at (cell) << 1 | at (cell + 1);
+            rows[g][static_cast<size_t> (cell)] = ((rule >> neighbourhood) & 1) != 0;
+        }
+    }
+
+    for (auto step = context.firstStep; step < context.endStep; ++step)
+    {
+        auto row = Ticks::floorDiv (step, width);
+        auto cell = static_cast<size_t> (step - row * width);
+        const auto& cells = rows[static_cast<size_t> (Ticks::wrap (row, generations))];
+
+        if (! cells[cell])
+            continue;
+
+        // Live neighbours pick a chord tone, so dense regions climb
+        auto neighbours = (cells[(cell + cells.size() - 1) % cells.size()] ? 1 : 0) + (cells[(cell + 1) % cells.size()] ? 1 : 0);
+        notes.push_back ({ step, pitch + 2 * neighbours, velocity, 1 });
+    }
+}
+} // namespace Generators
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Data/GeneratorRegistry.h"
+#include "Data/Scale.h"
+#include <JuceHeader.h>
+#include <vector>
+
+// The pattern generators registered in GeneratorRegistry. Each one is a pure
+// function of its parameters and the step number, so a window of steps costs
+// the same wherever it falls
+namespace Generators
+{
+// Evenly spread pulses over a cycle of steps, rotated
+void euclidean (const juce::ValueTree& params, const GeneratorContext& context, std::vector<GeneratedNote>& notes);
+
+// A bounded walk through the scale that restarts each phrase
+void randomWalk (const juce::ValueTree& params, const GeneratorContext& context, std::vector<GeneratedNote>& notes);
+
+// A chord of stacked scale thirds played one note at a time
+void arpeggio (const juce::ValueTree& params, const GeneratorContext& context, std::vector<GeneratedNote>& notes);
+
+// A one-dimensional cellular automaton, one generation per row of steps
+void cellularAutomaton (const juce::ValueTree& params, const GeneratorContext& context, std::vector<GeneratedNote>& notes);
+
+// A random number for a step, the same for the same seed, step and salt
+juce::uint32 hash (juce::uint32 seed, juce::int64 step, juce::uint32 salt);
+
+// Scale steps in one period
+int getScaleStepsPerOctave (const Scale& scale);
+
+// The degree a number of scale steps from the root lands on, folded by
+// whole periods into the scale's range
+double getDegree (const Scale& scale, int scaleStep);
+} // namespace Generators
@@ -0,0 +1,98 @@
+/*
+  ==============================================================================
+
+    Groove.cpp
+    A sequence's timing feel: swing, a groove template and humanise,
+    compiled into one offset per step.
+
+  ==============================================================================
+*/
+
+#include "Groove.h"
+#include "Data/GrooveRegistry.h"
+#include <algorithm>
+#include <limits>
+#include <random>
+
+Groove::Groove (juce::ValueTree existingState) : state (existingState.isValid() ? std::move (existingState) : juce::ValueTree (GrooveIDs::Groove))
+{
+    if (! state.hasProperty (GrooveIDs::Swing))
+        state.setProperty (GrooveIDs::Swing, straightSwing, nullptr);
+
+    if (! state.hasProperty (GrooveIDs::Template))
+        state.setProperty (GrooveIDs::Template, "", nullptr);
+
+    if (! state.hasProperty (GrooveIDs::Humanise))
+        state.setProperty (GrooveIDs::Humanise, 0, nullptr);
+
+    // Humanise is the same every time the file is played
+    if (! state.hasProperty (GrooveIDs::Seed))
+        state.setProperty (GrooveIDs::Seed, juce::Random::getSystemRandom().nextInt (juce::Range<int> (1, std::numeric_limits<int>::max())), nullptr);
+}
+
+juce::ValueTree& Groove::getState() { return state; }
+
+int Groove::getSwing() const { return state.getProperty (GrooveIDs::Swing); }
+
+void Groove::setSwing (int percent, juce::UndoManager* undoManager)
+{
+    state.setProperty (GrooveIDs::Swing, juce::jlimit (straightSwing, maxSwing, percent), undoManager);
+}
+
+juce::Value Groove::getSwingAsValue() { return state.getPropertyAsValue (GrooveIDs::Swing, nullptr); }
+
+juce::String Groove::getTemplateName() const { return state.getProperty (GrooveIDs::Template); }
+
+void Groove::setTemplateName (const juce::String& name, juce::UndoManager* undoManager)
+{
+    state.setProperty (GrooveIDs::Template, name, undoManager);
+}
+
+juce::Value Groove::getTemplateNameAsValue() { return state.getPropertyAsValue (GrooveIDs::Template, nullptr); }
+
+int Groove::getHumanise() const { return state.getProperty (GrooveIDs::Humanise); }
+
+void Groove::setHumanise (int percent, juce::UndoManager* undoManager)
+{
+    state.setProperty (GrooveIDs::Humanise, juce::jlimit (0, 100, percent), undoManager);
+}
+
+juce::Value Groove::getHumaniseAsValue() { return state.getPropertyAsValue (GrooveIDs::Humanise, nullptr); }
+
+void Groove::compile (double loopLengthBeats)
+{
+    auto swing = juce::jlimit (straightSwing, maxSwing, getSwing());
+    auto humanise = juce::jlimit (0, 100, getHumanise());
+    const auto* groove = GrooveRegistry::getInstance().getTemplate (getTemplateName());
+
+    offsets.clear();
+    maxOffsetBeats = 0.0;
+
+    if (swing == straightSwing && humanise == 0 && groove == nullptr)
+        return;
+
+    // One entry per step of the loop, so the template and the jitter line up with it
+    auto numSteps = juce::jlimit (1, maxSteps, juce::roundToInt (loopLengthBeats / stepBeats));
+    offsets.assign (static_cast<size_t> (numSteps), 0.0);
+
+    // At 50% the pair is split evenly; at 75% the second sixteenth sits three quarters of the way through it
+    auto swingOffset = (swing - straightSwing) / 100.0 * 2.0 * stepBeats;
+
+    std::mt19937 rng (static_cast<std::mt19937::result_type> (static_cast<int> (state.getProperty (GrooveIDs::Seed))));
+    std::uniform_real_distribution<double> jitter (-1.0, 1.0);
+    auto humaniseBeats = humanise / 100.0 * maxHumaniseSteps * stepBeats;
+
+    for (size_t i = 0; i < offsets.size(); ++i)
+    {
+        if (i % 2 == 1)
+            offsets[i] += swingOffset;
+
+        if (groove != nullptr)
+            offsets[i] += groove->offsets[i % groove->offsets.size()] * stepBeats;
+
+        if (humanise > 0)
+            offsets[i] += jitter (rng) * humaniseBeats;
+
+        maxOffsetBeats = std::max (maxOffsetBeats, std::abs (offsets[i]));
+    }
+}
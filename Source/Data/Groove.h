@@ -0,0 +1,107 @@
+/*
+  ==============================================================================
+
+    Groove.h
+    A sequence's timing feel: swing, a groove template and humanise,
+    compiled into one offset per step.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "juce_data_structures/juce_data_structures.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace GrooveIDs
+{
+#define DECLARE_ID(name) inline const juce::Identifier name { #name };
+DECLARE_ID (Groove)
+DECLARE_ID (Swing)
+DECLARE_ID (Template)
+DECLARE_ID (Humanise)
+DECLARE_ID (Seed)
+#undef DECLARE_ID
+} // namespace GrooveIDs
+
+class Groove
+{
+public:
+    // Offsets are per sixteenth; swing moves every second one
+    static constexpr double stepBeats = 0.25;
+    static constexpr int maxSteps = 1024;
+
+    // Swing in percent: where the second sixteenth of each pair lands
+    static constexpr int straightSwing = 50;
+    static constexpr int maxSwing = 75;
+
+    // Full humanise moves a note up to this fraction of a step either way
+    static constexpr double maxHumaniseSteps = 0.15;
+
+    explicit Groove (juce::ValueTree existingState);
+
+    juce::ValueTree& getState();
+
+    int getSwing() const;
+    void setSwing (int percent, juce::UndoManager* undoManager = nullptr);
+    juce::Value getSwingAsValue();
+
+    // Name of a template in the GrooveRegistry; empty for none
+    juce::String getTemplateName() const;
+    void setTemplateName (const juce::String& name, juce::UndoManager* undoManager = nullptr);
+    juce::Value getTemplateNameAsValue();
+
+    // 0 to 100 percent
+    int getHumanise() const;
+    void setHumanise (int percent, juce::UndoManager* undoManager = nullptr);
+    juce::Value getHumaniseAsValue();
+
+    // Rebuild the offset table for a loop of this length. Call after any
+    // groove setting or the loop length changes (message thread)
+    void compile (double loopLengthBeats);
+
+    // How far a note at this loop-local beat moves, in beats. A note on the
+    // sixteenth grid takes its step's offset; one between steps (a triplet,
+    // a tuplet step) is interpolated between its neighbours, so it isn't
+    // given a whole swing meant for the sixteenth it happens to be nearest.
+    // Table lookups, safe to call from any thread while nobody is compiling
+    double getOffsetBeats (double loopBeat) const
+    {
+        if (offsets.empty())
+            return 0.0;
+
+        auto position = std::max (0.0, loopBeat) / stepBeats;
+        auto lower = std::floor (position);
+        auto fraction = position - lower;
+
+        // On the grid, allowing for beats that came back from ticks
+        if (fraction > 1.0 - gridTolerance)
+        {
+            lower += 1.0;
+            fraction = 0.0;
+        }
+
+        auto step = static_cast<size_t> (lower) % offsets.size();
+
+        if (fraction < gridTolerance)
+            return offsets[step];
+
+        auto next = offsets[(step + 1) % offsets.size()];
+        return offsets[step] + (next - offsets[step]) * fraction;
+    }
+
+    // The furthest getOffsetBeats moves any note, either way
+    double getMaxOffsetBeats() const { return maxOffsetBeats; }
+
+private:
+    juce::ValueTree state;
+
+    // Offset per step of the loop, in beats; empty when the groove is straight
+    std::vector<double> offsets;
+    double maxOffsetBeats = 0.0;
+
+    // Fraction of a step still counted as on the grid
+    static constexpr double gridTolerance = 1.0e-6;
+};
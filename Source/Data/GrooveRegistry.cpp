@@ -0,0 +1,134 @@
+#include "GrooveRegistry.h"
+#include <algorithm>
+#include <cmath>
+
+GrooveRegistry& GrooveRegistry::getInstance()
+{
+    static GrooveRegistry instance;
+    return instance;
+}
+
+bool GrooveRegistry::registerTemplate (GrooveTemplate groove)
+{
+    if (groove.name.isEmpty() || groove.offsets.empty())
+        return false;
+
+    templates[groove.name] = std::move (groove);
+    return true;
+}
+
+std::vector<juce::String> GrooveRegistry::getTemplateNames() const
+{
+    std::vector<juce::String> names;
+    names.reserve (templates.size());
+    for (const auto& [name, groove] : templates)
+    {
+        names.push_back (name);
+    }
+    return names;
+}
+
+const GrooveTemplate* GrooveRegistry::getTemplate (const juce::String& name) const
+{
+    auto it = templates.find (name);
+    if (it != templates.end())
+    {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+std::optional<GrooveTemplate> GrooveRegistry::parseMidiFile (const juce::File& file)
+{
+    juce::FileInputStream stream (file);
+    juce::MidiFile midiFile;
+
+    if (! stream.openedOk() || ! midiFile.readFrom (stream))
+    {
+        juce::Logger::writeToLog ("Could not read MIDI file " + file.getFileName());
+        return std::nullopt;
+    }
+
+    // SMPTE timing has no beats to measure against
+    auto ticksPerQuarter = static_cast<int> (midiFile.getTimeFormat());
+    if (ticksPerQuarter <= 0)
+    {
+        juce::Logger::writeToLog ("Unsupported SMPTE timing in " + file.getFileName());
+        return std::nullopt;
+    }
+
+    double ticksPerStep = ticksPerQuarter / 4.0;
+
+    // Position of every note-on, in sixteenth steps
+    std::vector<double> positions;
+    for (int t = 0; t < midiFile.getNumTracks(); ++t)
+    {
+        const auto* track = midiFile.getTrack (t);
+        for (const auto* event : *track)
+        {
+            if (event->message.isNoteOn())
+                positions.push_back (event->message.getTimeStamp() / ticksPerStep);
+        }
+    }
+
+    if (positions.empty())
+    {
+        juce::Logger::writeToLog ("No notes in " + file.getFileName());
+        return std::nullopt;
+    }
+
+    auto lastStep = juce::roundToInt (*std::max_element (positions.begin(), positions.end()));
+    auto numBars = juce::jlimit (1, maxTemplateBars, lastStep / stepsPerBar + 1);
+    auto numSteps = numBars * stepsPerBar;
+
+    // Notes sharing a step (a chord, or the same step in a later bar) are averaged
+    std::vector<double> sums (static_cast<size_t> (numSteps), 0.0);
+    std::vector<int> counts (static_cast<size_t> (numSteps), 0);
+
+    for (auto position : positions)
+    {
+        auto nearest = std::round (position);
+        auto step = static_cast<size_t> (static_cast<juce::int64> (nearest) % numSteps);
+        sums[step] += position - nearest;
+        ++counts[step];
+    }
+
+    GrooveTemplate groove;
+    groove.name = file.getFileNameWithoutExtension();
+    groove.offsets.resize (static_cast<size_t> (numSteps), 0.0);
+
+    for (size_t i = 0; i < groove.offsets.size(); ++i)
+    {
+        if (counts[i] > 0)
+            groove.offsets[i] = sums[i] / counts[i];
+    }
+
+    return groove;
+}
+
+bool GrooveRegistry::loadMidiFile (const juce::File& file)
+{
+    auto groove = parseMidiFile (file);
+
+    if (! groove.has_value())
+        return false;
+
+    juce::Logger::writeToLog ("Loaded groove: " + groove->name);
+    return registerTemplate (std::move (*groove));
+}
+
+int GrooveRegistry::loadMidiDirectory (const juce::File& directory)
+{
+    if (! directory.isDirectory())
+        return 0;
+
+    int numLoaded = 0;
+
+    for (const auto& entry : juce::RangedDirectoryIterator (directory, false, "*.mid;*.midi"))
+    {
+        if (loadMidiFile (entry.getFile()))
+            ++numLoaded;
+    }
+
+    return numLoaded;
+}
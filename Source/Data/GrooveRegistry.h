@@ -0,0 +1,38 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <optional>
+#include <vector>
+
+struct GrooveTemplate
+{
+    juce::String name;
+    std::vector<double> offsets; // Per sixteenth step, as a fraction of a step; the template repeats after the last
+};
+
+class GrooveRegistry
+{
+public:
+    static GrooveRegistry& getInstance();
+
+    // Templates are read a bar at a time, up to this many bars of sixteenths
+    static constexpr int stepsPerBar = 16;
+    static constexpr int maxTemplateBars = 4;
+
+    bool registerTemplate (GrooveTemplate groove);
+
+    // Queries
+    std::vector<juce::String> getTemplateNames() const;
+    const GrooveTemplate* getTemplate (const juce::String& name) const;
+
+    // Standard MIDI file support - each note-on's distance from its nearest
+    // sixteenth becomes that step's offset, named after the file
+    static std::optional<GrooveTemplate> parseMidiFile (const juce::File& file);
+    bool loadMidiFile (const juce::File& file);
+    int loadMidiDirectory (const juce::File& directory);
+
+private:
+    GrooveRegistry() = default;
+    std::map<juce::String, GrooveTemplate> templates;
+};
@@ -5,25 +5,279 @@ KeyboardShortcutManager::KeyboardShortcutManager()
 {
 }
 
+KeyboardShortcutManager::~KeyboardShortcutManager()
+{
+    stopTimer();
+}
+
+KeyboardShortcutManager::KeyHash KeyboardShortcutManager::hashKey (const juce::KeyPress& key)
+{
+    // Matches KeyPress::operator==, which compares character key codes case-insensitively
+    auto code = key.getKeyCode();
+    if (code >= 0 && code < 256)
+        code = (int) juce::CharacterFunctions::toLowerCase ((juce::juce_wchar) code);
+
+    auto modifiers = key.getModifiers().withoutMouseButtons().getRawFlags();
+    return ((KeyHash) (juce::uint32) code << 32) | (juce::uint32) modifiers;
+}
+
+bool KeyboardShortcutManager::acceptsCount (Mode mode)
+{
+    return mode == Mode::normal || mode == Mode::visualLine || mode == Mode::visualBlock;
+}
+
+int KeyboardShortcutManager::getDigit (const juce::KeyPress& key)
+{
+    auto code = key.getKeyCode();
+    if (code < '0' || code > '9' || key.getModifiers().withoutMouseButtons().isAnyModifierKeyDown())
+        return -1;
+
+    return code - '0';
+}
+
+KeyboardShortcutManager::KeyNode& KeyboardShortcutManager::getRoot (Mode mode)
+{
+    return roots[static_cast<size_t> (mode)];
+}
+
+const KeyboardShortcutManager::KeyNode& KeyboardShortcutManager::getRoot (Mode mode) const
+{
+    return roots[static_cast<size_t> (mode)];
+}
+
 bool KeyboardShortcutManager::handleKeyPress (const juce::KeyPress& key, Mode mode)
 {
-    // Search for a matching shortcut
-    for (const auto& shortcut : activeShortcuts)
+    if (registerCallback != nullptr)
     {
-        if (shortcut.keyPress == key && shortcut.appliesTo (mode))
+        auto callback = std::move (registerCallback);
+        registerCallback = nullptr;
+        resetPending();
+
+        if (key == juce::KeyPress (juce::KeyPress::escapeKey))
+            return true;
+
+        auto reg = key.getTextCharacter();
+        if (reg == 0 && juce::isPositiveAndBelow (key.getKeyCode(), 256))
+            reg = juce::CharacterFunctions::toLowerCase ((juce::juce_wchar) key.getKeyCode());
+
+        callback (reg);
+        return true;
+    }
+
+    if (mode != pendingMode)
+        resetPending();
+
+    pendingMode = mode;
+
+    // Digits before any bound key build up a count prefix. A bound digit
+    // only counts once a count has started, so it doesn't wait out the timeout
+    auto digit = getDigit (key);
+    bool startsCount = digit > 0 && ! getRoot (mode).children.contains (hashKey (key));
+
+    if (pendingNode == nullptr && acceptsCount (mode) && digit >= 0 && (startsCount || pendingCount > 0))
+    {
+        pendingCount = juce::jmin (pendingCount * 10 + digit, maxCount);
+        pendingKeys.push_back (key);
+        startTimer (sequenceTimeoutMs);
+        return true;
+    }
+
+    const auto& node = pendingNode != nullptr ? *pendingNode : getRoot (mode);
+    auto child = node.children.find (hashKey (key));
+
+    if (child == node.children.end())
+    {
+        if (pendingNode == nullptr)
         {
-            // Execute the action and return its result
-            return shortcut.action();
+            // A count followed by an unbound key is dropped, as in vim
+            resetPending();
+            return false;
         }
+
+        // The sequence was broken off: run whatever the typed prefix completes,
+        // then treat this key as the start of a new sequence
+        bool handled = flushPending();
+        return handleKeyPress (key, mode) || handled;
+    }
+
+    const auto* next = child->second.get();
+
+    if (next->children.empty())
+    {
+        auto index = next->shortcutIndex;
+        stopTimer();
+        auto handled = execute (index, juce::jmax (1, pendingCount));
+        resetPending();
+        return handled;
     }
 
-    // No shortcut found
-    return false;
+    // More keys could follow; wait for them or for the timeout
+    pendingNode = next;
+    pendingKeys.push_back (key);
+    startTimer (sequenceTimeoutMs);
+    return true;
+}
+
+bool KeyboardShortcutManager::execute (int shortcutIndex, int count)
+{
+    if (! juce::isPositiveAndBelow (shortcutIndex, (int) activeShortcuts.size()))
+        return false;
+
+    const auto& shortcut = activeShortcuts[(size_t) shortcutIndex];
+    MacroStep step { shortcutIndex, count };
+
+    if (replayDepth == 0 && shortcut.isRecorded)
+        macros.record (step);
+
+    if (shortcut.isEdit)
+        macros.setLastChange (step);
+
+    return shortcut.action (count);
+}
+
+bool KeyboardShortcutManager::flushPending()
+{
+    stopTimer();
+
+    // A count with no binding after it runs nothing
+    auto index = pendingNode != nullptr ? pendingNode->shortcutIndex : -1;
+    auto handled = execute (index, juce::jmax (1, pendingCount));
+    resetPending();
+    return handled;
+}
+
+void KeyboardShortcutManager::resetPending()
+{
+    stopTimer();
+    pendingNode = nullptr;
+    pendingCount = 0;
+    pendingKeys.clear();
+}
+
+void KeyboardShortcutManager::timerCallback()
+{
+    if (flushPending() && onDeferredShortcutExecuted)
+        onDeferredShortcutExecuted();
+}
+
+juce::String KeyboardShortcutManager::getPendingKeysDescription() const
+{
+    juce::String text;
+    for (const auto& key : pendingKeys)
+        text << key.getTextDescription().toLowerCase();
+
+    return text;
+}
+
+void KeyboardShortcutManager::awaitRegister (std::function<bool (juce::juce_wchar)> callback)
+{
+    registerCallback = std::move (callback);
+}
+
+void KeyboardShortcutManager::startRecording (juce::juce_wchar reg)
+{
+    if (MacroRecorder::isValidRegister (reg))
+        macros.startRecording (reg);
+}
+
+void KeyboardShortcutManager::stopRecording()
+{
+    macros.stopRecording();
+}
+
+bool KeyboardShortcutManager::isRecording() const
+{
+    return macros.isRecording();
+}
+
+juce::juce_wchar KeyboardShortcutManager::getRecordingRegister() const
+{
+    return macros.getRecordingRegister();
+}
+
+bool KeyboardShortcutManager::replayMacro (juce::juce_wchar reg, int count)
+{
+    if (reg == '@')
+        reg = macros.getLastReplayedRegister();
+
+    const auto* macro = macros.getMacro (reg);
+    if (macro == nullptr || macro->empty())
+        return false;
+
+    macros.setLastReplayedRegister (reg);
+
+    // Copied, as a step could start recording over the same register
+    auto steps = *macro;
+
+    ++replayDepth;
+    for (int i = 0; i < count; ++i)
+    {
+        for (const auto& step : steps)
+            execute (step.shortcutIndex, step.count);
+    }
+    --replayDepth;
+
+    return true;
+}
+
+bool KeyboardShortcutManager::repeatLastChange (int count)
+{
+    auto change = macros.getLastChange();
+    if (! change.has_value())
+        return false;
+
+    ++replayDepth;
+    for (int i = 0; i < count; ++i)
+        execute (change->shortcutIndex, change->count);
+    --replayDepth;
+
+    return true;
+}
+
+void KeyboardShortcutManager::indexShortcut (int shortcutIndex)
+{
+    const auto& shortcut = activeShortcuts[(size_t) shortcutIndex];
+
+    if (shortcut.keySequence.empty())
+        return;
+
+    for (size_t m = 0; m < numModes; ++m)
+    {
+        auto mode = static_cast<Mode> (m);
+        if (! shortcut.appliesTo (mode))
+            continue;
+
+        auto* node = &roots[m];
+        for (const auto& key : shortcut.keySequence)
+        {
+            auto& child = node->children[hashKey (key)];
+            if (child == nullptr)
+                child = std::make_unique<KeyNode>();
+            node = child.get();
+        }
+
+        // Like the old linear search, the first registered binding wins
+        if (node->shortcutIndex < 0)
+            node->shortcutIndex = shortcutIndex;
+    }
+}
+
+void KeyboardShortcutManager::rebuildIndex()
+{
+    resetPending();
+    macros.clear();
+
+    for (auto& root : roots)
+        root = KeyNode();
+
+    for (int i = 0; i < (int) activeShortcuts.size(); ++i)
+        indexShortcut (i);
 }
 
 void KeyboardShortcutManager::registerShortcut (Shortcut shortcut)
 {
     activeShortcuts.push_back (shortcut);
+    indexShortcut ((int) activeShortcuts.size() - 1);
 }
 
 void KeyboardShortcutManager::registerShortcuts (std::vector<Shortcut> shortcuts)
@@ -36,11 +290,13 @@ void KeyboardShortcutManager::registerShortcuts (std::vector<Shortcut> shortcuts
 
 void KeyboardShortcutManager::deregisterShortcut (const juce::KeyPress& key, Mode mode)
 {
-    // Remove shortcuts that match the given key and mode
+    // Remove single key shortcuts that match the given key and mode
     activeShortcuts.erase (
         std::remove_if (activeShortcuts.begin(), activeShortcuts.end(), [&key, &mode] (const Shortcut& shortcut)
-                        { return shortcut.keyPress == key && shortcut.appliesTo (mode); }),
+                        { return shortcut.keySequence.size() == 1 && shortcut.keySequence.front() == key && shortcut.appliesTo (mode); }),
         activeShortcuts.end());
+
+    rebuildIndex();
 }
 
 std::vector<Shortcut>
@@ -62,14 +318,11 @@ std::vector<Shortcut>
 
 juce::String KeyboardShortcutManager::getShortcutDescription (const juce::KeyPress& key, Mode mode) const
 {
-    // Find a matching shortcut
-    for (const auto& shortcut : activeShortcuts)
-    {
-        if (shortcut.keyPress == key && shortcut.appliesTo (mode))
-        {
-            return shortcut.shortDescription;
-        }
-    }
+    const auto& root = getRoot (mode);
+    auto child = root.children.find (hashKey (key));
+
+    if (child != root.children.end() && child->second->shortcutIndex >= 0)
+        return activeShortcuts[(size_t) child->second->shortcutIndex].shortDescription;
 
     return ""; // No description found
 }
@@ -1,25 +1,65 @@
 #pragma once
 
 #include "Data/Cursor.h"
+#include "Data/MacroRecorder.h"
 #include "juce_core/juce_core.h"
 #include <JuceHeader.h>
+#include <array>
 #include <functional>
+#include <unordered_map>
 
 // Shortcut data structure to hold keybinding information
 struct Shortcut
 {
-    juce::KeyPress keyPress;
+    // One key, or several for vim-style sequences such as "dd" or ">>"
+    std::vector<juce::KeyPress> keySequence;
     std::vector<Mode> applicableModes;
-    std::function<bool()> action;
+    // Receives the count prefix typed before the keys (1 when there is none)
+    std::function<bool (int)> action;
     juce::String shortDescription;
     juce::String longDescription;
+    // Changes the notes, so "." repeats it
+    bool isEdit = false;
+    // Macro controls (q, @, .) are left out of recordings
+    bool isRecorded = true;
 
+    // Single key binding; a count prefix runs the callback that many times
     Shortcut (const juce::KeyPress& key,
               const std::vector<Mode>& modes,
               std::function<bool()> callback,
               const juce::String& shortDesc,
               const juce::String& longDesc)
-        : keyPress (key), applicableModes (modes), action (callback), shortDescription (shortDesc), longDescription (longDesc) {}
+        : keySequence { key },
+          applicableModes (modes),
+          action ([callback] (int count)
+                  {
+                      bool handled = false;
+                      for (int i = 0; i < count; ++i)
+                          handled = callback() || handled;
+                      return handled; }),
+          shortDescription (shortDesc),
+          longDescription (longDesc) {}
+
+    // Key sequence binding whose callback applies the count itself, so e.g.
+    // "8l" is one move and "6>>" one batched edit rather than repeated actions
+    Shortcut (const std::vector<juce::KeyPress>& keys,
+              const std::vector<Mode>& modes,
+              std::function<bool (int)> callback,
+              const juce::String& shortDesc,
+              const juce::String& longDesc)
+        : keySequence (keys), applicableModes (modes), action (callback), shortDescription (shortDesc), longDescription (longDesc) {}
+
+    Shortcut& markAsEdit()
+    {
+        isEdit = true;
+        return *this;
+    }
+
+    Shortcut& markAsNotRecorded()
+    {
+        isRecorded = false;
+        return *this;
+    }
 
     // Helper method to check if this shortcut applies to a specific mode
     bool appliesTo (Mode mode) const
@@ -27,16 +67,34 @@ struct Shortcut
         return applicableModes.empty() || std::find (applicableModes.begin(), applicableModes.end(), mode) != applicableModes.end();
     }
 
-    juce::String getShortcutKey()
+    juce::String getShortcutKey() const
     {
-        return keyPress.getTextDescription().toLowerCase();
+        juce::String text;
+        for (const auto& key : keySequence)
+        {
+            auto description = key.getTextDescription().toLowerCase();
+            if (text.isNotEmpty() && description.length() > 1)
+                text << " ";
+            text << description;
+        }
+        return text;
     }
 };
 
-class KeyboardShortcutManager
+// Bindings are indexed per mode in a trie keyed by a hash of each key press,
+// so dispatch cost does not grow with the size of the keymap.
+//
+// In normal and visual modes, digits typed before a binding form a count
+// prefix ("8l", "5dd", "60j"). A digit that is itself bound ("1" switches
+// sequence) runs at once unless it continues a count, so a count starts with
+// an unbound digit. A key that is both a complete binding and the start of a
+// longer one ("d" and "dd") waits for the next key; if none arrives within
+// sequenceTimeoutMs the shorter binding runs.
+class KeyboardShortcutManager : private juce::Timer
 {
 public:
     KeyboardShortcutManager();
+    ~KeyboardShortcutManager() override;
 
     // Handle a key press for a specific mode
     bool handleKeyPress (const juce::KeyPress& key, Mode mode);
@@ -55,7 +113,70 @@ public:
     // Get description for a specific shortcut
     juce::String getShortcutDescription (const juce::KeyPress& key, Mode mode) const;
 
+    // Keys typed so far of an unfinished sequence, including any count
+    juce::String getPendingKeysDescription() const;
+
+    // Called after a shortcut runs from the timeout rather than a key press
+    std::function<void()> onDeferredShortcutExecuted;
+
+    // Hands the character of the next key press to the callback instead of
+    // dispatching it, for commands that take a register (q{reg}, @{reg}).
+    // Escape cancels
+    void awaitRegister (std::function<bool (juce::juce_wchar)> callback);
+
+    // Every shortcut executed while recording is appended to the register
+    void startRecording (juce::juce_wchar reg);
+    void stopRecording();
+    bool isRecording() const;
+    juce::juce_wchar getRecordingRegister() const;
+
+    // Runs a recorded register count times; '@' replays the last register used.
+    // Steps call the bound actions directly, without key dispatch
+    bool replayMacro (juce::juce_wchar reg, int count);
+
+    // Runs the last shortcut marked as an edit again, count times
+    bool repeatLastChange (int count);
+
+    static constexpr int sequenceTimeoutMs = 600;
+    static constexpr int maxCount = 999;
+
 private:
-    // Store shortcuts directly in a vector
+    using KeyHash = juce::uint64;
+
+    struct KeyNode
+    {
+        std::unordered_map<KeyHash, std::unique_ptr<KeyNode>> children;
+        int shortcutIndex = -1;
+    };
+
+    static constexpr size_t numModes = static_cast<size_t> (Mode::noteEdit) + 1; // noteEdit is the last Mode
+
+    static KeyHash hashKey (const juce::KeyPress& key);
+    static bool acceptsCount (Mode mode);
+    static int getDigit (const juce::KeyPress& key);
+
+    KeyNode& getRoot (Mode mode);
+    const KeyNode& getRoot (Mode mode) const;
+    void indexShortcut (int shortcutIndex);
+    void rebuildIndex();
+
+    bool execute (int shortcutIndex, int count);
+    bool flushPending();
+    void resetPending();
+    void timerCallback() override;
+
+    // Store shortcuts directly in a vector; the trie holds indices into it
     std::vector<Shortcut> activeShortcuts;
+    std::array<KeyNode, numModes> roots;
+
+    // State of an unfinished sequence
+    const KeyNode* pendingNode = nullptr;
+    Mode pendingMode = Mode::normal;
+    int pendingCount = 0;
+    std::vector<juce::KeyPress> pendingKeys;
+
+    std::function<bool (juce::juce_wchar)> registerCallback;
+
+    MacroRecorder macros;
+    int replayDepth = 0;
 };
@@ -0,0 +1,75 @@
+#include "Data/MacroRecorder.h"
+
+bool MacroRecorder::isValidRegister (juce::juce_wchar reg)
+{
+    return juce::CharacterFunctions::isLetterOrDigit (reg);
+}
+
+void MacroRecorder::startRecording (juce::juce_wchar reg)
+{
+    jassert (isValidRegister (reg));
+
+    recording.clear();
+    recordingRegister = reg;
+}
+
+void MacroRecorder::stopRecording()
+{
+    if (! isRecording())
+        return;
+
+    registers[recordingRegister] = std::move (recording);
+    recording.clear();
+    recordingRegister = 0;
+}
+
+bool MacroRecorder::isRecording() const
+{
+    return recordingRegister != 0;
+}
+
+juce::juce_wchar MacroRecorder::getRecordingRegister() const
+{
+    return recordingRegister;
+}
+
+void MacroRecorder::record (const MacroStep& step)
+{
+    if (isRecording())
+        recording.push_back (step);
+}
+
+const Macro* MacroRecorder::getMacro (juce::juce_wchar reg) const
+{
+    auto it = registers.find (reg);
+    return it != registers.end() ? &it->second : nullptr;
+}
+
+void MacroRecorder::setLastReplayedRegister (juce::juce_wchar reg)
+{
+    lastReplayedRegister = reg;
+}
+
+juce::juce_wchar MacroRecorder::getLastReplayedRegister() const
+{
+    return lastReplayedRegister;
+}
+
+void MacroRecorder::setLastChange (const MacroStep& step)
+{
+    lastChange = step;
+}
+
+std::optional<MacroStep> MacroRecorder::getLastChange() const
+{
+    return lastChange;
+}
+
+void MacroRecorder::clear()
+{
+    registers.clear();
+    recording.clear();
+    recordingRegister = 0;
+    lastReplayedRegister = 0;
+    lastChange.reset();
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <optional>
+#include <vector>
+
+// One executed shortcut: which binding ran and with what count
+struct MacroStep
+{
+    int shortcutIndex = -1;
+    int count = 1;
+};
+
+using Macro = std::vector<MacroStep>;
+
+// Named registers of recorded shortcut steps (vim's q{register} / @{register})
+// and the last change for dot-repeat. Steps refer to shortcuts by their index
+// in the KeyboardShortcutManager, so a macro is a compact list of model
+// operations rather than raw key events.
+class MacroRecorder
+{
+public:
+    static bool isValidRegister (juce::juce_wchar reg);
+
+    void startRecording (juce::juce_wchar reg);
+    void stopRecording();
+    bool isRecording() const;
+    juce::juce_wchar getRecordingRegister() const;
+
+    // Appends to the register being recorded, if any
+    void record (const MacroStep& step);
+
+    const Macro* getMacro (juce::juce_wchar reg) const;
+
+    void setLastReplayedRegister (juce::juce_wchar reg);
+    juce::juce_wchar getLastReplayedRegister() const;
+
+    void setLastChange (const MacroStep& step);
+    std::optional<MacroStep> getLastChange() const;
+
+    // Shortcut indices are no longer valid once bindings are removed
+    void clear();
+
+private:
+    std::map<juce::juce_wchar, Macro> registers;
+    Macro recording;
+    juce::juce_wchar recordingRegister = 0;
+    juce::juce_wchar lastReplayedRegister = 0;
+    std::optional<MacroStep> lastChange;
+};
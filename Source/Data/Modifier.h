@@ -5,6 +5,7 @@
 #include <JuceHeader.h>
 #include <map>
 #include <variant>
+#include <vector>
 
 // Type alias - used throughout codebase
 using ModifierType = juce::Identifier;
@@ -18,6 +19,8 @@ DECLARE_ID (RandomPitchVariation)
 DECLARE_ID (RandomTrigger)
 DECLARE_ID (RandomOctaveShift)
 DECLARE_ID (RandomVelocity)
+DECLARE_ID (Condition)
+DECLARE_ID (Ratchet)
 
 // Parameter IDs
 DECLARE_ID (RandomPitchVariationProbability)
@@ -30,14 +33,21 @@ DECLARE_ID (RandomOctaveShiftRangeMax)
 DECLARE_ID (RandomVelocityProbability)
 DECLARE_ID (RandomVelocityRangeMin)
 DECLARE_ID (RandomVelocityRangeMax)
+DECLARE_ID (ConditionType)
+DECLARE_ID (ConditionA)
+DECLARE_ID (ConditionB)
+DECLARE_ID (RatchetHits)
+DECLARE_ID (RatchetGate)
 
 #undef DECLARE_ID
 
-inline const std::array<juce::Identifier, 4> AllTypes = {
+inline const std::array<juce::Identifier, 6> AllTypes = {
     RandomPitchVariation,
     RandomTrigger,
     RandomOctaveShift,
-    RandomVelocity
+    RandomVelocity,
+    Condition,
+    Ratchet
 };
 
 } // namespace ModifierIDs
@@ -51,6 +61,7 @@ struct SingleValueParamDefinition
     double min;
     double max;
     double interval;
+    std::vector<juce::String> choices; // Labels for the values min..max of a choice widget
 };
 
 struct DualValueParamDefinition
@@ -6,7 +6,8 @@
 
 namespace
 {
-static std::mt19937 rng { std::random_device {}() };
+// One generator per thread, so tracks can be scheduled in parallel
+thread_local std::mt19937 rng { std::random_device {}() };
 
 static bool reg0 = (ModifierApplicator::getInstance().registerSnapshotCallback (
                         ModifierIDs::RandomPitchVariation,
@@ -27,12 +28,14 @@ static bool reg0 = (ModifierApplicator::getInstance().registerSnapshotCallback (
                             while (steps == 0)
                                 steps = stepDist (rng);
 
-                            Degree currentDegree (note.noteNumber - 64);
+                            Degree currentDegree (note.noteNumber + note.detune - 64);
                             auto shifted = scale.applySteps (currentDegree, steps, false);
                             if (! shifted.has_value())
                                 return note;
 
-                            note.noteNumber = std::clamp (static_cast<int> (64 + shifted->value), 0, 127);
+                            auto pitch = 64 + shifted->value;
+                            note.noteNumber = std::clamp (juce::roundToInt (pitch), 0, 127);
+                            note.detune = static_cast<float> (pitch - juce::roundToInt (pitch));
                             return note;
                         }),
                     true);
@@ -85,4 +88,32 @@ static bool reg3 = (ModifierApplicator::getInstance().registerSnapshotCallback (
                             return note;
                         }),
                     true);
+
+// Conditions are only recorded here: whether the note plays depends on the
+// loop pass, which is known when the note is scheduled
+static bool reg4 = (ModifierApplicator::getInstance().registerSnapshotCallback (
+                        ModifierIDs::Condition,
+                        [] (const ModifierParameterSnapshot& snapshot, MidiNote note, const Scale&) -> MidiNote
+                        {
+                            note.condition = snapshot.getParam<int> (ModifierIDs::ConditionType, 0);
+                            note.conditionA = snapshot.getParam<int> (ModifierIDs::ConditionA, 1);
+                            note.conditionB = snapshot.getParam<int> (ModifierIDs::ConditionB, 2);
+                            return note;
+                        }),
+                    true);
+
+static bool reg5 = (ModifierApplicator::getInstance().registerSnapshotCallback (
+                        ModifierIDs::Ratchet,
+                        [] (const ModifierParameterSnapshot& snapshot, MidiNote note, const Scale&) -> MidiNote
+                        {
+                            note.ratchets = std::clamp (snapshot.getParam<int> (ModifierIDs::RatchetHits, 1), 1, 8);
+                            note.ratchetGate = std::clamp (snapshot.getParam<float> (ModifierIDs::RatchetGate, 0.5f), 0.1f, 1.0f);
+                            return note;
+                        }),
+                    true);
 } // namespace
+
+void ModifierApplicator::seedThreadRandom (std::uint32_t seed)
+{
+    rng.seed (seed);
+}
@@ -4,6 +4,7 @@
 #include "Data/Note.h"
 #include "Data/Scale.h"
 #include <JuceHeader.h>
+#include <cstdint>
 #include <functional>
 #include <map>
 
@@ -73,6 +74,10 @@ public:
         return current;
     }
 
+    // Random modifiers draw from a generator owned by the calling thread.
+    // Seeding it makes the notes that thread extracts next reproducible
+    static void seedThreadRandom (std::uint32_t seed);
+
 private:
     ModifierApplicator() {}
 
@@ -1,4 +1,5 @@
 #include "ModifierRegistry.h"
+#include "Data/TrigCondition.h"
 
 ModifierRegistry& ModifierRegistry::getInstance()
 {
@@ -153,4 +154,56 @@ static bool reg3 = ModifierRegistry::getInstance().registerModifier ({ .type = M
                                                                                                       .max = 127.0,
                                                                                                       .interval = 1.0 },
                                                                        } });
+
+static bool reg4 = ModifierRegistry::getInstance().registerModifier ({ .type = ModifierIDs::Condition,
+                                                                       .displayName = "Trig Condition",
+                                                                       .description = "Plays the note only on some passes of the loop: while fill is on or off, on the A-th of every B passes, on the first pass or after it, or depending on whether the previous conditional note played (Pre). The same passes play every time.",
+                                                                       .navShortcutDescription = "c",
+                                                                       .componentType = juce::Identifier ("sliderPanel"),
+                                                                       .params = {
+                                                                           SingleValueParamDefinition { .id = ModifierIDs::ConditionType,
+                                                                                                        .displayName = "Condition",
+                                                                                                        .widgetType = ParamWidgetType::choice,
+                                                                                                        .defaultVal = static_cast<double> (TrigCondition::Type::ratio),
+                                                                                                        .min = 0.0,
+                                                                                                        .max = static_cast<double> (TrigCondition::names.size() - 1),
+                                                                                                        .interval = 1.0,
+                                                                                                        .choices = { TrigCondition::names.begin(), TrigCondition::names.end() } },
+                                                                           SingleValueParamDefinition { .id = ModifierIDs::ConditionA,
+                                                                                                        .displayName = "A (pass)",
+                                                                                                        .widgetType = ParamWidgetType::slider,
+                                                                                                        .defaultVal = 1.0,
+                                                                                                        .min = 1.0,
+                                                                                                        .max = 8.0,
+                                                                                                        .interval = 1.0 },
+                                                                           SingleValueParamDefinition { .id = ModifierIDs::ConditionB,
+                                                                                                        .displayName = "B (of every)",
+                                                                                                        .widgetType = ParamWidgetType::slider,
+                                                                                                        .defaultVal = 2.0,
+                                                                                                        .min = 1.0,
+                                                                                                        .max = 8.0,
+                                                                                                        .interval = 1.0 },
+                                                                       } });
+
+static bool reg5 = ModifierRegistry::getInstance().registerModifier ({ .type = ModifierIDs::Ratchet,
+                                                                       .displayName = "Ratchet",
+                                                                       .description = "Splits the note into evenly spaced repeats of the same key. Gate sets how much of each repeat sounds.",
+                                                                       .navShortcutDescription = "t",
+                                                                       .componentType = juce::Identifier ("sliderPanel"),
+                                                                       .params = {
+                                                                           SingleValueParamDefinition { .id = ModifierIDs::RatchetHits,
+                                                                                                        .displayName = "Hits",
+                                                                                                        .widgetType = ParamWidgetType::slider,
+                                                                                                        .defaultVal = 2.0,
+                                                                                                        .min = 1.0,
+                                                                                                        .max = 8.0,
+                                                                                                        .interval = 1.0 },
+                                                                           SingleValueParamDefinition { .id = ModifierIDs::RatchetGate,
+                                                                                                        .displayName = "Gate",
+                                                                                                        .widgetType = ParamWidgetType::slider,
+                                                                                                        .defaultVal = 0.5,
+                                                                                                        .min = 0.1,
+                                                                                                        .max = 1.0,
+                                                                                                        .interval = 0.05 },
+                                                                       } });
 } // namespace
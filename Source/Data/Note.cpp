@@ -14,34 +14,121 @@
 #include <algorithm>
 #include <vector>
 
-Note::Note (double deg, double time, double dur) : state (NoteIDs::Note)
+namespace
+{
+// Notes are only created on the message thread
+juce::uint32 nextNoteId = 1;
+} // namespace
+
+Note::Note (double deg, double time, double dur) : state (NoteIDs::Note), id (nextNoteId++)
 {
     state.setProperty (NoteIDs::Degree, deg, nullptr);
     state.setProperty (NoteIDs::StartTime, time, nullptr);
     state.setProperty (NoteIDs::Duration, dur, nullptr);
     state.setProperty (NoteIDs::Velocity, 100, nullptr);
     state.setProperty (NoteIDs::Octave, 0.0, nullptr);
+
+    refreshFields();
+    state.addListener (this);
 }
 
 Note::Note (juce::ValueTree existingState)
-    : state (std::move (existingState))
+    : state (std::move (existingState)),
+      id (nextNoteId++)
 {
     jassert (state.hasType (NoteIDs::Note));
+
+    refreshFields();
+    state.addListener (this);
+}
+
+Note::Note (const Note& other)
+    : lastTriggeredMidiNote (other.lastTriggeredMidiNote),
+      state (other.state),
+      fields (other.fields),
+      id (other.id),
+      revision (other.revision)
+{
+    state.addListener (this);
+}
+
+Note& Note::operator= (const Note& other)
+{
+    if (this != &other)
+    {
+        state.removeListener (this);
+        state = other.state;
+        fields = other.fields;
+        id = other.id;
+        revision = other.revision;
+        lastTriggeredMidiNote = other.lastTriggeredMidiNote;
+        state.addListener (this);
+    }
+
+    return *this;
 }
 
-Note::~Note() {}
+Note::~Note()
+{
+    state.removeListener (this);
+}
+
+void Note::refreshFields()
+{
+    fields.degree = state.getProperty (NoteIDs::Degree);
+    fields.startTime = state.getProperty (NoteIDs::StartTime);
+    fields.duration = state.getProperty (NoteIDs::Duration);
+    fields.octave = state.getProperty (NoteIDs::Octave);
+    fields.velocity = state.getProperty (NoteIDs::Velocity);
+}
+
+void Note::valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property)
+{
+    ++revision;
+
+    // Modifier children report their parameter changes through the note's tree as well
+    if (tree != state)
+        return;
+
+    if (property == NoteIDs::Degree)
+        fields.degree = tree.getProperty (property);
+    else if (property == NoteIDs::StartTime)
+        fields.startTime = tree.getProperty (property);
+    else if (property == NoteIDs::Duration)
+        fields.duration = tree.getProperty (property);
+    else if (property == NoteIDs::Octave)
+        fields.octave = tree.getProperty (property);
+    else if (property == NoteIDs::Velocity)
+        fields.velocity = tree.getProperty (property);
+}
+
+void Note::valueTreeChildAdded ([[maybe_unused]] juce::ValueTree& parent, [[maybe_unused]] juce::ValueTree& child)
+{
+    ++revision;
+}
+
+void Note::valueTreeChildRemoved ([[maybe_unused]] juce::ValueTree& parent, [[maybe_unused]] juce::ValueTree& child, [[maybe_unused]] int index)
+{
+    ++revision;
+}
 
 juce::ValueTree& Note::getState() { return state; }
 
-double Note::getDegree() const { return state.getProperty (NoteIDs::Degree); }
+juce::uint32 Note::getId() const { return id; }
+
+juce::uint32 Note::createSourceId() { return nextNoteId++; }
 
-double Note::getDuration() const { return state.getProperty (NoteIDs::Duration); }
+juce::uint32 Note::getRevision() const { return revision; }
 
-double Note::getOctave() const { return state.getProperty (NoteIDs::Octave); }
+double Note::getDegree() const { return fields.degree; }
 
-double Note::getStartTime() const { return state.getProperty (NoteIDs::StartTime); }
+double Note::getDuration() const { return fields.duration; }
 
-int Note::getVelocity() const { return state.getProperty (NoteIDs::Velocity); }
+double Note::getOctave() const { return fields.octave; }
+
+double Note::getStartTime() const { return fields.startTime; }
+
+int Note::getVelocity() const { return fields.velocity; }
 
 void Note::setStartTime (double value, juce::UndoManager* undoManager)
 {
@@ -102,7 +189,7 @@ std::optional<Modifier> Note::getModifier (ModifierType type)
     return std::nullopt;
 }
 
-bool Note::hasAnyModifier()
+bool Note::hasAnyModifier() const
 {
     for (const auto& type : ModifierIDs::AllTypes)
     {
@@ -113,11 +200,17 @@ bool Note::hasAnyModifier()
     return false;
 }
 
-std::optional<MidiNote> Note::asMidiNote (Timeline t, [[maybe_unused]] Scale s, double tempo, int rootNote)
+std::optional<MidiNote> Note::asMidiNote (const Timeline& t, const Scale& s, double tempo, int rootNote)
 {
     double start = t.convertBarPositionToSeconds (getStartTime(), tempo);
     double dur = t.convertDivisionToSeconds (getDuration(), tempo);
-    auto midi = MidiNote (start, static_cast<int> (rootNote + getDegree()), getVelocity(), dur);
+
+    // Non-12-TET degrees play the nearest key; the remainder is carried as detune for tuning output
+    double pitch = rootNote + getDegree();
+    auto midi = MidiNote (start, juce::roundToInt (pitch), getVelocity(), dur);
+    midi.sourceId = id;
+    midi.sourceRevision = revision;
+    midi.detune = static_cast<float> (pitch - midi.noteNumber);
 
     // Create thread-safe parameter snapshots to avoid race conditions during modifier application
     std::vector<ModifierParameterSnapshot> modifierSnapshots;
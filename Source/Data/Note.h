@@ -34,6 +34,14 @@ struct MidiNote
     int velocity; // Velocity (0-127)
     double duration; // Duration in seconds
     bool isMuted = false; // Whether note was deactivated by modifier
+    float detune = 0.0f; // Offset from noteNumber in semitones (-0.5..0.5) for microtonal scales
+    juce::uint32 sourceId = 0; // Note::getId() of the note this came from
+    juce::uint32 sourceRevision = 0; // Note::getRevision() when it was converted
+    int condition = 0; // TrigCondition::Type, evaluated when the note is scheduled
+    int conditionA = 1; // A and B of an A:B condition
+    int conditionB = 2;
+    int ratchets = 1; // Hits the note is split into, played by the audio thread
+    float ratchetGate = 0.5f; // Fraction of each hit that sounds
 
     MidiNote (double t, int note, int vel, double dur)
         : startTime (t), noteNumber (note), velocity (vel), duration (dur) {}
@@ -45,12 +53,11 @@ public:
     Note (double deg = 0.0, double time = 0.0, double dur = Division::sixteenth);
     explicit Note (juce::ValueTree existingState);
 
-    ~Note();
+    ~Note() override;
 
-    Note (const Note&) = default;
-    Note& operator= (const Note&) = default;
-    Note (Note&&) = default;
-    Note& operator= (Note&&) = default;
+    // Listeners are attached per ValueTree handle, so copies must register themselves
+    Note (const Note& other);
+    Note& operator= (const Note& other);
 
     static bool isWithinRange (juce::ValueTree state, double minTime, double maxTime, double minDegree, double maxDegree)
     {
@@ -59,6 +66,11 @@ public:
         return startTime >= minTime && startTime < maxTime && degree >= minDegree && degree <= maxDegree;
     }
 
+    bool isWithinRange (double minTime, double maxTime, double minDegree, double maxDegree) const
+    {
+        return fields.startTime >= minTime && fields.startTime < maxTime && fields.degree >= minDegree && fields.degree <= maxDegree;
+    }
+
     juce::ValueTree& getState();
     double getDegree() const;
     double getDuration() const;
@@ -79,9 +91,40 @@ public:
     bool removeModifier (ModifierType type, UndoManager* undoManager = nullptr);
     std::optional<Modifier> getModifier (ModifierType type);
 
-    bool hasAnyModifier();
-    std::optional<MidiNote> asMidiNote (Timeline t, Scale s, double tempo, int rootNote = 64);
+    // Identifies this note while the program runs (not saved); copies share it
+    juce::uint32 getId() const;
+
+    // An id from the same counter as notes, for events that don't come from
+    // a stored note (a generator's output)
+    static juce::uint32 createSourceId();
+
+    // Bumped on every change to the note or its modifiers
+    juce::uint32 getRevision() const;
+
+    bool hasAnyModifier() const;
+    std::optional<MidiNote> asMidiNote (const Timeline& t, const Scale& s, double tempo, int rootNote = 64);
 
 private:
     juce::ValueTree state;
+
+    // Typed mirror of the note's properties. The getters are hit for every note on every
+    // paint and scheduling pass, so they read from here rather than going through juce::var.
+    struct Fields
+    {
+        double degree = 0.0;
+        double startTime = 0.0;
+        double duration = 0.0;
+        double octave = 0.0;
+        int velocity = 0;
+    };
+
+    Fields fields;
+
+    juce::uint32 id = 0;
+    juce::uint32 revision = 0;
+
+    void refreshFields();
+    void valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property) override;
+    void valueTreeChildAdded (juce::ValueTree& parent, juce::ValueTree& child) override;
+    void valueTreeChildRemoved (juce::ValueTree& parent, juce::ValueTree& child, int index) override;
 };
@@ -0,0 +1,218 @@
+#include "Data/NoteEditBatch.h"
+
+namespace
+{
+int applyingDepth = 0;
+
+struct ScopedApplying
+{
+    ScopedApplying() { ++applyingDepth; }
+    ~ScopedApplying() { --applyingDepth; }
+};
+
+class BulkNoteEditAction : public juce::UndoableAction
+{
+public:
+    BulkNoteEditAction (juce::ValueTree notes,
+                        std::vector<NoteEditBatch::PropertyChange> changes,
+                        std::vector<juce::ValueTree> added,
+                        std::vector<juce::ValueTree> removed)
+        : notesState (std::move (notes)),
+          propertyChanges (std::move (changes)),
+          addedNotes (std::move (added))
+    {
+        removals.reserve (removed.size());
+        for (auto& note : removed)
+            removals.push_back ({ std::move (note), -1 });
+    }
+
+    bool perform() override
+    {
+        {
+            ScopedApplying applying;
+
+            for (auto& change : propertyChanges)
+                change.note.setProperty (change.property, change.newValue, nullptr);
+
+            for (const auto& note : addedNotes)
+                notesState.addChild (note, -1, nullptr);
+
+            // Remember where each note was so undo can put it back in order
+            for (auto& removal : removals)
+            {
+                removal.index = notesState.indexOf (removal.note);
+                if (removal.index >= 0)
+                    notesState.removeChild (removal.index, nullptr);
+            }
+        }
+
+        notesState.sendPropertyChangeMessage (notesState.getType());
+        return true;
+    }
+
+    bool undo() override
+    {
+        {
+            ScopedApplying applying;
+
+            for (auto it = removals.rbegin(); it != removals.rend(); ++it)
+            {
+                if (it->index >= 0)
+                    notesState.addChild (it->note, it->index, nullptr);
+            }
+
+            for (auto it = addedNotes.rbegin(); it != addedNotes.rend(); ++it)
+                notesState.removeChild (*it, nullptr);
+
+            for (auto it = propertyChanges.rbegin(); it != propertyChanges.rend(); ++it)
+                it->note.setProperty (it->property, it->oldValue, nullptr);
+        }
+
+        notesState.sendPropertyChangeMessage (notesState.getType());
+        return true;
+    }
+
+    int getSizeInUnits() override
+    {
+        // Rough byte estimate: the change records plus the note trees kept
+        // alive for re-insertion
+        auto noteTreeSize = [] (const juce::ValueTree& note)
+        { return static_cast<int> (sizeof (juce::ValueTree)) + note.getNumProperties() * 32 + note.getNumChildren() * 64; };
+
+        int size = static_cast<int> (sizeof (*this) + propertyChanges.size() * sizeof (NoteEditBatch::PropertyChange));
+
+        for (const auto& note : addedNotes)
+            size += noteTreeSize (note);
+
+        for (const auto& removal : removals)
+            size += noteTreeSize (removal.note);
+
+        return size;
+    }
+
+    juce::UndoableAction* createCoalescedAction (juce::UndoableAction* nextAction) override
+    {
+        auto* next = dynamic_cast<BulkNoteEditAction*> (nextAction);
+
+        if (next == nullptr || next->notesState != notesState)
+            return nullptr;
+
+        // Only pure property edits over the same (note, property) list merge
+        if (! addedNotes.empty() || ! removals.empty() || ! next->addedNotes.empty() || ! next->removals.empty())
+            return nullptr;
+
+        if (propertyChanges.size() != next->propertyChanges.size())
+            return nullptr;
+
+        auto merged = propertyChanges;
+
+        for (size_t i = 0; i < merged.size(); ++i)
+        {
+            const auto& nextChange = next->propertyChanges[i];
+
+            if (merged[i].note != nextChange.note || merged[i].property != nextChange.property)
+                return nullptr;
+
+            merged[i].newValue = nextChange.newValue;
+        }
+
+        return new BulkNoteEditAction (notesState, std::move (merged), {}, {});
+    }
+
+private:
+    struct Removal
+    {
+        juce::ValueTree note;
+        int index = -1;
+    };
+
+    juce::ValueTree notesState;
+    std::vector<NoteEditBatch::PropertyChange> propertyChanges;
+    std::vector<juce::ValueTree> addedNotes;
+    std::vector<Removal> removals;
+};
+} // namespace
+
+//==============================================================================
+NoteEditBatch::NoteEditBatch (juce::ValueTree notes, const juce::String& batchName)
+    : notesState (std::move (notes)), name (batchName)
+{
+}
+
+void NoteEditBatch::setProperty (juce::ValueTree note, const juce::Identifier& property, const juce::var& newValue)
+{
+    auto oldValue = note.getProperty (property);
+
+    if (oldValue == newValue)
+        return;
+
+    propertyChanges.push_back ({ std::move (note), property, oldValue, newValue });
+}
+
+void NoteEditBatch::addNote (juce::ValueTree note)
+{
+    addedNotes.push_back (std::move (note));
+}
+
+void NoteEditBatch::removeNote (juce::ValueTree note)
+{
+    removedNotes.push_back (std::move (note));
+}
+
+bool NoteEditBatch::isEmpty() const
+{
+    return propertyChanges.empty() && addedNotes.empty() && removedNotes.empty();
+}
+
+const juce::String& NoteEditBatch::getName() const
+{
+    return name;
+}
+
+std::vector<juce::ValueTree> NoteEditBatch::getTargets() const
+{
+    std::vector<juce::ValueTree> targets;
+    targets.reserve (propertyChanges.size() + addedNotes.size() + removedNotes.size());
+
+    for (const auto& change : propertyChanges)
+        targets.push_back (change.note);
+
+    targets.insert (targets.end(), addedNotes.begin(), addedNotes.end());
+    targets.insert (targets.end(), removedNotes.begin(), removedNotes.end());
+
+    return targets;
+}
+
+bool NoteEditBatch::commit (juce::UndoManager* undoManager)
+{
+    if (isEmpty())
+        return false;
+
+    auto action = std::make_unique<BulkNoteEditAction> (notesState,
+                                                        std::move (propertyChanges),
+                                                        std::move (addedNotes),
+                                                        std::move (removedNotes));
+    propertyChanges.clear();
+    addedNotes.clear();
+    removedNotes.clear();
+
+    if (undoManager == nullptr)
+        return action->perform();
+
+    return undoManager->perform (action.release());
+}
+
+bool NoteEditBatch::isApplying()
+{
+    return applyingDepth > 0;
+}
+
+NoteEditBatch::ScopedDeferredNotifications::ScopedDeferredNotifications()
+{
+    ++applyingDepth;
+}
+
+NoteEditBatch::ScopedDeferredNotifications::~ScopedDeferredNotifications()
+{
+    --applyingDepth;
+}
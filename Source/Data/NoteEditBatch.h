@@ -0,0 +1,68 @@
+#pragma once
+
+#include "juce_data_structures/juce_data_structures.h"
+#include <JuceHeader.h>
+#include <vector>
+
+// Collects edits to the notes of one sequence and applies them as a single
+// undoable action.
+//
+// While a batch is being applied (perform, undo or redo), observers that only
+// need to know that "the notes changed" - Composition's dirty flag and the
+// cached grid layer - ignore the per-note callbacks and instead receive one
+// property-change message on the Notes tree once the whole batch is done.
+// Note and Sequence listeners still see every change, so cached note fields
+// and the Sequence::notes vector stay in sync.
+//
+// Consecutive batches that change the same properties on the same notes
+// coalesce into one action when they land in the same undo transaction, so
+// nudging a selection twenty times keeps one set of old/new values.
+class NoteEditBatch
+{
+public:
+    NoteEditBatch (juce::ValueTree notesState, const juce::String& name);
+
+    // Each property should be set at most once per note in a batch
+    void setProperty (juce::ValueTree note, const juce::Identifier& property, const juce::var& newValue);
+    void addNote (juce::ValueTree note);
+    void removeNote (juce::ValueTree note);
+
+    bool isEmpty() const;
+    const juce::String& getName() const;
+
+    // Every note this batch touches, in the order the edits were added
+    std::vector<juce::ValueTree> getTargets() const;
+
+    // Performs the batch through the undo manager as part of its current
+    // transaction, or applies it directly when undoManager is null.
+    // The batch is empty afterwards
+    bool commit (juce::UndoManager* undoManager);
+
+    // True while any batch is being applied, undone or redone
+    static bool isApplying();
+
+    // Holds back the coalesced notifications for a run of edits longer than
+    // one batch (macro replay): isApplying() stays true for the lifetime of
+    // this object, and the owner sends a single notification afterwards
+    struct ScopedDeferredNotifications
+    {
+        ScopedDeferredNotifications();
+        ~ScopedDeferredNotifications();
+    };
+
+    struct PropertyChange
+    {
+        juce::ValueTree note;
+        juce::Identifier property;
+        juce::var oldValue;
+        juce::var newValue;
+    };
+
+private:
+    juce::ValueTree notesState;
+    juce::String name;
+
+    std::vector<PropertyChange> propertyChanges;
+    std::vector<juce::ValueTree> addedNotes;
+    std::vector<juce::ValueTree> removedNotes;
+};
@@ -0,0 +1,95 @@
+#include "Data/NoteRecorder.h"
+#include "Data/Note.h"
+
+void NoteRecorder::setArmed (bool shouldBeArmed)
+{
+    armed = shouldBeArmed;
+
+    if (! armed)
+        clear();
+}
+
+bool NoteRecorder::isArmed() const
+{
+    return armed;
+}
+
+void NoteRecorder::noteOn (int noteNumber, int velocity, double beat)
+{
+    if (! juce::isPositiveAndBelow (noteNumber, (int) heldNotes.size()))
+        return;
+
+    // A retrigger without a note-off ends the previous note first
+    if (heldNotes[(size_t) noteNumber].active)
+        noteOff (noteNumber, beat);
+
+    heldNotes[(size_t) noteNumber] = { true, velocity, beat };
+}
+
+void NoteRecorder::noteOff (int noteNumber, double beat)
+{
+    if (! juce::isPositiveAndBelow (noteNumber, (int) heldNotes.size()))
+        return;
+
+    auto& held = heldNotes[(size_t) noteNumber];
+
+    if (! held.active)
+        return;
+
+    finishedNotes.push_back ({ noteNumber, held.velocity, held.startBeat, beat });
+    held.active = false;
+}
+
+void NoteRecorder::releaseAll (double beat)
+{
+    for (int i = 0; i < (int) heldNotes.size(); ++i)
+        noteOff (i, beat);
+}
+
+int NoteRecorder::addFinishedNotes (Sequence& seq, NoteEditBatch& batch)
+{
+    auto& timeline = seq.getTimeline();
+    const auto& scale = seq.getScale();
+    double stepSize = timeline.getStepSize();
+    int added = 0;
+
+    // Cells filled by this call, as the batch is not applied yet
+    std::vector<std::pair<double, double>> addedCells;
+
+    for (const auto& played : finishedNotes)
+    {
+        double startTime = timeline.wrapTime (std::round (played.startBeat / stepSize) * stepSize);
+        double duration = juce::jmax (stepSize, std::round ((played.endBeat - played.startBeat) / stepSize) * stepSize);
+
+        double rawDegree = played.noteNumber - seq.getRootNote();
+        if (rawDegree < scale.getLowerBound() || rawDegree > scale.getUpperBound())
+            continue;
+
+        double degree = scale.getNearestDegree (rawDegree);
+
+        juce::ValueTree noteState (NoteIDs::Note);
+        noteState.setProperty (NoteIDs::Degree, degree, nullptr);
+        noteState.setProperty (NoteIDs::StartTime, startTime, nullptr);
+        noteState.setProperty (NoteIDs::Duration, duration, nullptr);
+        noteState.setProperty (NoteIDs::Velocity, played.velocity, nullptr);
+
+        bool alreadyAdded = std::any_of (addedCells.begin(), addedCells.end(), [&] (const auto& cell)
+                                         { return juce::approximatelyEqual (cell.first, startTime) && juce::approximatelyEqual (cell.second, degree); });
+
+        if (alreadyAdded || seq.isExistingNote (noteState))
+            continue;
+
+        addedCells.emplace_back (startTime, degree);
+        batch.addNote (noteState);
+        ++added;
+    }
+
+    finishedNotes.clear();
+    return added;
+}
+
+void NoteRecorder::clear()
+{
+    heldNotes.fill ({});
+    finishedNotes.clear();
+}
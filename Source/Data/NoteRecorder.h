@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Data/Sequence.h"
+#include <JuceHeader.h>
+#include <array>
+#include <vector>
+
+// Turns live note-on / note-off pairs into notes on a sequence's step grid.
+// Times are transport beats; a note is written once it is released, with its
+// start rounded to the nearest step and its length to whole steps.
+class NoteRecorder
+{
+public:
+    void setArmed (bool shouldBeArmed);
+    bool isArmed() const;
+
+    void noteOn (int noteNumber, int velocity, double beat);
+    void noteOff (int noteNumber, double beat);
+
+    // Ends every held note, e.g. when the transport stops
+    void releaseAll (double beat);
+
+    // Quantises the finished notes onto the sequence and adds them to the
+    // batch, skipping cells that are already filled. Returns the number added
+    int addFinishedNotes (Sequence& seq, NoteEditBatch& batch);
+
+    void clear();
+
+private:
+    struct HeldNote
+    {
+        bool active = false;
+        int velocity = 0;
+        double startBeat = 0.0;
+    };
+
+    struct FinishedNote
+    {
+        int noteNumber = 0;
+        int velocity = 0;
+        double startBeat = 0.0;
+        double endBeat = 0.0;
+    };
+
+    bool armed = false;
+
+    std::array<HeldNote, 128> heldNotes;
+    std::vector<FinishedNote> finishedNotes;
+};
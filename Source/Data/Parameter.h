@@ -2,7 +2,8 @@ enum class ParamWidgetType
 {
     slider,
     rangeSlider,
-    toggle
+    toggle,
+    choice
 };
 
 struct Param
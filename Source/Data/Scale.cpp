@@ -1,4 +1,5 @@
 #include "Scale.h"
+#include "Data/ScaleRegistry.h"
 #include "juce_data_structures/juce_data_structures.h"
 #include <algorithm>
 #include <utility>
@@ -11,23 +12,92 @@ Degree::Degree (double init)
 Scale::Scale (const juce::String& name) : state (ScaleIDs::Scale)
 {
     setScale (name);
+    rebuildTable();
+    state.addListener (this);
 }
 
 Scale::Scale (juce::ValueTree existingState) : state (existingState.isValid() ? std::move (existingState) : juce::ValueTree (ScaleIDs::Scale))
 {
     if (! state.hasProperty (ScaleIDs::Name))
         setScale ("Major");
+
+    rebuildTable();
+    state.addListener (this);
 }
 
-const std::vector<juce::String> Scale::getScaleNames()
+Scale::Scale (const Scale& other)
+    : state (other.state),
+      degrees (other.degrees),
+      table (other.table)
 {
-    std::vector<juce::String> names;
+    state.addListener (this);
+}
 
-    for (auto name : scaleDefinitions)
+Scale& Scale::operator= (const Scale& other)
+{
+    if (this != &other)
     {
-        names.push_back (name.first);
+        state.removeListener (this);
+        state = other.state;
+        degrees = other.degrees;
+        table = other.table;
+        state.addListener (this);
     }
-    return names;
+
+    return *this;
+}
+
+Scale::~Scale()
+{
+    state.removeListener (this);
+}
+
+void Scale::valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property)
+{
+    // Covers setScale as well as undo/redo and files being loaded into the same tree
+    if (tree == state && property == ScaleIDs::Degrees)
+        rebuildTable();
+}
+
+void Scale::rebuildTable()
+{
+    degrees.clear();
+    table = {};
+
+    auto parts = juce::StringArray::fromTokens (state.getProperty (ScaleIDs::Degrees).toString(), "|", "");
+    for (const auto& part : parts)
+    {
+        degrees.push_back (part.getDoubleValue());
+    }
+
+    if (degrees.empty())
+        return;
+
+    auto descending = getDescendingDegrees();
+    auto numBelowRoot = static_cast<int> (descending.size()) - 1;
+    auto numFromRoot = static_cast<int> (degrees.size());
+
+    // Oversized scales keep the degrees closest to the root
+    jassert (numBelowRoot + numFromRoot <= DegreeTable::maxSize);
+    numFromRoot = std::min (numFromRoot, DegreeTable::maxSize / 2 + 1);
+    numBelowRoot = std::min (numBelowRoot, DegreeTable::maxSize - numFromRoot);
+
+    for (int i = numBelowRoot; i > 0; --i)
+        table.ladder[(size_t) table.size++] = descending[(size_t) i];
+
+    for (int i = 0; i < numFromRoot; ++i)
+        table.ladder[(size_t) table.size++] = degrees[(size_t) i];
+
+    for (size_t i = 1; i < degrees.size(); ++i)
+        table.smallestStep = std::min (table.smallestStep, degrees[i] - degrees[i - 1]);
+
+    table.microtonal = std::any_of (degrees.begin(), degrees.end(), [] (double d)
+                                    { return std::abs (d - std::round (d)) > DegreeTable::tolerance; });
+}
+
+const std::vector<juce::String> Scale::getScaleNames()
+{
+    return ScaleRegistry::getInstance().getScaleNames();
 }
 
 juce::ValueTree& Scale::getState() { return state; }
@@ -35,13 +105,10 @@ juce::ValueTree& Scale::getState() { return state; }
 void Scale::setScale (juce::String scaleName, juce::UndoManager* undoManager)
 {
     // Find the matching scale definition
-    auto scaleDef = std::find_if (scaleDefinitions.begin(), scaleDefinitions.end(), [&scaleName] (const auto& def)
-                                  { return def.first == scaleName; });
-
-    if (scaleDef != scaleDefinitions.end())
+    if (auto* scaleDef = ScaleRegistry::getInstance().getDefinition (scaleName))
     {
-        setName (scaleDef->first, undoManager);
-        setDegrees (scaleDef->second, undoManager);
+        setName (scaleDef->name, undoManager);
+        setDegrees (scaleDef->degrees, undoManager);
     }
 }
 
@@ -66,99 +133,65 @@ void Scale::setDegrees (std::vector<double> newDegrees, juce::UndoManager* undoM
     state.setProperty (ScaleIDs::Degrees, degreesAsVar.joinIntoString ("|"), undoManager);
 }
 
-std::vector<double> Scale::getDegrees() const
+const std::vector<double>& Scale::getDegrees() const
 {
-    std::vector<double> result;
-
-    auto parts = juce::StringArray::fromTokens (state.getProperty (ScaleIDs::Degrees).toString(), "|", "");
-    for (const auto& part : parts)
-    {
-        result.push_back (part.getDoubleValue());
-    }
-    return result;
+    return degrees;
 }
 
 const Degree Scale::getHigher (const Degree& d, bool shouldWrap) const
 {
-    auto descendingDegrees = getDescendingDegrees();
-    auto degrees = getDegrees();
+    if (table.size == 0)
+        return d;
 
-    if (d.value >= 0.0)
+    auto index = table.indexOf (d.value);
+
+    if (index >= 0)
     {
-        // For zero or positive values, find in ascending sequence
-        auto it = std::upper_bound (degrees.begin(), degrees.end(), d.value);
+        if (index + 1 < table.size)
+            return Degree (table.at (index + 1));
+
+        return shouldWrap ? Degree (table.at (0)) : d; // At highest value, stay there
+    }
 
-        if (it != degrees.end())
-        {
-            return Degree (*it);
-        }
+    // Off-scale negative values have no neighbour to move to
+    if (d.value < 0.0)
+        return d;
 
-        if (shouldWrap)
-            return Degree (getLowerBound());
+    auto it = std::upper_bound (table.ladder.begin(), table.ladder.begin() + table.size, d.value);
 
-        return Degree (d.value); // At highest value, stay there
-    }
-    else
-    {
-        // For negative values, find this value in descending sequence
-        auto it = std::find_if (descendingDegrees.begin(), descendingDegrees.end(), [d] (double val)
-                                { return std::abs (val - d.value) < 0.0001; });
-
-        if (it != descendingDegrees.end())
-        {
-            if (it == descendingDegrees.begin())
-            {
-                return Degree (0.0); // Return to zero
-            }
-            return Degree (*std::prev (it)); // Move up in descending sequence
-        }
-        return Degree (d.value); // Not found, stay at current value
-    }
+    if (it != table.ladder.begin() + table.size)
+        return Degree (*it);
+
+    return shouldWrap ? Degree (table.at (0)) : d;
 }
 
 const Degree Scale::getLower (const Degree& d, bool shouldWrap) const
 {
-    // Get the descending scale degrees
-    auto descendingDegrees = getDescendingDegrees();
-    auto degrees = getDegrees();
+    if (table.size == 0)
+        return d;
 
-    if (d.value > 0.0)
+    auto index = table.indexOf (d.value);
+
+    if (index >= 0)
     {
-        // For positive values, first try to find a lower positive degree
-        auto it = std::lower_bound (degrees.begin(), degrees.end(), d.value);
-        if (it != degrees.begin())
-        {
-            return Degree (*(--it));
-        }
-        // If we can't go lower in positive degrees, return first negative
-        return Degree (descendingDegrees[1]); // [0] is 0.0, [1] is first negative
+        if (index > 0)
+            return Degree (table.at (index - 1));
+
+        return shouldWrap ? Degree (table.at (table.size - 1)) : d; // At lowest value, stay there
     }
-    else if (d.value == 0.0)
+
+    if (d.value > 0.0)
     {
-        // Special case for 0.0 - return first negative degree
-        return Degree (descendingDegrees[1]);
+        // The root is always in the table, so there is a lower degree to fall back to
+        auto it = std::lower_bound (table.ladder.begin(), table.ladder.begin() + table.size, d.value);
+        return Degree (*std::prev (it));
     }
-    else
-    {
-        // For negative values, find this value in descending sequence
-        auto it = std::find_if (descendingDegrees.begin(), descendingDegrees.end(), [d] (double val)
-                                { return std::abs (val - d.value) < 0.0001; });
 
-        if (it != descendingDegrees.end() && std::next (it) != descendingDegrees.end())
-        {
-            return Degree (*std::next (it));
-        }
-
-        if (shouldWrap)
-            return Degree (getUpperBound());
-
-        return Degree (d.value); // At lowest value, stay there
-    }
+    return shouldWrap ? Degree (getUpperBound()) : d;
 }
 
 double Scale::getUpperBound() const
 {
-    auto degrees = getDegrees();
     if (! degrees.empty())
     {
         return degrees.back();
@@ -168,29 +201,25 @@ double Scale::getUpperBound() const
 
 double Scale::getLowerBound() const
 {
-    auto descendingDegrees = getDescendingDegrees();
-    if (! descendingDegrees.empty())
+    if (table.size > 0)
     {
-        return descendingDegrees.back();
+        return table.at (0);
     }
     return 0.0;
 }
 
 double Scale::getSmallestStepSize() const
 {
-    auto degrees = getDegrees();
-    double smallest = std::numeric_limits<double>::max();
-    for (size_t i = 1; i < degrees.size(); ++i)
-    {
-        double step = degrees[i] - degrees[i - 1];
-        smallest = std::min (smallest, step);
-    }
-    return smallest;
+    return table.smallestStep;
+}
+
+bool Scale::isMicrotonal() const
+{
+    return table.microtonal;
 }
 
 double Scale::size() const
 {
-    auto degrees = getDegrees();
     if (! degrees.empty())
     {
         return degrees.back() - (-degrees.back()) + 1;
@@ -201,7 +230,6 @@ double Scale::size() const
 std::vector<double> Scale::getDescendingDegrees() const
 {
     std::vector<double> descending;
-    auto degrees = getDegrees();
     if (degrees.empty())
         return descending;
 
@@ -231,43 +259,29 @@ int Scale::getStepsBetween (const Degree& from, const Degree& to) const
     if (juce::approximatelyEqual (from.value, to.value))
         return 0;
 
+    auto fromIndex = table.indexOf (from.value);
+    auto toIndex = table.indexOf (to.value);
+
+    if (fromIndex >= 0 && toIndex >= 0)
+        return toIndex - fromIndex;
+
+    // Off-scale degrees: walk towards the target one step at a time
     bool goingUp = to.value > from.value;
     int steps = 0;
     Degree current = from;
 
-    const int maxIterations = 100;
-
-    if (goingUp)
-    {
-        for (int i = 0; i < maxIterations; ++i)
-        {
-            Degree next = getHigher (current, false);
-
-            if (juce::approximatelyEqual (next.value, current.value))
-                break;
-
-            steps++;
-            current = next;
-
-            if (juce::approximatelyEqual (current.value, to.value))
-                return steps;
-        }
-    }
-    else
+    for (int i = 0; i < table.size; ++i)
     {
-        for (int i = 0; i < maxIterations; ++i)
-        {
-            Degree next = getLower (current, false);
+        Degree next = goingUp ? getHigher (current, false) : getLower (current, false);
 
-            if (juce::approximatelyEqual (next.value, current.value))
-                break;
+        if (juce::approximatelyEqual (next.value, current.value))
+            break;
 
-            steps--;
-            current = next;
+        steps += goingUp ? 1 : -1;
+        current = next;
 
-            if (juce::approximatelyEqual (current.value, to.value))
-                return steps;
-        }
+        if (juce::approximatelyEqual (current.value, to.value))
+            return steps;
     }
 
     return steps;
@@ -275,39 +289,56 @@ int Scale::getStepsBetween (const Degree& from, const Degree& to) const
 
 std::optional<Degree> Scale::applySteps (const Degree& from, int steps, bool shouldWrap) const
 {
-    Degree current = from;
-    if (steps > 0)
+    if (steps == 0 || table.size == 0)
+        return from;
+
+    auto index = table.indexOf (from.value);
+
+    if (index < 0)
     {
-        for (int i = 0; i < steps; ++i)
-        {
-            Degree next = getHigher (current, shouldWrap);
-            if (! shouldWrap && juce::approximatelyEqual (next.value, current.value))
-                return std::nullopt;
-            current = next;
-        }
+        // An off-scale degree takes its first step the slow way, which lands it in the table
+        Degree next = steps > 0 ? getHigher (from, shouldWrap) : getLower (from, shouldWrap);
+
+        if (juce::approximatelyEqual (next.value, from.value))
+            return shouldWrap ? std::optional<Degree> (from) : std::nullopt;
+
+        return applySteps (next, steps > 0 ? steps - 1 : steps + 1, shouldWrap);
     }
-    else if (steps < 0)
+
+    auto target = index + steps;
+
+    if (target < 0 || target >= table.size)
     {
-        for (int i = 0; i > steps; --i)
-        {
-            Degree next = getLower (current, shouldWrap);
-            if (! shouldWrap && juce::approximatelyEqual (next.value, current.value))
-                return std::nullopt;
-            current = next;
-        }
+        if (! shouldWrap)
+            return std::nullopt;
+
+        target = ((target % table.size) + table.size) % table.size;
     }
-    return current;
+
+    return Degree (table.at (target));
 }
 
 double Scale::getNearestDegree (double rawDegree) const
 {
-    auto degrees = getDegrees();
-    auto descending = getDescendingDegrees();
+    if (table.size == 0)
+        return rawDegree;
+
+    auto end = table.ladder.begin() + table.size;
+    auto above = std::lower_bound (table.ladder.begin(), end, rawDegree);
+
+    if (above == table.ladder.begin())
+        return *above;
+
+    if (above == end)
+        return *std::prev (end);
 
-    degrees.insert (degrees.end(), descending.begin() + 1, descending.end());
+    auto below = std::prev (above);
+    auto distanceBelow = std::abs (*below - rawDegree);
+    auto distanceAbove = std::abs (*above - rawDegree);
 
-    auto nearest = std::min_element (degrees.begin(), degrees.end(), [rawDegree] (double a, double b)
-                                     { return std::abs (a - rawDegree) < std::abs (b - rawDegree); });
+    // Ties resolve towards the root
+    if (juce::approximatelyEqual (distanceBelow, distanceAbove))
+        return std::abs (*below) < std::abs (*above) ? *below : *above;
 
-    return *nearest;
+    return distanceBelow < distanceAbove ? *below : *above;
 }
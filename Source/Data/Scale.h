@@ -2,6 +2,8 @@
 
 #include "juce_data_structures/juce_data_structures.h"
 #include <JuceHeader.h>
+#include <array>
+#include <limits>
 #include <vector>
 
 namespace ScaleIDs
@@ -13,14 +15,6 @@ DECLARE_ID (Degrees)
 #undef DECLARE_ID
 } // namespace ScaleIDs
 
-// Define static scale definitions
-const std::map<juce::String, std::vector<double>> scaleDefinitions = {
-    { "Natural Minor", { 0.0, 2.0, 3.0, 5.0, 7.0, 8.0, 10.0, 12.0 } },
-    { "Major", { 0.0, 2.0, 4.0, 5.0, 7.0, 9.0, 11.0, 12.0 } },
-    { "Blues", { 0.0, 3.0, 5.0, 6.0, 7.0, 10.0, 12.0 } },
-    { "Pentatonic", { 0.0, 2.0, 4.0, 7.0, 9.0, 12.0 } }
-};
-
 class Degree
 {
 public:
@@ -28,11 +22,15 @@ public:
     double value;
 };
 
-class Scale
+class Scale : juce::ValueTree::Listener
 {
 public:
     explicit Scale (const juce::String& name);
     explicit Scale (juce::ValueTree existingState);
+    ~Scale() override;
+
+    Scale (const Scale& other);
+    Scale& operator= (const Scale& other);
 
     static const std::vector<juce::String> getScaleNames();
 
@@ -46,9 +44,12 @@ public:
 
     double getSmallestStepSize() const;
 
+    // True when any degree falls between equal-tempered semitones
+    bool isMicrotonal() const;
+
     double size() const;
 
-    std::vector<double> getDegrees() const;
+    const std::vector<double>& getDegrees() const;
     juce::String getName() const;
 
     void setScale (juce::String scaleName, juce::UndoManager* undoManager = nullptr);
@@ -57,7 +58,51 @@ public:
 
 private:
     juce::ValueTree state;
+
+    // The scale's degrees below the root (the descending set) then from the root up,
+    // lowest first: about an octave either side, not a map over the MIDI range.
+    // Navigation queries are index lookups into this table; it is only rebuilt
+    // when the Degrees property changes.
+    struct DegreeTable
+    {
+        static constexpr int maxSize = 128; // Capacity for both halves; far more than any scale defines
+        static constexpr double tolerance = 0.0001;
+
+        std::array<double, maxSize> ladder {};
+        int size = 0;
+        double smallestStep = std::numeric_limits<double>::max();
+        bool microtonal = false;
+
+        constexpr int indexOf (double degree) const
+        {
+            int low = 0;
+            int high = size;
+
+            while (low < high)
+            {
+                auto mid = (low + high) / 2;
+
+                if (ladder[(size_t) mid] < degree - tolerance)
+                    low = mid + 1;
+                else
+                    high = mid;
+            }
+
+            if (low < size && ladder[(size_t) low] - degree < tolerance)
+                return low;
+
+            return -1;
+        }
+
+        constexpr double at (int index) const { return ladder[(size_t) index]; }
+    };
+
+    std::vector<double> degrees;
+    DegreeTable table;
+
+    void rebuildTable();
     std::vector<double> getDescendingDegrees() const;
+    void valueTreePropertyChanged (juce::ValueTree& tree, const juce::Identifier& property) override;
 
     void setDegrees (std::vector<double> degrees, juce::UndoManager* undoManager = nullptr);
     void setName (juce::String name, juce::UndoManager* undoManager = nullptr);
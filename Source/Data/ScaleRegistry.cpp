@@ -0,0 +1,172 @@
+#include "ScaleRegistry.h"
+#include <cmath>
+
+namespace
+{
+static bool reg0 = ScaleRegistry::getInstance().registerScale ({ .name = "Natural Minor",
+                                                                 .degrees = { 0.0, 2.0, 3.0, 5.0, 7.0, 8.0, 10.0, 12.0 },
+                                                                 .description = "Aeolian mode" });
+
+static bool reg1 = ScaleRegistry::getInstance().registerScale ({ .name = "Major",
+                                                                 .degrees = { 0.0, 2.0, 4.0, 5.0, 7.0, 9.0, 11.0, 12.0 },
+                                                                 .description = "Ionian mode" });
+
+static bool reg2 = ScaleRegistry::getInstance().registerScale ({ .name = "Blues",
+                                                                 .degrees = { 0.0, 3.0, 5.0, 6.0, 7.0, 10.0, 12.0 },
+                                                                 .description = "Minor blues scale" });
+
+static bool reg3 = ScaleRegistry::getInstance().registerScale ({ .name = "Pentatonic",
+                                                                 .degrees = { 0.0, 2.0, 4.0, 7.0, 9.0, 12.0 },
+                                                                 .description = "Major pentatonic scale" });
+
+// A Scala pitch line is either cents (contains a '.') or a ratio such as 3/2 or 2
+std::optional<double> parseScalaPitch (const juce::String& line)
+{
+    auto token = line.trim().upToFirstOccurrenceOf (" ", false, false).upToFirstOccurrenceOf ("\t", false, false);
+
+    if (token.isEmpty())
+        return std::nullopt;
+
+    if (token.containsChar ('.'))
+        return token.getDoubleValue();
+
+    auto numerator = token.upToFirstOccurrenceOf ("/", false, false).getLargeIntValue();
+    auto denominator = token.containsChar ('/') ? token.fromFirstOccurrenceOf ("/", false, false).getLargeIntValue() : 1;
+
+    if (numerator <= 0 || denominator <= 0)
+        return std::nullopt;
+
+    return 1200.0 * std::log2 (static_cast<double> (numerator) / static_cast<double> (denominator));
+}
+} // namespace
+
+ScaleRegistry& ScaleRegistry::getInstance()
+{
+    static ScaleRegistry instance;
+    return instance;
+}
+
+bool ScaleRegistry::registerScale (ScaleDefinition def)
+{
+    if (def.name.isEmpty() || def.degrees.size() < 2)
+        return false;
+
+    definitions[def.name] = std::move (def);
+    return true;
+}
+
+std::vector<juce::String> ScaleRegistry::getScaleNames() const
+{
+    std::vector<juce::String> names;
+    names.reserve (definitions.size());
+    for (const auto& [name, def] : definitions)
+    {
+        names.push_back (name);
+    }
+    return names;
+}
+
+const ScaleDefinition* ScaleRegistry::getDefinition (const juce::String& name) const
+{
+    auto it = definitions.find (name);
+    if (it != definitions.end())
+    {
+        return &it->second;
+    }
+    return nullptr;
+}
+
+bool ScaleRegistry::hasScale (const juce::String& name) const
+{
+    return definitions.find (name) != definitions.end();
+}
+
+std::optional<ScaleDefinition> ScaleRegistry::parseScalaFile (const juce::File& file)
+{
+    juce::StringArray lines;
+    file.readLines (lines);
+
+    ScaleDefinition def;
+    def.name = file.getFileNameWithoutExtension();
+    def.degrees.push_back (0.0);
+
+    int expectedPitches = -1;
+    bool hasDescription = false;
+
+    for (const auto& line : lines)
+    {
+        if (line.startsWithChar ('!'))
+            continue;
+
+        // The first non-comment line is the description, and may be blank
+        if (! hasDescription)
+        {
+            def.description = line.trim();
+            hasDescription = true;
+            continue;
+        }
+
+        if (expectedPitches < 0)
+        {
+            expectedPitches = line.trim().getIntValue();
+
+            if (expectedPitches <= 0 || expectedPitches > maxScalaPitches)
+            {
+                juce::Logger::writeToLog ("Unsupported number of pitches in " + file.getFileName());
+                return std::nullopt;
+            }
+            continue;
+        }
+
+        if (line.trim().isEmpty())
+            continue;
+
+        auto cents = parseScalaPitch (line);
+
+        if (! cents.has_value() || *cents / 100.0 <= def.degrees.back())
+        {
+            juce::Logger::writeToLog ("Invalid or non-ascending pitch '" + line.trim() + "' in " + file.getFileName());
+            return std::nullopt;
+        }
+
+        def.degrees.push_back (*cents / 100.0);
+
+        if (static_cast<int> (def.degrees.size()) - 1 == expectedPitches)
+            break;
+    }
+
+    if (static_cast<int> (def.degrees.size()) - 1 != expectedPitches)
+    {
+        juce::Logger::writeToLog ("Scala file ended early: " + file.getFileName());
+        return std::nullopt;
+    }
+
+    return def;
+}
+
+bool ScaleRegistry::loadScalaFile (const juce::File& file)
+{
+    auto def = parseScalaFile (file);
+
+    if (! def.has_value())
+        return false;
+
+    juce::Logger::writeToLog ("Loaded scale: " + def->name);
+    return registerScale (std::move (*def));
+}
+
+int ScaleRegistry::loadScalaDirectory (const juce::File& directory)
+{
+    if (! directory.isDirectory())
+        return 0;
+
+    int numLoaded = 0;
+
+    for (const auto& entry : juce::RangedDirectoryIterator (directory, false, "*.scl"))
+    {
+        if (loadScalaFile (entry.getFile()))
+            ++numLoaded;
+    }
+
+    return numLoaded;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <map>
+#include <optional>
+#include <vector>
+
+struct ScaleDefinition
+{
+    juce::String name;
+    std::vector<double> degrees; // Semitones above the root, starting at 0.0 and ending on the period
+    juce::String description;
+};
+
+class ScaleRegistry
+{
+public:
+    static ScaleRegistry& getInstance();
+
+    // Scala files may list at most this many pitches, so both halves of the scale
+    // still fit in the per-scale degree table
+    static constexpr int maxScalaPitches = 63;
+
+    // Registration (safe to call from static initializers)
+    bool registerScale (ScaleDefinition def);
+
+    // Queries
+    std::vector<juce::String> getScaleNames() const;
+    const ScaleDefinition* getDefinition (const juce::String& name) const;
+    bool hasScale (const juce::String& name) const;
+
+    // Scala (.scl) support - pitches given in cents or as ratios, named after the file
+    static std::optional<ScaleDefinition> parseScalaFile (const juce::File& file);
+    bool loadScalaFile (const juce::File& file);
+    int loadScalaDirectory (const juce::File& directory);
+
+private:
+    ScaleRegistry() = default;
+    std::map<juce::String, ScaleDefinition> definitions;
+};
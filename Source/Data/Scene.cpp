@@ -0,0 +1,67 @@
+/*
+  ==============================================================================
+
+    Scene.cpp
+    A section of a song: which sequences play, and for how many bars.
+
+  ==============================================================================
+*/
+
+#include "Scene.h"
+
+Scene::Scene (juce::ValueTree existingState) : state (std::move (existingState))
+{
+    jassert (! state.isValid() || state.hasType (SceneIDs::Scene));
+}
+
+juce::ValueTree Scene::createState (const juce::String& name, juce::uint32 trackMask, int lengthBars)
+{
+    juce::ValueTree s (SceneIDs::Scene);
+    s.setProperty (SceneIDs::Name, name, nullptr);
+
+    // Stored as a signed int so the property round-trips through the XML file
+    s.setProperty (SceneIDs::Tracks, static_cast<int> (trackMask), nullptr);
+    s.setProperty (SceneIDs::LengthBars, juce::jmax (1, lengthBars), nullptr);
+    return s;
+}
+
+juce::ValueTree& Scene::getState() { return state; }
+
+bool Scene::isValid() const { return state.isValid(); }
+
+juce::String Scene::getName() const { return state.getProperty (SceneIDs::Name); }
+
+void Scene::setName (const juce::String& name, juce::UndoManager* undoManager)
+{
+    state.setProperty (SceneIDs::Name, name, undoManager);
+}
+
+juce::uint32 Scene::getTrackMask() const
+{
+    return static_cast<juce::uint32> (static_cast<int> (state.getProperty (SceneIDs::Tracks, -1)));
+}
+
+void Scene::setTrackMask (juce::uint32 mask, juce::UndoManager* undoManager)
+{
+    state.setProperty (SceneIDs::Tracks, static_cast<int> (mask), undoManager);
+}
+
+bool Scene::containsTrack (size_t trackIndex) const
+{
+    return trackIndex < 32 && ((getTrackMask() >> trackIndex) & 1) != 0;
+}
+
+int Scene::getLengthBars() const
+{
+    return juce::jmax (1, static_cast<int> (state.getProperty (SceneIDs::LengthBars, defaultLengthBars)));
+}
+
+void Scene::setLengthBars (int bars, juce::UndoManager* undoManager)
+{
+    state.setProperty (SceneIDs::LengthBars, juce::jmax (1, bars), undoManager);
+}
+
+double Scene::getLengthBeats() const
+{
+    return getLengthBars() * beatsPerBar;
+}
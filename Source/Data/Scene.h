@@ -0,0 +1,55 @@
+/*
+  ==============================================================================
+
+    Scene.h
+    A section of a song: which sequences play, and for how many bars.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "juce_data_structures/juce_data_structures.h"
+
+namespace SceneIDs
+{
+#define DECLARE_ID(name) inline const juce::Identifier name { #name };
+DECLARE_ID (Scenes)
+DECLARE_ID (Scene)
+DECLARE_ID (Name)
+DECLARE_ID (Tracks)
+DECLARE_ID (LengthBars)
+#undef DECLARE_ID
+} // namespace SceneIDs
+
+// A lightweight handle on a scene's ValueTree; copies refer to the same scene
+class Scene
+{
+public:
+    // Scenes switch on bar lines; bars are 4/4
+    static constexpr double beatsPerBar = 4.0;
+    static constexpr int defaultLengthBars = 4;
+
+    explicit Scene (juce::ValueTree existingState);
+
+    // A new scene playing the sequences in trackMask (bit i = sequence i)
+    static juce::ValueTree createState (const juce::String& name, juce::uint32 trackMask, int lengthBars = defaultLengthBars);
+
+    juce::ValueTree& getState();
+    bool isValid() const;
+
+    juce::String getName() const;
+    void setName (const juce::String& name, juce::UndoManager* undoManager = nullptr);
+
+    juce::uint32 getTrackMask() const;
+    void setTrackMask (juce::uint32 mask, juce::UndoManager* undoManager = nullptr);
+    bool containsTrack (size_t trackIndex) const;
+
+    // How long the scene plays in song mode before the next one
+    int getLengthBars() const;
+    void setLengthBars (int bars, juce::UndoManager* undoManager = nullptr);
+    double getLengthBeats() const;
+
+private:
+    juce::ValueTree state;
+};
@@ -1,14 +1,31 @@
 #include "Selection.h"
 #include "Data/Scale.h"
 
-const std::vector<Position>& Selection::getPositions() const
+const std::vector<SelectionRange>& Selection::getRanges() const
 {
-    return positions;
+    return ranges;
+}
+
+bool Selection::isEmpty() const
+{
+    return ranges.empty();
+}
+
+bool Selection::contains (double time, double degree) const
+{
+    return std::any_of (ranges.begin(), ranges.end(), [time, degree] (const SelectionRange& r)
+                        { return r.contains (time, degree); });
+}
+
+bool Selection::containsCell (double time, double degree) const
+{
+    return std::any_of (ranges.begin(), ranges.end(), [time, degree] (const SelectionRange& r)
+                        { return r.containsCell (time, degree); });
 }
 
 void Selection::clear()
 {
-    positions.clear();
+    ranges.clear();
 }
 
 void Selection::toggleLineMode (Position pos, Timeline& timeline, Scale& scale)
@@ -28,148 +45,106 @@ void Selection::toggleLineMode (Position pos, Timeline& timeline, Scale& scale)
 void Selection::addToVisualLineSelection (Position pos, Timeline& timeline, Scale& scale)
 {
     // If this is the first position, it becomes both cursor and anchor
-    if (positions.empty())
+    if (ranges.empty())
     {
         anchor = pos;
     }
 
-    // Clear existing selection
-    positions.clear();
+    SelectionRange range;
+    range.stepSize = timeline.getStepSize();
 
     if (lineMode == VisualLineMode::horizontal)
     {
-        // Get the range of rows to fill (between anchor and cursor)
-        double minDegree = std::min (anchor.yDegree.value, pos.yDegree.value);
-        double maxDegree = std::max (anchor.yDegree.value, pos.yDegree.value);
-
-        // For each row in the range...
-        for (double d = minDegree; d <= maxDegree; d += scale.getSmallestStepSize())
-        {
-            // Fill the entire row
-            for (auto i = timeline.getLowerBound(); i < timeline.size() - 1; ++i)
-            {
-                auto time = i * timeline.getSmallestStepSize();
-                positions.emplace_back (Position { TimePoint { time }, Degree { d } });
-            }
-        }
+        // Every row between anchor and cursor, across the whole timeline
+        range.earliest = timeline.getLowerBound();
+        range.latest = timeline.getUpperBound() - range.stepSize;
+        range.lowest = std::min (anchor.yDegree.value, pos.yDegree.value);
+        range.highest = std::max (anchor.yDegree.value, pos.yDegree.value);
     }
     else if (lineMode == VisualLineMode::vertical)
     {
-        // Get the range of columns to fill (between anchor and cursor)
-        double minTime = std::min (anchor.xTimepoint.value, pos.xTimepoint.value);
-        double maxTime = std::max (anchor.xTimepoint.value, pos.xTimepoint.value);
-
-        // For each column in the range...
-        for (double time = minTime; time <= maxTime; time += timeline.getSmallestStepSize())
-        {
-            // Fill the entire column
-            for (auto i = scale.getLowerBound(); i < scale.size() - 1; ++i)
-            {
-                auto deg = i * scale.getSmallestStepSize();
-                positions.emplace_back (Position { TimePoint { time }, Degree { deg } });
-            }
-        }
+        // Every column between anchor and cursor, across the whole scale
+        range.earliest = std::min (anchor.xTimepoint.value, pos.xTimepoint.value);
+        range.latest = std::max (anchor.xTimepoint.value, pos.xTimepoint.value);
+        range.lowest = scale.getLowerBound();
+        range.highest = scale.getUpperBound();
     }
+
+    ranges.assign (1, range);
 }
 
-void Selection::addToVisualBlockSelection (Position pos, Timeline& timeline, Scale& scale, bool shouldWrap)
+void Selection::addToVisualBlockSelection (Position pos, Timeline& timeline)
 {
     // If this is the first position, it becomes both cursor and anchor
-    if (positions.empty())
+    if (ranges.empty())
     {
-        positions.push_back (pos);
         anchor = pos;
-        return;
     }
 
-    // Clear existing selection and fill in the rectangle between anchor and cursor
-    positions.clear();
-
-    // Calculate boundaries between anchor and cursor
-    double minTime = std::min (anchor.xTimepoint.value, pos.xTimepoint.value);
-    double maxTime = std::max (anchor.xTimepoint.value, pos.xTimepoint.value);
-    double minDegree = std::min (anchor.yDegree.value, pos.yDegree.value);
-    double maxDegree = std::max (anchor.yDegree.value, pos.yDegree.value);
+    // The rectangle between anchor and cursor
+    SelectionRange range;
+    range.stepSize = timeline.getStepSize();
+    range.earliest = std::min (anchor.xTimepoint.value, pos.xTimepoint.value);
+    range.latest = std::max (anchor.xTimepoint.value, pos.xTimepoint.value);
+    range.lowest = std::min (anchor.yDegree.value, pos.yDegree.value);
+    range.highest = std::max (anchor.yDegree.value, pos.yDegree.value);
 
-    // Fill in all positions in the rectangle
-    for (double t = minTime; t <= maxTime; t += timeline.getStepSize())
-    {
-        Degree currentDegree (minDegree);
-
-        while (currentDegree.value <= maxDegree)
-        {
-            positions.push_back (Position { TimePoint { t }, Degree { currentDegree } });
-            Degree nextDegree = scale.getHigher (currentDegree, shouldWrap);
-            if (juce::approximatelyEqual (nextDegree.value, currentDegree.value))
-                break;
-            currentDegree = nextDegree;
-        }
-    }
-}
-
-void Selection::addToSelection (Position p) { positions.emplace_back (p); }
-
-void Selection::removeFromSelection (Position p)
-{
-    // Find the position to remove using std::remove_if with a lambda
-    auto newEnd = std::remove_if (positions.begin(), positions.end(), [&p] (const Position& pos)
-                                  {
-            // Compare both time and degree for exact match
-            return Division::isEqual(pos.xTimepoint.value, p.xTimepoint.value) && Division::isEqual(pos.yDegree.value, p.yDegree.value); });
-
-    // Erase the removed elements
-    positions.erase (newEnd, positions.end());
+    ranges.assign (1, range);
 }
 
 Position Selection::getEarliestPosition() const
 {
-    if (positions.empty())
+    if (ranges.empty())
     {
-        return Position {}; // Return default Position if vector is empty
+        return Position {}; // Return default Position if there is no selection
     }
 
-    return *std::min_element (positions.begin(), positions.end(), [] (const Position& a, const Position& b)
-                              { return a.xTimepoint.value < b.xTimepoint.value; });
+    auto it = std::min_element (ranges.begin(), ranges.end(), [] (const SelectionRange& a, const SelectionRange& b)
+                                { return a.earliest.value < b.earliest.value; });
+    return Position { it->earliest, it->lowest };
 }
 
 Position Selection::getLatestPosition() const
 {
-    if (positions.empty())
+    if (ranges.empty())
     {
         return Position {};
     }
 
-    return *std::max_element (positions.begin(), positions.end(), [] (const Position& a, const Position& b)
-                              { return a.xTimepoint.value < b.xTimepoint.value; });
+    auto it = std::max_element (ranges.begin(), ranges.end(), [] (const SelectionRange& a, const SelectionRange& b)
+                                { return a.latest.value < b.latest.value; });
+    return Position { it->latest, it->lowest };
 }
 
 Position Selection::getHighestPosition() const
 {
-    if (positions.empty())
+    if (ranges.empty())
     {
         return Position {};
     }
 
-    return *std::max_element (positions.begin(), positions.end(), [] (const Position& a, const Position& b)
-                              { return a.yDegree.value < b.yDegree.value; });
+    auto it = std::max_element (ranges.begin(), ranges.end(), [] (const SelectionRange& a, const SelectionRange& b)
+                                { return a.highest.value < b.highest.value; });
+    return Position { it->earliest, it->highest };
 }
 
 Position Selection::getLowestPosition() const
 {
-    if (positions.empty())
+    if (ranges.empty())
     {
         return Position {};
     }
 
-    return *std::min_element (positions.begin(), positions.end(), [] (const Position& a, const Position& b)
-                              { return a.yDegree.value < b.yDegree.value; });
+    auto it = std::min_element (ranges.begin(), ranges.end(), [] (const SelectionRange& a, const SelectionRange& b)
+                                { return a.lowest.value < b.lowest.value; });
+    return Position { it->earliest, it->lowest };
 }
 
 Position Selection::getOppositeCorner (Position p)
 {
     anchor = p;
 
-    if (positions.empty())
+    if (ranges.empty())
     {
         return Position {};
     }
@@ -210,7 +185,7 @@ Position Selection::getOppositeEdge (Position p)
 {
     anchor = p;
 
-    if (positions.empty())
+    if (ranges.empty())
     {
         return Position {};
     }
@@ -260,25 +235,153 @@ void Selection::moveSelection (const Timeline& timeline, const Scale& scale, Dir
             return;
     }
 
-    for (auto& p : positions)
+    // Each range moves by one step as a whole. The only cells that can wrap are
+    // those on the leading edge, which come back as a one-step (or one-degree)
+    // piece on the opposite side
+    std::vector<SelectionRange> moved;
+    moved.reserve (ranges.size() * 2);
+
+    for (auto r : ranges)
     {
         switch (dir)
         {
             case Direction::left:
-                p.xTimepoint = timeline.getPrevStep (p.xTimepoint, shouldWrap);
+            {
+                TimePoint newEarliest = timeline.getPrevStep (r.earliest, shouldWrap);
+                if (newEarliest.value > r.earliest.value)
+                {
+                    SelectionRange wrapped = r;
+                    wrapped.earliest = newEarliest;
+                    wrapped.latest = newEarliest;
+                    moved.push_back (wrapped);
+
+                    if (Division::isEqual (r.earliest.value, r.latest.value))
+                        continue;
+
+                    r.latest = timeline.getPrevStep (r.latest, false);
+                }
+                else
+                {
+                    r.earliest = newEarliest;
+                    r.latest = timeline.getPrevStep (r.latest, shouldWrap);
+                }
                 break;
+            }
             case Direction::right:
-                p.xTimepoint = timeline.getNextStep (p.xTimepoint, shouldWrap);
+            {
+                TimePoint newLatest = timeline.getNextStep (r.latest, shouldWrap);
+                if (newLatest.value < r.latest.value)
+                {
+                    SelectionRange wrapped = r;
+                    wrapped.earliest = newLatest;
+                    wrapped.latest = newLatest;
+                    moved.push_back (wrapped);
+
+                    if (Division::isEqual (r.earliest.value, r.latest.value))
+                        continue;
+
+                    r.earliest = timeline.getNextStep (r.earliest, false);
+                }
+                else
+                {
+                    r.earliest = timeline.getNextStep (r.earliest, shouldWrap);
+                    r.latest = newLatest;
+                }
                 break;
+            }
             case Direction::up:
-                p.yDegree = scale.getHigher (p.yDegree.value, shouldWrap);
+            {
+                Degree newHighest = scale.getHigher (r.highest, shouldWrap);
+                if (newHighest.value < r.highest.value)
+                {
+                    SelectionRange wrapped = r;
+                    wrapped.lowest = newHighest;
+                    wrapped.highest = newHighest;
+                    moved.push_back (wrapped);
+
+                    if (Division::isEqual (r.lowest.value, r.highest.value))
+                        continue;
+
+                    r.lowest = scale.getHigher (r.lowest, false);
+                }
+                else
+                {
+                    r.lowest = scale.getHigher (r.lowest, shouldWrap);
+                    r.highest = newHighest;
+                }
                 break;
+            }
             case Direction::down:
-                p.yDegree = scale.getLower (p.yDegree.value, shouldWrap);
+            {
+                Degree newLowest = scale.getLower (r.lowest, shouldWrap);
+                if (newLowest.value > r.lowest.value)
+                {
+                    SelectionRange wrapped = r;
+                    wrapped.lowest = newLowest;
+                    wrapped.highest = newLowest;
+                    moved.push_back (wrapped);
+
+                    if (Division::isEqual (r.lowest.value, r.highest.value))
+                        continue;
+
+                    r.highest = scale.getLower (r.highest, false);
+                }
+                else
+                {
+                    r.lowest = newLowest;
+                    r.highest = scale.getLower (r.highest, shouldWrap);
+                }
                 break;
+            }
             default:
                 break;
         }
+
+        moved.push_back (r);
+    }
+
+    ranges = std::move (moved);
+    mergeAdjacentRanges (scale);
+}
+
+void Selection::mergeAdjacentRanges (const Scale& scale)
+{
+    // Pieces split by an earlier wrap rejoin once they line up again, which
+    // keeps a wrapped selection to at most two pieces per axis
+    bool merged = true;
+
+    while (merged)
+    {
+        merged = false;
+
+        for (size_t i = 0; i < ranges.size() && ! merged; ++i)
+        {
+            for (size_t j = 0; j < ranges.size() && ! merged; ++j)
+            {
+                if (i == j)
+                    continue;
+
+                auto& a = ranges[i];
+                const auto& b = ranges[j];
+
+                bool sameRows = Division::isEqual (a.lowest.value, b.lowest.value) && Division::isEqual (a.highest.value, b.highest.value);
+                bool sameColumns = Division::isEqual (a.earliest.value, b.earliest.value) && Division::isEqual (a.latest.value, b.latest.value);
+
+                if (sameRows && Division::isEqual (a.getEndTime(), b.earliest.value))
+                {
+                    a.latest = b.latest;
+                    merged = true;
+                }
+                else if (sameColumns && Division::isEqual (scale.getHigher (a.highest, false).value, b.lowest.value))
+                {
+                    a.highest = b.highest;
+                    merged = true;
+                }
+
+                if (merged)
+                    ranges.erase (ranges.begin() + static_cast<std::ptrdiff_t> (j));
+            }
+        }
     }
 }
 
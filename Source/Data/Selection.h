@@ -17,6 +17,39 @@ struct Position
     Degree yDegree = Degree { 0.0 };
 };
 
+// A rectangle of grid cells: step starts from earliest to latest (inclusive,
+// stepSize apart) across every degree from lowest to highest (inclusive).
+// Membership is an interval test, so its cost does not depend on the size
+struct SelectionRange
+{
+    TimePoint earliest = TimePoint { 0.0 };
+    TimePoint latest = TimePoint { 0.0 };
+    Degree lowest = Degree { 0.0 };
+    Degree highest = Degree { 0.0 };
+    double stepSize = 0.0;
+
+    // Exclusive end of the last selected step
+    double getEndTime() const { return latest.value + stepSize; }
+
+    bool contains (double time, double degree) const
+    {
+        return Division::isLessOrEqual (earliest.value, time) && time < getEndTime() - Division::epsilon
+               && Division::isLessOrEqual (lowest.value, degree) && Division::isLessOrEqual (degree, highest.value);
+    }
+
+    // Only notes that start exactly on one of the selected steps
+    bool containsCell (double time, double degree) const
+    {
+        if (! contains (time, degree))
+            return false;
+
+        if (stepSize <= 0.0)
+            return Division::isEqual (time, earliest.value);
+
+        return Division::isEqual (time, earliest.value + std::round ((time - earliest.value) / stepSize) * stepSize);
+    }
+};
+
 class Selection
 {
 public:
@@ -38,11 +71,15 @@ public:
     void clear();
 
     void addToVisualLineSelection (Position p, Timeline& t, Scale& s);
-    void addToVisualBlockSelection (Position p, Timeline& t, Scale& s, bool shouldWrap);
-    void addToSelection (Position p);
-    void removeFromSelection (Position p);
+    void addToVisualBlockSelection (Position p, Timeline& t);
+
+    // Usually a single range; a selection moved across the timeline or scale
+    // boundary with wrapping is split into at most two pieces per axis
+    const std::vector<SelectionRange>& getRanges() const;
+    bool isEmpty() const;
+    bool contains (double time, double degree) const;
+    bool containsCell (double time, double degree) const;
 
-    const std::vector<Position>& getPositions() const;
     Position getEarliestPosition() const;
     Position getLatestPosition() const;
     Position getHighestPosition() const;
@@ -56,7 +93,9 @@ public:
     void toggleLineMode (Position pos, Timeline& timeline, Scale& scale);
 
 private:
-    std::vector<Position> positions;
+    void mergeAdjacentRanges (const Scale& scale);
+
+    std::vector<SelectionRange> ranges;
     Position anchor;
     VisualLineMode lineMode = VisualLineMode::vertical;
 };
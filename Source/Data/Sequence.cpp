@@ -12,6 +12,7 @@
 #include "Data/Note.h"
 #include "Data/Scale.h"
 #include "Data/Timeline.h"
+#include "Data/UndoHistory.h"
 #include "juce_core/juce_core.h"
 #include "juce_data_structures/juce_data_structures.h"
 
@@ -19,7 +20,8 @@ Sequence::Sequence() : Sequence (juce::ValueTree()) {}
 
 Sequence::Sequence (juce::ValueTree existingState) : state (existingState.isValid() ? std::move (existingState) : juce::ValueTree (SequenceIDs::Sequence)),
                                                      timeline (state.getChildWithName (TimelineIDs::Timeline)),
-                                                     scale (state.getChildWithName (ScaleIDs::Scale))
+                                                     scale (state.getChildWithName (ScaleIDs::Scale)),
+                                                     groove (state.getChildWithName (GrooveIDs::Groove))
 {
     // ensure properties exist
     if (! state.hasProperty (SequenceIDs::MidiChannel))
@@ -37,6 +39,9 @@ Sequence::Sequence (juce::ValueTree existingState) : state (existingState.isVali
     if (! state.hasProperty (SequenceIDs::RootNote))
         state.setProperty (SequenceIDs::RootNote, 64, nullptr);
 
+    if (! state.hasProperty (SequenceIDs::TuningOutput))
+        state.setProperty (SequenceIDs::TuningOutput, "nearest", nullptr);
+
     // ensure child trees exist
     if (! state.getChildWithName (TimelineIDs::Timeline).isValid())
         state.addChild (timeline.getState(), -1, nullptr);
@@ -44,10 +49,20 @@ Sequence::Sequence (juce::ValueTree existingState) : state (existingState.isVali
     if (! state.getChildWithName (ScaleIDs::Scale).isValid())
         state.addChild (scale.getState(), -1, nullptr);
 
+    if (! state.getChildWithName (GrooveIDs::Groove).isValid())
+        state.addChild (groove.getState(), -1, nullptr);
+
     if (! state.getChildWithName (SequenceIDs::Notes).isValid())
         state.addChild (juce::ValueTree (SequenceIDs::Notes), -1, nullptr);
 
+    if (! getAutomationState().isValid())
+        state.addChild (juce::ValueTree (AutomationIDs::Automation), -1, nullptr);
+
+    if (! getGeneratorContainer().isValid())
+        state.addChild (juce::ValueTree (SequenceIDs::Generator), -1, nullptr);
+
     loadNotesFromState();
+    groove.compile (getLengthBeats());
 
     state.addListener (this);
 }
@@ -90,24 +105,18 @@ void Sequence::insertNote (juce::ValueTree v, juce::UndoManager* undoManager)
         return;
     }
 
-    undoManager->beginNewTransaction ("insertNote");
+    UndoHistory::beginTransaction (undoManager, "insertNote");
     getNotesState().addChild (v, -1, undoManager);
 }
 
 bool Sequence::isExistingNote (juce::ValueTree newNote)
 {
-    auto notesState = getNotesState();
+    double newDegree = static_cast<double> (newNote.getProperty (NoteIDs::Degree));
+    double newStartTime = static_cast<double> (newNote.getProperty (NoteIDs::StartTime));
 
-    for (int i = 0; i < notesState.getNumChildren(); ++i)
+    for (const auto& existingNote : notes)
     {
-        auto existingNote = notesState.getChild (i);
-        double existingDegree = static_cast<double> (existingNote.getProperty (NoteIDs::Degree));
-        double existingStartTime = static_cast<double> (existingNote.getProperty (NoteIDs::StartTime));
-
-        double newDegree = static_cast<double> (newNote.getProperty (NoteIDs::Degree));
-        double newStartTime = static_cast<double> (newNote.getProperty (NoteIDs::StartTime));
-
-        if (juce::approximatelyEqual (existingDegree, newDegree) && juce::approximatelyEqual (existingStartTime, newStartTime))
+        if (juce::approximatelyEqual (existingNote->getDegree(), newDegree) && juce::approximatelyEqual (existingNote->getStartTime(), newStartTime))
         {
             return true;
         }
@@ -195,12 +204,22 @@ juce::Value Sequence::getRootNoteAsValue()
     return state.getPropertyAsValue (SequenceIDs::RootNote, nullptr);
 }
 
+juce::String Sequence::getTuningOutput() const
+{
+    return state.getProperty (SequenceIDs::TuningOutput, "nearest");
+}
+
+juce::Value Sequence::getTuningOutputAsValue()
+{
+    return state.getPropertyAsValue (SequenceIDs::TuningOutput, nullptr);
+}
+
 // Create a reusable predicate to filter notes
 auto Sequence::isNoteWithin (double minTime, double maxTime, double minDegree, double maxDegree)
 {
     return [=] (const auto& note)
     {
-        return Note::isWithinRange (note->getState(), minTime, maxTime, minDegree, maxDegree);
+        return note->isWithinRange (minTime, maxTime, minDegree, maxDegree);
     };
 }
 
@@ -231,20 +250,25 @@ void Sequence::removeNotes (
     double maxDegree,
     juce::UndoManager* undoManager)
 {
-    undoManager->beginNewTransaction ("removeNotes");
+    auto batch = createEditBatch ("removeNotes");
 
-    auto notesState = getNotesState();
-
-    for (int i = notesState.getNumChildren() - 1; i >= 0; --i)
+    for (const auto& note : notes)
     {
-        juce::ValueTree noteChild = notesState.getChild (i);
-        auto isWithinRange = Note::isWithinRange (noteChild, minTime, maxTime, minDegree, maxDegree);
-
-        if (isWithinRange)
-        {
-            notesState.removeChild (noteChild, undoManager);
-        }
+        if (note->isWithinRange (minTime, maxTime, minDegree, maxDegree))
+            batch.removeNote (note->getState());
     }
+
+    if (batch.isEmpty())
+        return;
+
+    UndoHistory::beginTransaction (undoManager, batch.getName());
+
+    batch.commit (undoManager);
+}
+
+NoteEditBatch Sequence::createEditBatch (const juce::String& name)
+{
+    return NoteEditBatch (getNotesState(), name);
 }
 
 void Sequence::valueTreeChildAdded (ValueTree& parentTree,
@@ -255,6 +279,8 @@ void Sequence::valueTreeChildAdded (ValueTree& parentTree,
         auto note = std::make_unique<Note> (childWhichHasBeenAdded);
         notes.emplace_back (std::move (note));
     }
+
+    bumpRevision (parentTree);
 }
 
 void Sequence::valueTreeChildRemoved (ValueTree& parentTree,
@@ -266,8 +292,115 @@ void Sequence::valueTreeChildRemoved (ValueTree& parentTree,
         std::erase_if (notes, [&] (const auto& note)
                        { return note->getState() == childWhichHasBeenRemoved; });
     }
+
+    bumpRevision (parentTree);
+}
+
+void Sequence::valueTreePropertyChanged (ValueTree& tree, const juce::Identifier& property)
+{
+    // Mute and solo are applied at playback and don't change the scheduled notes
+    if (tree == state && (property == SequenceIDs::Muted || property == SequenceIDs::Soloed))
+        return;
+
+    if (tree == groove.getState() || tree == timeline.getState())
+        groove.compile (getLengthBeats());
+
+    bumpRevision (tree);
+}
+
+void Sequence::bumpRevision (const ValueTree& changedTree)
+{
+    auto notesState = getNotesState();
+    auto automationState = getAutomationState();
+    auto generatorContainer = getGeneratorContainer();
+
+    if (changedTree == notesState || changedTree.isAChildOf (notesState))
+        ++notesRevision;
+    else if (changedTree == automationState || changedTree.isAChildOf (automationState))
+        ++automationRevision;
+    else if (changedTree == generatorContainer || changedTree.isAChildOf (generatorContainer))
+        ++generatorRevision;
+    else
+        ++settingsRevision;
+}
+
+juce::uint32 Sequence::getNotesRevision() const { return notesRevision; }
+
+juce::uint32 Sequence::getSettingsRevision() const { return settingsRevision; }
+
+juce::uint32 Sequence::getAutomationRevision() const { return automationRevision; }
+
+juce::uint32 Sequence::getGeneratorRevision() const { return generatorRevision; }
+
+juce::ValueTree Sequence::getAutomationState() const
+{
+    return state.getChildWithName (AutomationIDs::Automation);
+}
+
+int Sequence::getNumAutomationLanes() const
+{
+    return getAutomationState().getNumChildren();
+}
+
+AutomationLane Sequence::getAutomationLane (int index) const
+{
+    return AutomationLane (getAutomationState().getChild (index));
+}
+
+AutomationLane Sequence::addAutomationLane (Automation::Target target, int controller, juce::UndoManager* undoManager)
+{
+    auto automationState = getAutomationState();
+
+    if (automationState.getNumChildren() >= AutomationLane::maxLanesPerSequence)
+        return AutomationLane (juce::ValueTree());
+
+    auto laneState = AutomationLane::createState (target, controller);
+    automationState.addChild (laneState, -1, undoManager);
+    return AutomationLane (laneState);
+}
+
+void Sequence::removeAutomationLane (int index, juce::UndoManager* undoManager)
+{
+    getAutomationState().removeChild (index, undoManager);
 }
 
+juce::ValueTree Sequence::getGeneratorContainer() const
+{
+    return state.getChildWithName (SequenceIDs::Generator);
+}
+
+bool Sequence::isGenerative() const
+{
+    return getGeneratorState().isValid();
+}
+
+juce::ValueTree Sequence::getGeneratorState() const
+{
+    return getGeneratorContainer().getChild (0);
+}
+
+void Sequence::setGenerator (const juce::ValueTree& generatorState, juce::UndoManager* undoManager)
+{
+    auto container = getGeneratorContainer();
+
+    UndoHistory::beginTransaction (undoManager, "setGenerator");
+    container.removeAllChildren (undoManager);
+    container.addChild (generatorState.createCopy(), -1, undoManager);
+}
+
+void Sequence::clearGenerator (juce::UndoManager* undoManager)
+{
+    auto container = getGeneratorContainer();
+
+    if (container.getNumChildren() == 0)
+        return;
+
+    UndoHistory::beginTransaction (undoManager, "clearGenerator");
+    container.removeAllChildren (undoManager);
+}
+
+juce::uint32 Sequence::getGeneratorSourceId() const { return generatorSourceId; }
+
 const Timeline& Sequence::getTimeline() const { return timeline; }
 
 Timeline& Sequence::getTimeline() { return timeline; }
@@ -276,6 +409,10 @@ const Scale& Sequence::getScale() const { return scale; }
 
 Scale& Sequence::getScale() { return scale; }
 
+const Groove& Sequence::getGroove() const { return groove; }
+
+Groove& Sequence::getGroove() { return groove; }
+
 void Sequence::increaseTimelineStepSize()
 {
     timeline.increaseStepSize();
@@ -302,18 +439,19 @@ juce::Value Sequence::getScaleAsValue()
 
 void Sequence::snapNotesToScale (juce::UndoManager* undoManager)
 {
-    if (undoManager)
-        undoManager->beginNewTransaction ("snapNotesToScale");
+    auto batch = createEditBatch ("snapNotesToScale");
 
     for (auto& note : notes)
-    {
-        auto snappedDegree = scale.getNearestDegree (note->getDegree());
-        note->setDegree (snappedDegree, undoManager);
-    }
+        batch.setProperty (note->getState(), NoteIDs::Degree, scale.getNearestDegree (note->getDegree()));
+
+    batch.commit (undoManager);
 }
 
 void Sequence::setScale (juce::String scaleName, juce::UndoManager* undoManager)
 {
+    // The scale change and the snapped notes undo as one step
+    UndoHistory::beginTransaction (undoManager, "setScale");
+
     scale.setScale (scaleName, undoManager);
     snapNotesToScale (undoManager);
 }
@@ -9,7 +9,10 @@
 */
 
 #pragma once
+#include "Data/AutomationLane.h"
+#include "Data/Groove.h"
 #include "Data/Note.h"
+#include "Data/NoteEditBatch.h"
 #include "juce_data_structures/juce_data_structures.h"
 
 namespace SequenceIDs
@@ -23,6 +26,8 @@ DECLARE_ID (MidiOutputId)
 DECLARE_ID (Muted)
 DECLARE_ID (Soloed)
 DECLARE_ID (RootNote)
+DECLARE_ID (TuningOutput)
+DECLARE_ID (Generator)
 #undef DECLARE_ID
 } // namespace SequenceIDs
 
@@ -42,6 +47,10 @@ public:
 
     bool enabled = true;
 
+    // Result of the last trig condition, for Pre. Only touched while this
+    // sequence's notes are extracted
+    bool lastConditionPassed = true;
+
     void setMidiChannel (int channel, juce::UndoManager* undoManager = nullptr);
     int getMidiChannel() const;
     void setMidiOutputId (const juce::String& outputId, juce::UndoManager* undoManager = nullptr);
@@ -65,6 +74,10 @@ public:
     void setRootNote (int midiNote, juce::UndoManager* undoManager = nullptr);
     juce::Value getRootNoteAsValue();
 
+    // How microtonal degrees reach the synth: "nearest", "mpe" or "mts"
+    juce::String getTuningOutput() const;
+    juce::Value getTuningOutputAsValue();
+
     std::vector<std::unique_ptr<Note>> notes;
 
     void valueTreeChildAdded (ValueTree& parentTree,
@@ -74,16 +87,54 @@ public:
                                 ValueTree& childWhichHasBeenRemoved,
                                 int indexFromWhichChildWasRemoved);
 
+    void valueTreePropertyChanged (ValueTree& tree, const juce::Identifier& property) override;
+
+    // Bumped whenever a note is added, removed or changed
+    juce::uint32 getNotesRevision() const;
+
+    // Bumped whenever a sequence property changes (scale, root note, ...)
+    juce::uint32 getSettingsRevision() const;
+
+    // Bumped whenever an automation lane is added, removed or changed
+    juce::uint32 getAutomationRevision() const;
+
+    // Bumped whenever the generator is set, cleared or has a parameter changed
+    juce::uint32 getGeneratorRevision() const;
+
     std::vector<std::reference_wrapper<std::unique_ptr<Note>>> findNotes (double minTime, double maxTime, double minDegree, double maxDegree);
     void removeNotes (double minTime, double maxTime, double minDegree, double maxDegree, juce::UndoManager* undoManager);
     void insertNote (juce::ValueTree v, juce::UndoManager* undoManager = nullptr);
     bool isExistingNote (juce::ValueTree noteState);
 
+    // Starts a bulk edit of this sequence's notes; see NoteEditBatch
+    NoteEditBatch createEditBatch (const juce::String& name);
+
     const Timeline& getTimeline() const;
     const Scale& getScale() const;
     Timeline& getTimeline();
     Scale& getScale();
 
+    // Swing, groove template and humanise; recompiled whenever they or the length change
+    const Groove& getGroove() const;
+    Groove& getGroove();
+
+    // CC, pitch bend and aftertouch lanes, at most AutomationLane::maxLanesPerSequence
+    int getNumAutomationLanes() const;
+    AutomationLane getAutomationLane (int index) const;
+    AutomationLane addAutomationLane (Automation::Target target, int controller = 1, juce::UndoManager* undoManager = nullptr);
+    void removeAutomationLane (int index, juce::UndoManager* undoManager = nullptr);
+
+    // A generative sequence plays a generator's pattern, evaluated only for the
+    // window being scheduled, on top of any stored notes. The pattern counts
+    // steps from the start of playback and never has to repeat
+    bool isGenerative() const;
+    juce::ValueTree getGeneratorState() const;
+    void setGenerator (const juce::ValueTree& generatorState, juce::UndoManager* undoManager = nullptr);
+    void clearGenerator (juce::UndoManager* undoManager = nullptr);
+
+    // The MidiNote::sourceId every generated note carries
+    juce::uint32 getGeneratorSourceId() const;
+
     void increaseTimelineStepSize();
     void decreaseTimelineStepSize();
 
@@ -99,9 +150,20 @@ private:
 
     juce::ValueTree state;
     juce::ValueTree getNotesState();
+    juce::ValueTree getAutomationState() const;
+    juce::ValueTree getGeneratorContainer() const;
+
+    const juce::uint32 generatorSourceId = Note::createSourceId();
+
+    juce::uint32 notesRevision = 0;
+    juce::uint32 settingsRevision = 0;
+    juce::uint32 automationRevision = 0;
+    juce::uint32 generatorRevision = 0;
+    void bumpRevision (const ValueTree& changedTree);
 
     void snapNotesToScale (juce::UndoManager* undoManager = nullptr);
 
     Timeline timeline;
     Scale scale { "Natural Minor" };
+    Groove groove;
 };
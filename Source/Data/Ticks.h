@@ -0,0 +1,88 @@
+/*
+  ==============================================================================
+
+    Ticks.h
+    Exact musical time as whole ticks, for loop and window arithmetic that
+    must not drift.
+
+  ==============================================================================
+*/
+
+#pragma once
+
+#include "juce_core/juce_core.h"
+#include <cmath>
+#include <numeric>
+
+namespace Ticks
+{
+using Count = juce::int64;
+
+// 2^6 * 3^2 * 5 * 7 * 11: every power of two down to a 64th of a beat, and
+// tuplets of 3, 5, 7, 9 and 11 of any of those, land on a whole tick. Sextuplets
+// hold down to a 32nd and 12-tuplets down to a 16th; a 64th (3465 ticks) has no
+// factor of two left to split
+inline constexpr Count perBeat = 221760;
+
+// Beats are rounded to the nearest tick, so a step written as a double
+// (1/3 of a beat, 7/12 of a beat) comes back exact
+inline Count fromBeats (double beats)
+{
+    return static_cast<Count> (std::llround (beats * static_cast<double> (perBeat)));
+}
+
+inline double toBeats (Count ticks)
+{
+    return static_cast<double> (ticks) / static_cast<double> (perBeat);
+}
+
+// Rounds towards negative infinity, unlike integer division
+inline Count floorDiv (Count a, Count b)
+{
+    jassert (b > 0);
+    auto q = a / b;
+    return (a % b != 0 && a < 0) ? q - 1 : q;
+}
+
+// a mod b in [0, b)
+inline Count wrap (Count a, Count b)
+{
+    return a - floorDiv (a, b) * b;
+}
+} // namespace Ticks
+
+// A ratio of whole numbers, kept in lowest terms. Used for tuplet steps,
+// whose lengths aren't exact as doubles
+struct Rational
+{
+    Ticks::Count num = 0;
+    Ticks::Count den = 1;
+
+    constexpr Rational() = default;
+
+    constexpr Rational (Ticks::Count n, Ticks::Count d = 1) : num (n), den (d)
+    {
+        if (den < 0)
+        {
+            num = -num;
+            den = -den;
+        }
+
+        auto g = std::gcd (num, den);
+        if (g > 1)
+        {
+            num /= g;
+            den /= g;
+        }
+    }
+
+    constexpr Rational operator* (const Rational& other) const { return { num * other.num, den * other.den }; }
+    constexpr Rational operator+ (const Rational& other) const { return { num * other.den + other.num * den, den * other.den }; }
+
+    constexpr bool operator== (const Rational& other) const { return num == other.num && den == other.den; }
+
+    double toDouble() const { return static_cast<double> (num) / static_cast<double> (den); }
+
+    // Exact when den divides Ticks::perBeat * num, as for every Division and tuplet
+    constexpr Ticks::Count toTicks() const { return num * Ticks::perBeat / den; }
+};
@@ -1,6 +1,7 @@
 #include "Timeline.h"
 #include "juce_core/juce_core.h"
 #include "juce_data_structures/juce_data_structures.h"
+#include <algorithm>
 #include <utility>
 
 TimePoint::TimePoint (double init)
@@ -19,6 +20,9 @@ Timeline::Timeline (juce::ValueTree existingState) : state (existingState.isVali
     if (! state.hasProperty (TimelineIDs::StepSize))
         setStepSize (Division::quarter, nullptr);
 
+    if (! state.hasProperty (TimelineIDs::Tuplet))
+        setTuplet (1, nullptr);
+
     if (! state.hasProperty (TimelineIDs::LowerBound))
         setLowerBound (0.0);
 
@@ -60,14 +64,39 @@ void Timeline::setUpperBound (double upperBound, juce::UndoManager* undoManager)
     state.setProperty (TimelineIDs::UpperBound, upperBound, undoManager);
 }
 
-double Timeline::getStepSize() const { return state.getProperty (TimelineIDs::StepSize); }
+double Timeline::getStepSize() const
+{
+    return getTupletStep (getBaseStepSize());
+}
+
+double Timeline::getTupletStep (double baseStepSize) const
+{
+    auto ratio = Division::getTupletRatio (getTuplet());
+    auto baseTicks = Ticks::fromBeats (baseStepSize);
+    return Ticks::toBeats (baseTicks * ratio.num / ratio.den);
+}
+
+double Timeline::getBaseStepSize() const { return state.getProperty (TimelineIDs::StepSize); }
 
 void Timeline::setStepSize (double stepSize, juce::UndoManager* undoManager)
 {
     state.setProperty (TimelineIDs::StepSize, stepSize, undoManager);
 }
 
-double Timeline::getSmallestStepSize() const { return Division::thirtysecond; }
+int Timeline::getTuplet() const
+{
+    int notes = state.getProperty (TimelineIDs::Tuplet, 1);
+    return std::find (Division::tuplets.begin(), Division::tuplets.end(), notes) != Division::tuplets.end() ? notes : 1;
+}
+
+void Timeline::setTuplet (int notes, juce::UndoManager* undoManager)
+{
+    state.setProperty (TimelineIDs::Tuplet, notes, undoManager);
+}
+
+juce::Value Timeline::getTupletAsValue() { return state.getPropertyAsValue (TimelineIDs::Tuplet, nullptr); }
+
+double Timeline::getSmallestStepSize() const { return getTupletStep (Division::values.front()); }
 
 TimePoint Timeline::getNextStep (const TimePoint& tp, bool shouldWrap) const
 {
@@ -110,7 +139,7 @@ TimePoint Timeline::getPrevStep (const TimePoint& tp, double division, bool shou
 }
 
 // Converts bar position to seconds based on tempo
-double Timeline::convertBarPositionToSeconds (double barPosition, double tempo)
+double Timeline::convertBarPositionToSeconds (double barPosition, double tempo) const
 {
     const double MIN_IN_SECONDS = 60.0;
     double secondsPerBeat = MIN_IN_SECONDS / tempo;
@@ -118,7 +147,7 @@ double Timeline::convertBarPositionToSeconds (double barPosition, double tempo)
     return secondsPerBeat * barPosition;
 }
 
-double Timeline::convertDivisionToSeconds (double division, double tempo)
+double Timeline::convertDivisionToSeconds (double division, double tempo) const
 {
     const double MIN_IN_SECONDS = 60.0;
     double secondsPerBeat = MIN_IN_SECONDS / tempo;
@@ -129,12 +158,12 @@ double Timeline::convertDivisionToSeconds (double division, double tempo)
 
 void Timeline::increaseStepSize()
 {
-    setStepSize (Division::getNextLarger (getStepSize()));
+    setStepSize (Division::getNextLarger (getBaseStepSize()));
 }
 
 void Timeline::decreaseStepSize()
 {
-    setStepSize (Division::getNextSmaller (getStepSize()));
+    setStepSize (Division::getNextSmaller (getBaseStepSize()));
 }
 
 const double Timeline::size() const
@@ -1,4 +1,5 @@
 #pragma once
+#include "Data/Ticks.h"
 #include "juce_data_structures/juce_data_structures.h"
 #include <JuceHeader.h>
 
@@ -8,6 +9,7 @@ namespace TimelineIDs
 DECLARE_ID (Timeline)
 DECLARE_ID (Value)
 DECLARE_ID (StepSize)
+DECLARE_ID (Tuplet)
 DECLARE_ID (UpperBound)
 DECLARE_ID (LowerBound)
 #undef DECLARE_ID
@@ -43,6 +45,19 @@ public:
         whole
     };
 
+    // Notes per tuplet: n steps in the time of the power of two below n
+    // (3 in 2, 5 in 4, 7 in 4, 9 in 8, 11 in 8). 1 is straight
+    static constexpr std::array<int, 6> tuplets = { 1, 3, 5, 7, 9, 11 };
+
+    static constexpr Rational getTupletRatio (int notes)
+    {
+        int inTimeOf = 1;
+        while (inTimeOf * 2 < notes)
+            inTimeOf *= 2;
+
+        return notes > 1 ? Rational (inTimeOf, notes) : Rational (1);
+    }
+
     static constexpr double epsilon = 0.0001; // Small value for comparison
 
     static bool isEqual (double a, double b)
@@ -106,20 +121,34 @@ public:
     TimePoint getPrevStep (const TimePoint& tp, bool shouldWrap) const;
     TimePoint getPrevStep (const TimePoint& tp, double division, bool shouldWrap) const;
 
+    // The step the cursor moves by: the base division, shortened by the tuplet.
+    // Exact to the tick, so tuplet steps add up to whole beats
     double getStepSize() const;
+
+    // The power-of-two division the step is based on
+    double getBaseStepSize() const;
     void setStepSize (double stepSize, juce::UndoManager* undoManager = nullptr);
 
+    // One of Division::tuplets
+    int getTuplet() const;
+    void setTuplet (int notes, juce::UndoManager* undoManager = nullptr);
+    juce::Value getTupletAsValue();
+
+    // The smallest division the cursor can step by, shortened by the tuplet
+    // like the step: an 11-tuplet 32nd is under a 32nd
     double getSmallestStepSize() const;
 
     void increaseStepSize();
     void decreaseStepSize();
 
-    double convertBarPositionToSeconds (double barPosition, double tempo);
-    double convertDivisionToSeconds (double division, double tempo);
+    double convertBarPositionToSeconds (double barPosition, double tempo) const;
+    double convertDivisionToSeconds (double division, double tempo) const;
 
     const double size() const;
     const double sizeAtCurrentStepSize() const;
 
 private:
+    double getTupletStep (double baseStepSize) const;
+
     juce::ValueTree state;
 };
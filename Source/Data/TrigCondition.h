@@ -0,0 +1,85 @@
+#pragma once
+
+#include <JuceHeader.h>
+#include <array>
+
+// Deterministic conditions deciding whether a note plays on a given pass of
+// its sequence's loop, evaluated when the note is scheduled
+namespace TrigCondition
+{
+enum class Type
+{
+    always,
+    fill,        // Only while fill is on
+    notFill,     // Only while fill is off
+    ratio,       // The A-th pass of every B
+    first,       // Only the first pass since playback started
+    notFirst,    // Every pass but the first
+    previous,    // Only if the track's last conditional note played
+    notPrevious, // Only if it didn't
+};
+
+inline const std::array<juce::String, 8> names = {
+    "Always",
+    "Fill",
+    "Not Fill",
+    "A:B",
+    "First",
+    "Not First",
+    "Pre",
+    "Not Pre"
+};
+
+// Shared by every note scheduled in a pass
+struct Context
+{
+    double originBeat = 0.0; // Transport beat playback started from; passes count from here
+    bool fill = false;
+};
+
+inline Type fromIndex (int index)
+{
+    return static_cast<Type> (juce::jlimit (0, static_cast<int> (names.size()) - 1, index));
+}
+
+// Pre and Not Pre read the track's last result without replacing it
+inline bool updatesPrevious (Type type)
+{
+    return type != Type::always && type != Type::previous && type != Type::notPrevious;
+}
+
+/**
+ * Whether a note plays on this pass.
+ *
+ * @param iteration Passes of the loop since playback started (0 = the first)
+ * @param previous The result of the track's last condition that updates it
+ */
+inline bool evaluate (Type type, int a, int b, juce::int64 iteration, bool fill, bool previous)
+{
+    switch (type)
+    {
+        case Type::always:
+            return true;
+        case Type::fill:
+            return fill;
+        case Type::notFill:
+            return ! fill;
+        case Type::ratio:
+        {
+            b = juce::jmax (1, b);
+            a = juce::jlimit (1, b, a);
+            return iteration % b == a - 1;
+        }
+        case Type::first:
+            return iteration == 0;
+        case Type::notFirst:
+            return iteration != 0;
+        case Type::previous:
+            return previous;
+        case Type::notPrevious:
+            return ! previous;
+    }
+
+    return true;
+}
+} // namespace TrigCondition
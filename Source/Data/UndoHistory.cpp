@@ -0,0 +1,108 @@
+#include "Data/UndoHistory.h"
+
+UndoHistory::UndoHistory()
+    : juce::UndoManager (defaultMaxKilobytes * 1024, minTransactionsToKeep)
+{
+    addChangeListener (this);
+}
+
+UndoHistory::~UndoHistory()
+{
+    removeChangeListener (this);
+}
+
+void UndoHistory::setLimits (int newMaxTransactions, int maxKilobytes)
+{
+    maxTransactions = juce::jmax (1, newMaxTransactions);
+    maxBytes = juce::jmax (1, maxKilobytes) * 1024;
+    applyLimits();
+}
+
+int UndoHistory::getMaxTransactions() const { return maxTransactions; }
+
+int UndoHistory::getMaxKilobytes() const { return maxBytes / 1024; }
+
+int UndoHistory::getNumUndoableTransactions() const
+{
+    return getUndoDescriptions().size();
+}
+
+int UndoHistory::getEstimatedBytes() const
+{
+    return getNumberOfUnitsTakenUpByStoredCommands();
+}
+
+void UndoHistory::beginCoalescedTransaction (const juce::String& name)
+{
+    if (isInTransactionGroup())
+        return;
+
+    auto now = juce::Time::getMillisecondCounterHiRes();
+
+    bool continuesLastEdit = ! canRedo()
+                             && lastCoalescedName == name
+                             && getUndoDescription() == name
+                             && now - lastCoalescedEditMs < coalesceWindowMs;
+
+    if (! continuesLastEdit)
+        startTransaction (name);
+
+    lastCoalescedName = name;
+    lastCoalescedEditMs = now;
+}
+
+void UndoHistory::beginTransaction (const juce::String& name)
+{
+    if (! isInTransactionGroup())
+        startTransaction (name);
+}
+
+void UndoHistory::beginTransaction (juce::UndoManager* undoManager, const juce::String& name)
+{
+    if (undoManager == nullptr)
+        return;
+
+    if (auto* history = dynamic_cast<UndoHistory*> (undoManager))
+        history->beginTransaction (name);
+    else
+        undoManager->beginNewTransaction (name);
+}
+
+void UndoHistory::beginTransactionGroup (const juce::String& name)
+{
+    if (groupDepth++ == 0)
+    {
+        startTransaction (name);
+        lastCoalescedName = {};
+    }
+}
+
+void UndoHistory::endTransactionGroup()
+{
+    jassert (groupDepth > 0);
+    groupDepth = juce::jmax (0, groupDepth - 1);
+}
+
+bool UndoHistory::isInTransactionGroup() const
+{
+    return groupDepth > 0;
+}
+
+void UndoHistory::changeListenerCallback ([[maybe_unused]] juce::ChangeBroadcaster* source)
+{
+    applyLimits();
+}
+
+void UndoHistory::startTransaction (const juce::String& name)
+{
+    applyLimits (1);
+    beginNewTransaction (name);
+}
+
+void UndoHistory::applyLimits (int pendingTransactions)
+{
+    if (getNumUndoableTransactions() + pendingTransactions > maxTransactions)
+        setMaxNumberOfStoredUnits (1, maxTransactions);
+    else
+        setMaxNumberOfStoredUnits (maxBytes, juce::jmin (minTransactionsToKeep, maxTransactions));
+}
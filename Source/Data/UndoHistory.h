@@ -0,0 +1,72 @@
+#pragma once
+
+#include "juce_data_structures/juce_data_structures.h"
+#include <JuceHeader.h>
+
+// The application's undo manager. History is bounded both by the number of
+// undoable transactions and by the estimated bytes held by stored actions
+// (juce::UndoManager's "units"; ValueTree and NoteEditBatch actions report
+// roughly their size in bytes), so a long session cannot grow without limit.
+//
+// juce::UndoManager only trims when units exceed the limit while keeping a
+// minimum number of transactions. A maximum count is enforced by switching
+// to a one-unit budget with the count as the minimum whenever the history is
+// about to go over the limit. Starting a transaction checks this, so the
+// perform() that opens it drops the oldest transactions until exactly
+// maxTransactions remain, without waiting for the change message.
+class UndoHistory : public juce::UndoManager,
+                    private juce::ChangeListener
+{
+public:
+    UndoHistory();
+    ~UndoHistory() override;
+
+    void setLimits (int maxTransactions, int maxKilobytes);
+    int getMaxTransactions() const;
+    int getMaxKilobytes() const;
+
+    int getNumUndoableTransactions() const;
+    int getEstimatedBytes() const;
+
+    // Starts a transaction unless the previous one has the same name, was
+    // edited less than coalesceWindowMs ago and nothing has been undone since.
+    // Repeated property changes on the same tree then merge into one action
+    // (ValueTree's own coalescing), compacting e.g. held-down nudges
+    void beginCoalescedTransaction (const juce::String& name);
+
+    // Starts a transaction, unless a transaction group is open
+    void beginTransaction (const juce::String& name);
+
+    // For code that only holds a juce::UndoManager; behaves like the member
+    // when it is an UndoHistory and like beginNewTransaction otherwise
+    static void beginTransaction (juce::UndoManager* undoManager, const juce::String& name);
+
+    // While a group is open every edit lands in the group's one transaction,
+    // e.g. all the steps of a replayed macro undo together. Groups nest
+    void beginTransactionGroup (const juce::String& name);
+    void endTransactionGroup();
+    bool isInTransactionGroup() const;
+
+    static constexpr int defaultMaxTransactions = 500;
+    static constexpr int defaultMaxKilobytes = 8192;
+    static constexpr int minTransactionsToKeep = 10;
+    static constexpr double coalesceWindowMs = 1000.0;
+
+private:
+    void changeListenerCallback (juce::ChangeBroadcaster* source) override;
+    // Counts pendingTransactions not yet in the history against the limit
+    void applyLimits (int pendingTransactions = 0);
+
+    // beginNewTransaction, with the limits set so the new one trims the history
+    void startTransaction (const juce::String& name);
+
+    int maxTransactions = defaultMaxTransactions;
+    int maxBytes = defaultMaxKilobytes * 1024;
+
+    int groupDepth = 0;
+
+    juce::String lastCoalescedName;
+    double lastCoalescedEditMs = 0.0;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UndoHistory)
+};